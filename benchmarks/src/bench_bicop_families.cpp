@@ -30,6 +30,11 @@ register_eval_benchmarks(BicopFamily family)
                                    for (auto _ : st)
                                      benchmark::DoNotOptimize(bc.pdf(*data));
                                  });
+    benchmark::RegisterBenchmark(("bicop/logpdf/" + suffix).c_str(),
+                                 [bc, data](benchmark::State& st) {
+                                   for (auto _ : st)
+                                     benchmark::DoNotOptimize(bc.logpdf(*data));
+                                 });
     benchmark::RegisterBenchmark(("bicop/cdf/" + suffix).c_str(),
                                  [bc, data](benchmark::State& st) {
                                    for (auto _ : st)
@@ -45,16 +50,19 @@ register_eval_benchmarks(BicopFamily family)
                                    for (auto _ : st)
                                      benchmark::DoNotOptimize(bc.hfunc2(*data));
                                  });
-    benchmark::RegisterBenchmark(("bicop/hinv1/" + suffix).c_str(),
-                                 [bc, data](benchmark::State& st) {
-                                   for (auto _ : st)
-                                     benchmark::DoNotOptimize(bc.hinv1(*data));
-                                 });
-    benchmark::RegisterBenchmark(("bicop/hinv2/" + suffix).c_str(),
-                                 [bc, data](benchmark::State& st) {
-                                   for (auto _ : st)
-                                     benchmark::DoNotOptimize(bc.hinv2(*data));
-                                 });
+    // items per second is the h-inverse throughput of the family
+    benchmark::RegisterBenchmark(
+      ("bicop/hinv1/" + suffix).c_str(), [bc, data](benchmark::State& st) {
+        for (auto _ : st)
+          benchmark::DoNotOptimize(bc.hinv1(*data));
+        st.SetItemsProcessed(st.iterations() * data->rows());
+      });
+    benchmark::RegisterBenchmark(
+      ("bicop/hinv2/" + suffix).c_str(), [bc, data](benchmark::State& st) {
+        for (auto _ : st)
+          benchmark::DoNotOptimize(bc.hinv2(*data));
+        st.SetItemsProcessed(st.iterations() * data->rows());
+      });
     if (n == 1000) {
       benchmark::RegisterBenchmark(
         ("bicop/loglik/" + suffix).c_str(), [bc, data](benchmark::State& st) {
@@ -126,6 +134,63 @@ register_discrete_benchmarks(BicopFamily family)
     });
 }
 
+// The same evaluations with one parameter set per row, as in covariate-
+// dependent models; compare with `bicop/pdf/<family>/n=1000`.
+void
+register_per_row_benchmarks(BicopFamily family)
+{
+  const std::string fam_name = get_family_name(family);
+  const size_t n = 1000;
+  auto data =
+    std::make_shared<const Eigen::MatrixXd>(bench::sim_data(family, 0, n));
+  const Bicop bc(family, 0, bench::family_parameters(family));
+  auto parameters = std::make_shared<const Eigen::MatrixXd>(
+    bc.get_parameters().transpose().replicate(n, 1));
+
+  benchmark::RegisterBenchmark(
+    ("bicop/pdf_per_row/" + fam_name + "/n=1000").c_str(),
+    [bc, data, parameters](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(bc.pdf(*data, *parameters));
+    });
+  benchmark::RegisterBenchmark(
+    ("bicop/hfunc1_per_row/" + fam_name + "/n=1000").c_str(),
+    [bc, data, parameters](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(bc.hfunc1(*data, *parameters));
+    });
+  benchmark::RegisterBenchmark(
+    ("bicop/hinv1_per_row/" + fam_name + "/n=1000").c_str(),
+    [bc, data, parameters](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(bc.hinv1(*data, *parameters));
+      st.SetItemsProcessed(st.iterations() * data->rows());
+    });
+}
+
+// The tabulated inverse h-functions; compare with `bicop/hinv1/<family>`. The
+// table is built in the first iteration and reused by the others.
+void
+register_hinv_method_benchmarks(BicopFamily family)
+{
+  const std::string fam_name = get_family_name(family);
+  const size_t n = 10000;
+  auto data =
+    std::make_shared<const Eigen::MatrixXd>(bench::sim_data(family, 0, n));
+  for (auto method : { HinvMethod::table, HinvMethod::table_newton }) {
+    Bicop bc(family, 0, bench::family_parameters(family));
+    bc.set_hinv_method(method);
+    const std::string name = method == HinvMethod::table ? "table" : "newton";
+    benchmark::RegisterBenchmark(
+      ("bicop/hinv1_" + name + "/" + fam_name + "/n=10000").c_str(),
+      [bc, data](benchmark::State& st) {
+        for (auto _ : st)
+          benchmark::DoNotOptimize(bc.hinv1(*data));
+        st.SetItemsProcessed(st.iterations() * data->rows());
+      });
+  }
+}
+
 void
 register_smoke_benchmark()
 {
@@ -154,10 +219,19 @@ struct Registrar
     for (auto family : families) {
       register_eval_benchmarks(family);
       register_fit_benchmarks(family);
+      register_per_row_benchmarks(family);
     }
     for (auto family : { BicopFamily::gaussian, BicopFamily::clayton }) {
       register_discrete_benchmarks(family);
     }
+    for (auto family : { BicopFamily::frank,
+                         BicopFamily::bb1,
+                         BicopFamily::bb6,
+                         BicopFamily::bb7,
+                         BicopFamily::bb8,
+                         BicopFamily::tawn }) {
+      register_hinv_method_benchmarks(family);
+    }
   }
 };
 const Registrar registrar;
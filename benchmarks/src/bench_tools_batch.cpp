@@ -0,0 +1,72 @@
+// Copyright © 2016-2026 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#include "helpers.hpp"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vinecopulib/misc/tools_batch.hpp>
+
+using namespace vinecopulib;
+
+namespace {
+
+// Evaluates a vine's density batch by batch, each batch with its own scratch
+// matrices, as `Vinecop::pdf_full()` does internally. `uniform` is the
+// row-count-only policy the evaluation methods used before; `cost_aware` sizes
+// the batches as `Vinecop::get_batch_cost()` does for Gaussian pair copulas.
+void
+register_pdf(size_t d, size_t n, size_t threads)
+{
+  auto vc = std::make_shared<const Vinecop>(bench::make_gaussian_vine(d));
+  auto u =
+    std::make_shared<const Eigen::MatrixXd>(vc->simulate(n, false, 1, { 5 }));
+  tools_batch::BatchCost cost;
+  cost.row_cost = 3.0 * static_cast<double>(d * (d - 1) / 2);
+  cost.row_bytes = sizeof(double) * (2 * d + 8);
+
+  const std::string suffix = "/d=" + std::to_string(d) +
+                             "/n=" + std::to_string(n) +
+                             "/threads=" + std::to_string(threads);
+  for (bool cost_aware : { false, true }) {
+    const std::string policy = cost_aware ? "cost_aware" : "uniform";
+    benchmark::RegisterBenchmark(
+      ("batch/pdf/" + policy + suffix).c_str(),
+      [vc, u, n, threads, cost, cost_aware](benchmark::State& st) {
+        auto batches = cost_aware
+                         ? tools_batch::create_batches(n, threads, cost)
+                         : tools_batch::create_batches(n, threads);
+        tools_thread::Executor executor(threads);
+        Eigen::VectorXd pdf(n);
+        for (auto _ : st) {
+          executor.map(
+            [&](const tools_batch::Batch& b) {
+              pdf.segment(b.begin, b.size) =
+                vc->pdf(u->middleRows(b.begin, b.size));
+            },
+            batches);
+          benchmark::DoNotOptimize(pdf.data());
+        }
+        st.counters["batches"] = static_cast<double>(batches.size());
+      });
+  }
+}
+
+struct Registrar
+{
+  Registrar()
+  {
+    for (size_t d : { size_t(5), size_t(20), size_t(50) }) {
+      for (size_t n : { size_t(1000), size_t(10000) }) {
+        for (size_t threads : { size_t(1), size_t(4) }) {
+          register_pdf(d, n, threads);
+        }
+      }
+    }
+  }
+};
+const Registrar registrar;
+
+} // namespace
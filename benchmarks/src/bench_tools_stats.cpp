@@ -8,6 +8,8 @@
 #include <benchmark/benchmark.h>
 #include <memory>
 #include <vinecopulib/misc/tools_stats.hpp>
+#include <vinecopulib/misc/tools_stats_dominance.hpp>
+#include <wdm/eigen.hpp>
 
 using namespace vinecopulib;
 
@@ -41,6 +43,71 @@ register_pseudo_obs()
     });
 }
 
+void
+register_distributions()
+{
+  auto u = std::make_shared<const Eigen::MatrixXd>(
+    tools_stats::simulate_uniform(10000, 2, false, { 5 }));
+  auto z = std::make_shared<const Eigen::MatrixXd>(tools_stats::qnorm(*u));
+  benchmark::RegisterBenchmark(
+    "stats/qnorm/n=10000", [u](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(tools_stats::qnorm(*u));
+    });
+  benchmark::RegisterBenchmark(
+    "stats/pnorm/n=10000", [z](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(tools_stats::pnorm(*z));
+    });
+  benchmark::RegisterBenchmark(
+    "stats/dnorm/n=10000", [z](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(tools_stats::dnorm(*z));
+    });
+  benchmark::RegisterBenchmark(
+    "stats/qt/nu=4.5/n=10000", [u](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(tools_stats::qt(*u, 4.5));
+    });
+  benchmark::RegisterBenchmark(
+    "stats/pt/nu=4.5/n=10000", [z](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(tools_stats::pt(*z, 4.5));
+    });
+  benchmark::RegisterBenchmark(
+    "stats/dt/nu=4.5/n=10000", [z](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(tools_stats::dt(*z, 4.5));
+    });
+}
+
+// empirical distribution function of N = 10^5 points at 10^4 query points,
+// as in `Vinecop::cdf`
+void
+register_dominance()
+{
+  for (size_t d : { size_t(2), size_t(3), size_t(5) }) {
+    auto x = std::make_shared<const Eigen::MatrixXd>(
+      tools_stats::simulate_uniform(100000, d, true, { 5 }));
+    auto q = std::make_shared<const Eigen::MatrixXd>(
+      tools_stats::simulate_uniform(10000, d, false, { 6 }));
+    auto index = std::make_shared<const tools_stats::DominanceIndex>(*x);
+    const std::string suffix = "d=" + std::to_string(d) + "/N=100000";
+    benchmark::RegisterBenchmark(
+      ("stats/dominance_build/" + suffix).c_str(),
+      [x](benchmark::State& st) {
+        for (auto _ : st)
+          benchmark::DoNotOptimize(tools_stats::DominanceIndex(*x));
+      });
+    benchmark::RegisterBenchmark(
+      ("stats/dominance_count/" + suffix + "/n=10000").c_str(),
+      [index, q](benchmark::State& st) {
+        for (auto _ : st)
+          benchmark::DoNotOptimize(index->count(*q));
+      });
+  }
+}
+
 void
 register_genz()
 {
@@ -80,6 +147,25 @@ register_qrng()
           benchmark::DoNotOptimize(tools_stats::sobol(10000, d, { 5 }));
       });
   }
+  // extending a sample block by block; items per second is the number of
+  // points per second
+  for (size_t d : { size_t(5), size_t(50) }) {
+    const std::string suffix = "block=1024/d=" + std::to_string(d);
+    benchmark::RegisterBenchmark(
+      ("stats/ghalton_sequence/" + suffix).c_str(), [d](benchmark::State& st) {
+        tools_stats::GhaltonSequence sequence(d, { 5 });
+        for (auto _ : st)
+          benchmark::DoNotOptimize(sequence.next(1024));
+        st.SetItemsProcessed(st.iterations() * 1024);
+      });
+    benchmark::RegisterBenchmark(
+      ("stats/sobol_sequence/" + suffix).c_str(), [d](benchmark::State& st) {
+        tools_stats::SobolSequence sequence(d, { 5 });
+        for (auto _ : st)
+          benchmark::DoNotOptimize(sequence.next(1024));
+        st.SetItemsProcessed(st.iterations() * 1024);
+      });
+  }
   benchmark::RegisterBenchmark(
     "stats/simulate_uniform/n=10000/d=5", [](benchmark::State& st) {
       for (auto _ : st)
@@ -100,14 +186,47 @@ register_mcor()
     });
 }
 
+// all pairs of columns at once vs. one pair at a time, as the first tree of
+// a structure selection used to
+void
+register_dependence_matrix()
+{
+  auto x = std::make_shared<const Eigen::MatrixXd>(
+    tools_stats::simulate_uniform(5000, 50, false, { 5 }));
+  for (std::string method : { "tau", "rho" }) {
+    benchmark::RegisterBenchmark(
+      ("stats/dependence_matrix/" + method + "/n=5000/d=50").c_str(),
+      [x, method](benchmark::State& st) {
+        for (auto _ : st)
+          benchmark::DoNotOptimize(tools_stats::dependence_matrix(*x, method));
+      });
+    benchmark::RegisterBenchmark(
+      ("stats/dependence_pairs/" + method + "/n=5000/d=50").c_str(),
+      [x, method](benchmark::State& st) {
+        for (auto _ : st) {
+          for (Eigen::Index i = 0; i < x->cols(); ++i) {
+            for (Eigen::Index j = 0; j < i; ++j) {
+              Eigen::MatrixXd pair(x->rows(), 2);
+              pair << x->col(i), x->col(j);
+              benchmark::DoNotOptimize(wdm::wdm(pair, method)(0, 1));
+            }
+          }
+        }
+      });
+  }
+}
+
 struct Registrar
 {
   Registrar()
   {
     register_pseudo_obs();
+    register_distributions();
+    register_dominance();
     register_genz();
     register_qrng();
     register_mcor();
+    register_dependence_matrix();
   }
 };
 const Registrar registrar;
@@ -0,0 +1,88 @@
+// Copyright © 2016-2026 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#include "helpers.hpp"
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vinecopulib/misc/tools_thread_stealing.hpp>
+
+using namespace vinecopulib;
+
+namespace {
+
+// Many independent pair-copula selections of uneven cost, as in one tree of
+// `VinecopSelector::select_pair_copulas()`.
+template<class Pool>
+void
+register_select_edges(const std::string& pool_label, size_t threads)
+{
+  const size_t num_edges = 64;
+  const std::vector<BicopFamily> families = { BicopFamily::gaussian,
+                                              BicopFamily::clayton,
+                                              BicopFamily::gumbel,
+                                              BicopFamily::frank };
+  auto data = std::make_shared<std::vector<Eigen::MatrixXd>>();
+  for (size_t e = 0; e < num_edges; ++e) {
+    data->push_back(bench::sim_data(
+      families[e % families.size()], 0, 500, static_cast<int>(e + 1)));
+  }
+  auto pool = std::make_shared<Pool>(threads);
+  FitControlsBicop controls(bicop_families::itau, "itau");
+
+  benchmark::RegisterBenchmark(
+    ("thread/select_edges/" + pool_label + "/edges=64/n=500/threads=" +
+     std::to_string(threads))
+      .c_str(),
+    [data, pool, controls](benchmark::State& st) {
+      std::vector<Bicop> fits(data->size());
+      for (auto _ : st) {
+        pool->map(
+          [&](size_t e) { fits[e].select((*data)[e], controls); },
+          tools_stl::seq_int(0, data->size()));
+        pool->wait();
+        benchmark::DoNotOptimize(fits);
+      }
+    });
+}
+
+// Jobs so small that the cost of handing them to workers dominates.
+template<class Pool>
+void
+register_tiny_jobs(const std::string& pool_label, size_t threads)
+{
+  auto pool = std::make_shared<Pool>(threads);
+  benchmark::RegisterBenchmark(
+    ("thread/tiny_jobs/" + pool_label + "/jobs=10000/threads=" +
+     std::to_string(threads))
+      .c_str(),
+    [pool](benchmark::State& st) {
+      std::atomic<size_t> count{ 0 };
+      for (auto _ : st) {
+        pool->map([&](size_t) { count++; }, tools_stl::seq_int(0, 10000));
+        pool->wait();
+      }
+      benchmark::DoNotOptimize(count.load());
+    });
+}
+
+struct Registrar
+{
+  Registrar()
+  {
+    for (size_t threads : { size_t(4), size_t(16) }) {
+      register_select_edges<tools_thread::ThreadPool>("ThreadPool", threads);
+      register_select_edges<tools_thread::WorkStealingPool>("WorkStealingPool",
+                                                            threads);
+      register_tiny_jobs<tools_thread::ThreadPool>("ThreadPool", threads);
+      register_tiny_jobs<tools_thread::WorkStealingPool>("WorkStealingPool",
+                                                         threads);
+    }
+  }
+};
+const Registrar registrar;
+
+} // namespace
@@ -29,6 +29,17 @@ register_eval(size_t d)
           benchmark::DoNotOptimize(vc->pdf(*u, threads));
       });
   }
+  // log-density: summed in log space vs. the logarithm of the product
+  benchmark::RegisterBenchmark(
+    ("vinecop/log_of_pdf/" + suffix).c_str(), [vc, u](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(vc->pdf(*u).array().log().eval());
+    });
+  benchmark::RegisterBenchmark(("vinecop/logpdf/" + suffix).c_str(),
+                               [vc, u](benchmark::State& st) {
+                                 for (auto _ : st)
+                                   benchmark::DoNotOptimize(vc->logpdf(*u));
+                               });
   benchmark::RegisterBenchmark(("vinecop/rosenblatt/" + suffix).c_str(),
                                [vc, u](benchmark::State& st) {
                                  for (auto _ : st)
@@ -47,6 +58,83 @@ register_eval(size_t d)
     });
 }
 
+// The same evaluations on a compiled plan, for comparison with `register_eval`.
+void
+register_compiled(size_t d)
+{
+  const size_t n = 1000;
+  auto vc = bench::make_gaussian_vine(d);
+  auto plan = std::make_shared<const CompiledVinecop>(vc.compile());
+  auto u =
+    std::make_shared<const Eigen::MatrixXd>(vc.simulate(n, false, 1, { 5 }));
+  const std::string suffix = "d=" + std::to_string(d) + "/n=1000";
+
+  benchmark::RegisterBenchmark(("vinecop/compiled/pdf/" + suffix).c_str(),
+                               [plan, u](benchmark::State& st) {
+                                 for (auto _ : st)
+                                   benchmark::DoNotOptimize(plan->pdf(*u));
+                               });
+  benchmark::RegisterBenchmark(
+    ("vinecop/compiled/rosenblatt/" + suffix).c_str(),
+    [plan, u](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(plan->rosenblatt(*u));
+    });
+  benchmark::RegisterBenchmark(
+    ("vinecop/compiled/inverse_rosenblatt/" + suffix).c_str(),
+    [plan, u](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(plan->inverse_rosenblatt(*u));
+    });
+  // many small calls, where the per-call overhead of the uncompiled path shows
+  auto u_small = std::make_shared<const Eigen::MatrixXd>(u->topRows(10));
+  auto vc_ptr = std::make_shared<const Vinecop>(vc);
+  benchmark::RegisterBenchmark(
+    ("vinecop/pdf/d=" + std::to_string(d) + "/n=10").c_str(),
+    [vc_ptr, u_small](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(vc_ptr->pdf(*u_small));
+    });
+  benchmark::RegisterBenchmark(
+    ("vinecop/compiled/pdf/d=" + std::to_string(d) + "/n=10").c_str(),
+    [plan, u_small](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(plan->pdf(*u_small));
+    });
+  // same, writing into a reused buffer and workspace
+  benchmark::RegisterBenchmark(
+    ("vinecop/compiled/pdf_workspace/d=" + std::to_string(d) + "/n=10").c_str(),
+    [plan, u_small](benchmark::State& st) {
+      VinecopWorkspace ws;
+      Eigen::VectorXd out(u_small->rows());
+      for (auto _ : st) {
+        plan->pdf(*u_small, out, ws);
+        benchmark::DoNotOptimize(out.data());
+      }
+    });
+}
+
+// Few rows, many variables: too few row batches to keep the threads busy, so
+// `pdf_full()` also evaluates the edges within each tree concurrently.
+void
+register_eval_wide(size_t d, size_t n)
+{
+  auto vc = std::make_shared<const Vinecop>(bench::make_gaussian_vine(d));
+  auto u =
+    std::make_shared<const Eigen::MatrixXd>(vc->simulate(n, false, 1, { 5 }));
+  const std::string suffix =
+    "d=" + std::to_string(d) + "/n=" + std::to_string(n);
+
+  for (size_t threads : { size_t(1), size_t(4) }) {
+    benchmark::RegisterBenchmark(
+      ("vinecop/pdf/" + suffix + "/threads=" + std::to_string(threads)).c_str(),
+      [vc, u, threads](benchmark::State& st) {
+        for (auto _ : st)
+          benchmark::DoNotOptimize(vc->pdf(*u, threads));
+      });
+  }
+}
+
 void
 register_scores(size_t d,
                 BicopFamily family = BicopFamily::gaussian,
@@ -125,6 +213,60 @@ register_cdf()
       for (auto _ : st)
         benchmark::DoNotOptimize(vc->cdf(*u, 10000, 1, { 5 }));
     });
+  // many evaluation points, where counting used to dominate the simulation
+  auto u_large = std::make_shared<const Eigen::MatrixXd>(
+    vc->simulate(10000, false, 1, { 6 }));
+  benchmark::RegisterBenchmark(
+    "vinecop/cdf/d=5/n=10000/N=100000", [vc, u_large](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(vc->cdf(*u_large, 100000, 1, { 5 }));
+    });
+  // repeated queries against a sample simulated once
+  auto estimator = std::make_shared<const VinecopCdfEstimator>(
+    *vc, 10000, 1, 1, std::vector<int>{ 5 });
+  benchmark::RegisterBenchmark(
+    "vinecop/cdf_estimator/d=5/n=100/N=10000",
+    [estimator, u](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(estimator->cdf(*u));
+    });
+  benchmark::RegisterBenchmark(
+    "vinecop/cdf_estimator/build/d=5/N=10000/R=4", [vc](benchmark::State& st) {
+      for (auto _ : st)
+        benchmark::DoNotOptimize(
+          VinecopCdfEstimator(*vc, 10000, 4, 1, { 5 }).get_num_replicates());
+    });
+}
+
+// the truncations of one model, as compared when selecting the truncation
+// level: one by one vs. as an ensemble sharing their trees
+void
+register_ensemble(size_t d)
+{
+  const auto vc = bench::make_gaussian_vine(d);
+  auto models = std::make_shared<std::vector<Vinecop>>();
+  for (size_t trunc_lvl = 1; trunc_lvl < d; ++trunc_lvl) {
+    models->push_back(vc);
+    models->back().truncate(trunc_lvl);
+  }
+  auto ensemble = std::make_shared<const VinecopEnsemble>(*models);
+  auto u =
+    std::make_shared<const Eigen::MatrixXd>(vc.simulate(1000, false, 1, { 5 }));
+  const std::string suffix =
+    "d=" + std::to_string(d) + "/n=1000/m=" + std::to_string(d - 1);
+  benchmark::RegisterBenchmark(
+    ("vinecop/ensemble/separate/" + suffix).c_str(),
+    [models, u](benchmark::State& st) {
+      for (auto _ : st)
+        for (const auto& model : *models)
+          benchmark::DoNotOptimize(model.loglik(*u));
+    });
+  benchmark::RegisterBenchmark(("vinecop/ensemble/shared/" + suffix).c_str(),
+                               [ensemble, u](benchmark::State& st) {
+                                 for (auto _ : st)
+                                   benchmark::DoNotOptimize(
+                                     ensemble->loglik(*u));
+                               });
 }
 
 struct Registrar
@@ -133,17 +275,25 @@ struct Registrar
   {
     for (size_t d : { size_t(5), size_t(10), size_t(25) }) {
       register_eval(d);
+      register_compiled(d);
     }
+    register_eval_wide(100, 200);
     register_scores(5);
     register_scores(5, BicopFamily::clayton, 3.0, "clayton");
     register_scores(5, BicopFamily::frank, 5.0, "frank");
     register_cdf();
+    register_ensemble(10);
 
     register_select(
       5, "itau", FitControlsVinecop(bicop_families::itau, "itau"));
     register_select(
       10, "itau", FitControlsVinecop(bicop_families::itau, "itau"));
     register_select(5, "tll", FitControlsVinecop({ BicopFamily::tll }));
+
+    // every threshold pass refits all trees and reuses the unchanged fits
+    FitControlsVinecop sparse(bicop_families::itau, "itau");
+    sparse.set_select_threshold(true);
+    register_select(200, "itau_select_threshold", sparse);
   }
 };
 const Registrar registrar;
@@ -7,9 +7,11 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include <Eigen/Dense>
 #include <vinecopulib/bicop/family.hpp>
+#include <vinecopulib/misc/tools_interpolation.hpp>
 
 namespace vinecopulib {
 
@@ -48,6 +50,7 @@ is_u2_only(const std::string& deriv);
 class AbstractBicop
 {
   friend class Bicop;
+  friend class CompiledVinecop;
 
 public:
   virtual ~AbstractBicop() = 0;
@@ -69,6 +72,10 @@ protected:
 
   void set_var_types(const std::vector<std::string>& var_types);
 
+  void set_hinv_method(HinvMethod method);
+
+  HinvMethod get_hinv_method() const;
+
   virtual Eigen::MatrixXd get_parameters() const = 0;
 
   virtual Eigen::MatrixXd get_parameters_lower_bounds() const = 0;
@@ -104,6 +111,8 @@ protected:
   // arguments through the difference quotients below
   virtual Eigen::VectorXd pdf(const Eigen::MatrixXd& u);
 
+  Eigen::VectorXd logpdf(const Eigen::MatrixXd& u);
+
   virtual Eigen::VectorXd hfunc1(const Eigen::MatrixXd& u);
 
   virtual Eigen::VectorXd hfunc2(const Eigen::MatrixXd& u);
@@ -121,6 +130,9 @@ protected:
   Eigen::VectorXd pdf(const Eigen::MatrixXd& u,
                       const Eigen::MatrixXd& parameters);
 
+  Eigen::VectorXd logpdf(const Eigen::MatrixXd& u,
+                         const Eigen::MatrixXd& parameters);
+
   Eigen::VectorXd hfunc1(const Eigen::MatrixXd& u,
                          const Eigen::MatrixXd& parameters);
 
@@ -139,12 +151,37 @@ protected:
   virtual Eigen::VectorXd pdf_raw(const Eigen::MatrixXd& u,
                                   const Eigen::MatrixXd& parameters) = 0;
 
+  // log-density; defaults to log(pdf_raw()), families with a closed form
+  // override it to skip the exp/log round trip
+  virtual Eigen::VectorXd logpdf_raw(const Eigen::MatrixXd& u,
+                                     const Eigen::MatrixXd& parameters);
+
   virtual Eigen::VectorXd hfunc1_raw(const Eigen::MatrixXd& u,
                                      const Eigen::MatrixXd& parameters) = 0;
 
   virtual Eigen::VectorXd hfunc2_raw(const Eigen::MatrixXd& u,
                                      const Eigen::MatrixXd& parameters) = 0;
 
+  // Same leaves, writing into `out` (of length `u.rows()`); used by the
+  // workspace overloads of CompiledVinecop. The defaults copy the result of
+  // the leaves above, the families on the hot paths override them so that
+  // evaluation does not touch the heap.
+  virtual void pdf_raw_into(const Eigen::MatrixXd& u,
+                            const Eigen::MatrixXd& parameters,
+                            Eigen::Ref<Eigen::VectorXd> out);
+
+  virtual void logpdf_raw_into(const Eigen::MatrixXd& u,
+                               const Eigen::MatrixXd& parameters,
+                               Eigen::Ref<Eigen::VectorXd> out);
+
+  virtual void hfunc1_raw_into(const Eigen::MatrixXd& u,
+                               const Eigen::MatrixXd& parameters,
+                               Eigen::Ref<Eigen::VectorXd> out);
+
+  virtual void hfunc2_raw_into(const Eigen::MatrixXd& u,
+                               const Eigen::MatrixXd& parameters,
+                               Eigen::Ref<Eigen::VectorXd> out);
+
   virtual Eigen::VectorXd hinv1_raw(const Eigen::MatrixXd& u,
                                     const Eigen::MatrixXd& parameters) = 0;
 
@@ -217,12 +254,44 @@ protected:
   Eigen::VectorXd hinv2_num_raw(const Eigen::MatrixXd& u,
                                 const Eigen::MatrixXd& parameters);
 
+  // the inverses behind the two above; `cond` is the column of `u` holding
+  // the conditioning variable (0 for hinv1, 1 for hinv2)
+  Eigen::VectorXd hinv_solve_raw(const Eigen::MatrixXd& u,
+                                 const Eigen::MatrixXd& parameters,
+                                 Eigen::Index cond);
+
+  // solves `h(u, parameters) = u.col(col)` for `u.col(col)` row by row, where
+  // `h` is an h-function taking `(u, parameters)`; only the rows that have
+  // not converged are evaluated
+  template<typename Func>
+  static Eigen::VectorXd hinv_solve(const Eigen::MatrixXd& u,
+                                    const Eigen::MatrixXd& parameters,
+                                    Eigen::Index col,
+                                    const Func& h);
+
+  bool uses_hinv_table(const Eigen::MatrixXd& parameters) const;
+
+  Eigen::VectorXd hinv_table_raw(const Eigen::MatrixXd& u,
+                                 const Eigen::MatrixXd& parameters,
+                                 Eigen::Index cond);
+
   Eigen::VectorXd pdf_c_d(const Eigen::MatrixXd& u,
                           const Eigen::MatrixXd& parameters);
 
   Eigen::VectorXd pdf_d_d(const Eigen::MatrixXd& u,
                           const Eigen::MatrixXd& parameters);
 
+  // evaluates `f(u, parameters)` on the rows of `u` listed in `rows` and
+  // writes the results to the same entries of `out`; per-row parameters are
+  // gathered along with `u`, a broadcast row is passed through. The discrete
+  // leaves use it to evaluate each branch once on all rows taking it.
+  template<typename Func>
+  static void eval_on_rows(const Eigen::MatrixXd& u,
+                           const Eigen::MatrixXd& parameters,
+                           const std::vector<Eigen::Index>& rows,
+                           Eigen::VectorXd& out,
+                           const Func& f);
+
   double loglik(const Eigen::MatrixXd& u,
                 const Eigen::VectorXd& weights = Eigen::VectorXd());
 
@@ -230,6 +299,17 @@ protected:
   BicopFamily family_;
   double loglik_{ NAN };
   std::vector<std::string> var_types_{ "c", "c" };
+  HinvMethod hinv_method_{ HinvMethod::exact };
+
+  // tables of the continuous inverses (hinv1, hinv2) and the parameters they
+  // were built for; built lazily and swapped in atomically, so concurrent
+  // evaluations may build a table twice but never see a partial one
+  struct HinvTable
+  {
+    Eigen::MatrixXd parameters;
+    tools_interpolation::ConditionalQuantileTable table;
+  };
+  std::shared_ptr<const HinvTable> hinv_tables_[2];
 };
 
 //! A shared pointer to an object of class AbstracBicop.
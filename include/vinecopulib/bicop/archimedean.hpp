@@ -31,6 +31,14 @@ private:
   Eigen::VectorXd hfunc2_raw(const Eigen::MatrixXd& u,
                              const Eigen::MatrixXd& parameters) override;
 
+  void hfunc1_raw_into(const Eigen::MatrixXd& u,
+                       const Eigen::MatrixXd& parameters,
+                       Eigen::Ref<Eigen::VectorXd> out) override;
+
+  void hfunc2_raw_into(const Eigen::MatrixXd& u,
+                       const Eigen::MatrixXd& parameters,
+                       Eigen::Ref<Eigen::VectorXd> out) override;
+
   Eigen::VectorXd hinv1_raw(const Eigen::MatrixXd& u,
                             const Eigen::MatrixXd& parameters) override;
 
@@ -63,6 +71,11 @@ private:
 
   // virtual double generator_derivative2(const double &u) = 0;
 
+  // first h-function at a single point
+  double hfunc1_scalar(const double& u1,
+                       const double& u2,
+                       const Eigen::Ref<const Eigen::VectorXd>& parameters);
+
   Eigen::VectorXd get_start_parameters(const double tau) override;
 };
 }
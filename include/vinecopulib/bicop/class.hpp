@@ -7,6 +7,7 @@
 #pragma once
 
 #include <vinecopulib/bicop/fit_controls.hpp>
+#include <vinecopulib/misc/tools_executor.hpp>
 #include <vinecopulib/misc/tools_serialization.hpp>
 
 namespace vinecopulib {
@@ -46,6 +47,7 @@ using BicopPtr = std::shared_ptr<AbstractBicop>;
 class Bicop
 {
   friend class BicopView;
+  friend class CompiledVinecop;
 
 public:
   // Constructors
@@ -135,9 +137,18 @@ public:
   //! continuous or `"d"` for discrete).
   std::vector<std::string> get_var_types() const;
 
+  //! Sets the method for inverting h-functions that have no closed form.
+  //! @param method see `HinvMethod`.
+  void set_hinv_method(const HinvMethod method);
+
+  //! @return the method for inverting h-functions that have no closed form.
+  HinvMethod get_hinv_method() const;
+
   // Stats methods
   Eigen::VectorXd pdf(const Eigen::MatrixXd& u) const;
 
+  Eigen::VectorXd logpdf(const Eigen::MatrixXd& u) const;
+
   Eigen::VectorXd cdf(const Eigen::MatrixXd& u) const;
 
   Eigen::VectorXd hfunc1(const Eigen::MatrixXd& u) const;
@@ -151,31 +162,35 @@ public:
   // Stats methods with per-row parameters (parametric families only)
   Eigen::VectorXd pdf(const Eigen::MatrixXd& u,
                       const Eigen::MatrixXd& parameters,
-                      const size_t num_threads = 1) const;
+                      const tools_thread::Executor& num_threads = 1) const;
+
+  Eigen::VectorXd logpdf(const Eigen::MatrixXd& u,
+                         const Eigen::MatrixXd& parameters,
+                         const tools_thread::Executor& num_threads = 1) const;
 
   Eigen::VectorXd cdf(const Eigen::MatrixXd& u,
                       const Eigen::MatrixXd& parameters,
-                      const size_t num_threads = 1) const;
+                      const tools_thread::Executor& num_threads = 1) const;
 
   Eigen::VectorXd hfunc1(const Eigen::MatrixXd& u,
                          const Eigen::MatrixXd& parameters,
-                         const size_t num_threads = 1) const;
+                         const tools_thread::Executor& num_threads = 1) const;
 
   Eigen::VectorXd hfunc2(const Eigen::MatrixXd& u,
                          const Eigen::MatrixXd& parameters,
-                         const size_t num_threads = 1) const;
+                         const tools_thread::Executor& num_threads = 1) const;
 
   Eigen::VectorXd hinv1(const Eigen::MatrixXd& u,
                         const Eigen::MatrixXd& parameters,
-                        const size_t num_threads = 1) const;
+                        const tools_thread::Executor& num_threads = 1) const;
 
   Eigen::VectorXd hinv2(const Eigen::MatrixXd& u,
                         const Eigen::MatrixXd& parameters,
-                        const size_t num_threads = 1) const;
+                        const tools_thread::Executor& num_threads = 1) const;
 
   double loglik(const Eigen::MatrixXd& u,
                 const Eigen::MatrixXd& parameters,
-                const size_t num_threads = 1) const;
+                const tools_thread::Executor& num_threads = 1) const;
 
   // Derivatives of the density and h-functions w.r.t. parameters/arguments
   Eigen::VectorXd pdf_deriv(const Eigen::MatrixXd& u,
@@ -203,45 +218,53 @@ public:
                                 const std::string& deriv) const;
 
   // Derivatives with per-row parameters (parametric families only)
-  Eigen::VectorXd pdf_deriv(const Eigen::MatrixXd& u,
-                            const std::string& deriv,
-                            const Eigen::MatrixXd& parameters,
-                            const size_t num_threads = 1) const;
+  Eigen::VectorXd pdf_deriv(
+    const Eigen::MatrixXd& u,
+    const std::string& deriv,
+    const Eigen::MatrixXd& parameters,
+    const tools_thread::Executor& num_threads = 1) const;
 
-  Eigen::VectorXd pdf_deriv2(const Eigen::MatrixXd& u,
-                             const std::string& deriv,
-                             const Eigen::MatrixXd& parameters,
-                             const size_t num_threads = 1) const;
+  Eigen::VectorXd pdf_deriv2(
+    const Eigen::MatrixXd& u,
+    const std::string& deriv,
+    const Eigen::MatrixXd& parameters,
+    const tools_thread::Executor& num_threads = 1) const;
 
-  Eigen::VectorXd hfunc1_deriv(const Eigen::MatrixXd& u,
-                               const std::string& deriv,
-                               const Eigen::MatrixXd& parameters,
-                               const size_t num_threads = 1) const;
+  Eigen::VectorXd hfunc1_deriv(
+    const Eigen::MatrixXd& u,
+    const std::string& deriv,
+    const Eigen::MatrixXd& parameters,
+    const tools_thread::Executor& num_threads = 1) const;
 
-  Eigen::VectorXd hfunc1_deriv2(const Eigen::MatrixXd& u,
-                                const std::string& deriv,
-                                const Eigen::MatrixXd& parameters,
-                                const size_t num_threads = 1) const;
+  Eigen::VectorXd hfunc1_deriv2(
+    const Eigen::MatrixXd& u,
+    const std::string& deriv,
+    const Eigen::MatrixXd& parameters,
+    const tools_thread::Executor& num_threads = 1) const;
 
-  Eigen::VectorXd hfunc2_deriv(const Eigen::MatrixXd& u,
-                               const std::string& deriv,
-                               const Eigen::MatrixXd& parameters,
-                               const size_t num_threads = 1) const;
+  Eigen::VectorXd hfunc2_deriv(
+    const Eigen::MatrixXd& u,
+    const std::string& deriv,
+    const Eigen::MatrixXd& parameters,
+    const tools_thread::Executor& num_threads = 1) const;
 
-  Eigen::VectorXd hfunc2_deriv2(const Eigen::MatrixXd& u,
-                                const std::string& deriv,
-                                const Eigen::MatrixXd& parameters,
-                                const size_t num_threads = 1) const;
+  Eigen::VectorXd hfunc2_deriv2(
+    const Eigen::MatrixXd& u,
+    const std::string& deriv,
+    const Eigen::MatrixXd& parameters,
+    const tools_thread::Executor& num_threads = 1) const;
 
-  Eigen::VectorXd logpdf_deriv(const Eigen::MatrixXd& u,
-                               const std::string& deriv,
-                               const Eigen::MatrixXd& parameters,
-                               const size_t num_threads = 1) const;
+  Eigen::VectorXd logpdf_deriv(
+    const Eigen::MatrixXd& u,
+    const std::string& deriv,
+    const Eigen::MatrixXd& parameters,
+    const tools_thread::Executor& num_threads = 1) const;
 
-  Eigen::VectorXd logpdf_deriv2(const Eigen::MatrixXd& u,
-                                const std::string& deriv,
-                                const Eigen::MatrixXd& parameters,
-                                const size_t num_threads = 1) const;
+  Eigen::VectorXd logpdf_deriv2(
+    const Eigen::MatrixXd& u,
+    const std::string& deriv,
+    const Eigen::MatrixXd& parameters,
+    const tools_thread::Executor& num_threads = 1) const;
 
   // Scores, gradient, and Hessian of the log-likelihood (parametric,
   // continuous families only)
@@ -270,27 +293,29 @@ public:
   // Scores, gradient, and Hessian with per-row parameters
   Eigen::MatrixXd scores(const Eigen::MatrixXd& u,
                          const Eigen::MatrixXd& parameters,
-                         const size_t num_threads = 1) const;
+                         const tools_thread::Executor& num_threads = 1) const;
 
   Eigen::VectorXd gradient(const Eigen::MatrixXd& u,
                            const Eigen::MatrixXd& parameters,
-                           const size_t num_threads = 1) const;
+                           const tools_thread::Executor& num_threads = 1) const;
 
   Eigen::MatrixXd hessian(const Eigen::MatrixXd& u,
                           const Eigen::MatrixXd& parameters,
-                          const size_t num_threads = 1) const;
+                          const tools_thread::Executor& num_threads = 1) const;
 
-  std::vector<Eigen::MatrixXd> hessian_full(const Eigen::MatrixXd& u,
-                                            const Eigen::MatrixXd& parameters,
-                                            const size_t num_threads = 1) const;
+  std::vector<Eigen::MatrixXd> hessian_full(
+    const Eigen::MatrixXd& u,
+    const Eigen::MatrixXd& parameters,
+    const tools_thread::Executor& num_threads = 1) const;
 
-  Eigen::MatrixXd scores_cov(const Eigen::MatrixXd& u,
-                             const Eigen::MatrixXd& parameters,
-                             const size_t num_threads = 1) const;
+  Eigen::MatrixXd scores_cov(
+    const Eigen::MatrixXd& u,
+    const Eigen::MatrixXd& parameters,
+    const tools_thread::Executor& num_threads = 1) const;
 
   ScoresResult scores_full(const Eigen::MatrixXd& u,
                            const Eigen::MatrixXd& parameters,
-                           const size_t num_threads = 1) const;
+                           const tools_thread::Executor& num_threads = 1) const;
 
   Eigen::MatrixXd simulate(
     const size_t& n,
@@ -300,7 +325,7 @@ public:
   Eigen::MatrixXd simulate(const Eigen::MatrixXd& parameters,
                            const bool qrng = false,
                            const std::vector<int>& seeds = std::vector<int>(),
-                           const size_t num_threads = 1) const;
+                           const tools_thread::Executor& num_threads = 1) const;
 
   // Methods modifying the family/rotation/parameters
   void fit(const Eigen::MatrixXd& data,
@@ -309,6 +334,10 @@ public:
   void select(const Eigen::MatrixXd& data,
               FitControlsBicop controls = FitControlsBicop());
 
+  void select(const Eigen::MatrixXd& data,
+              FitControlsBicop controls,
+              const tools_thread::Executor& executor);
+
   // Fit statistics
   double loglik(const Eigen::MatrixXd& u = Eigen::MatrixXd()) const;
 
@@ -376,7 +405,7 @@ private:
   Eigen::VectorXd eval_in_batches(
     const Eigen::MatrixXd& u,
     const Eigen::MatrixXd& parameters_t,
-    const size_t num_threads,
+    const tools_thread::Executor& num_threads,
     const std::function<Eigen::VectorXd(const Eigen::MatrixXd&,
                                         const Eigen::MatrixXd&)>& f) const;
 
@@ -41,6 +41,17 @@ private:
   Eigen::VectorXd pdf_raw(const Eigen::MatrixXd& u,
                           const Eigen::MatrixXd& parameters) override;
 
+  Eigen::VectorXd logpdf_raw(const Eigen::MatrixXd& u,
+                             const Eigen::MatrixXd& parameters) override;
+
+  void pdf_raw_into(const Eigen::MatrixXd& u,
+                    const Eigen::MatrixXd& parameters,
+                    Eigen::Ref<Eigen::VectorXd> out) override;
+
+  void logpdf_raw_into(const Eigen::MatrixXd& u,
+                       const Eigen::MatrixXd& parameters,
+                       Eigen::Ref<Eigen::VectorXd> out) override;
+
   // analytic derivatives (ported from the VineCopula R package)
   Eigen::VectorXd pdf_deriv_raw(const Eigen::MatrixXd& u,
                                 const Eigen::MatrixXd& parameters,
@@ -28,6 +28,9 @@ private:
   Eigen::VectorXd pdf_raw(const Eigen::MatrixXd& u,
                           const Eigen::MatrixXd& parameters) override;
 
+  Eigen::VectorXd logpdf_raw(const Eigen::MatrixXd& u,
+                             const Eigen::MatrixXd& parameters) override;
+
   Eigen::VectorXd cdf(const Eigen::MatrixXd& u,
                       const Eigen::MatrixXd& parameters) override;
 
@@ -37,6 +40,30 @@ private:
   Eigen::VectorXd hinv1_raw(const Eigen::MatrixXd& u,
                             const Eigen::MatrixXd& parameters) override;
 
+  // leaves writing into `out`; a broadcast parameter row is evaluated in
+  // chunks on the stack, per-observation parameters use the leaves above
+  void pdf_raw_into(const Eigen::MatrixXd& u,
+                    const Eigen::MatrixXd& parameters,
+                    Eigen::Ref<Eigen::VectorXd> out) override;
+
+  void logpdf_raw_into(const Eigen::MatrixXd& u,
+                       const Eigen::MatrixXd& parameters,
+                       Eigen::Ref<Eigen::VectorXd> out) override;
+
+  void hfunc1_raw_into(const Eigen::MatrixXd& u,
+                       const Eigen::MatrixXd& parameters,
+                       Eigen::Ref<Eigen::VectorXd> out) override;
+
+  void hfunc2_raw_into(const Eigen::MatrixXd& u,
+                       const Eigen::MatrixXd& parameters,
+                       Eigen::Ref<Eigen::VectorXd> out) override;
+
+  // calls `f(z1, z2, out)` on chunks of the normal scores of `u`
+  template<typename Func>
+  void eval_on_normal_scores(const Eigen::MatrixXd& u,
+                             Eigen::Ref<Eigen::VectorXd> out,
+                             const Func& f);
+
   // analytic derivative leaves (see tools_deriv for the selector encoding)
   Eigen::VectorXd pdf_deriv_raw(const Eigen::MatrixXd& u,
                                 const Eigen::MatrixXd& parameters,
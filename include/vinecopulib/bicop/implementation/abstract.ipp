@@ -5,6 +5,9 @@
 // vinecopulib or https://vinecopulib.github.io/vinecopulib/.
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
 #include <stdexcept>
 
 #include <vinecopulib/bicop/bb1.hpp>
@@ -164,6 +167,22 @@ AbstractBicop::set_var_types(const std::vector<std::string>& var_types)
   }
   var_types_ = var_types;
 }
+
+inline void
+AbstractBicop::set_hinv_method(HinvMethod method)
+{
+  hinv_method_ = method;
+  if (method == HinvMethod::exact) {
+    std::atomic_store(&hinv_tables_[0], std::shared_ptr<const HinvTable>());
+    std::atomic_store(&hinv_tables_[1], std::shared_ptr<const HinvTable>());
+  }
+}
+
+inline HinvMethod
+AbstractBicop::get_hinv_method() const
+{
+  return hinv_method_;
+}
 //! @}
 
 //! evaluates the pdf, but truncates it's value by DBL_MIN and DBL_MAX.
@@ -180,6 +199,15 @@ AbstractBicop::pdf(const Eigen::MatrixXd& u)
   return pdf;
 }
 
+//! evaluates the log-density, truncated to the logarithms of DBL_MIN and
+//! DBL_MAX (consistent with `pdf()`).
+//! @param u Matrix of evaluation points.
+inline Eigen::VectorXd
+AbstractBicop::logpdf(const Eigen::MatrixXd& u)
+{
+  return logpdf(u, get_parameters().transpose());
+}
+
 inline Eigen::VectorXd
 AbstractBicop::hfunc1(const Eigen::MatrixXd& u)
 {
@@ -224,7 +252,7 @@ AbstractBicop::hinv2(const Eigen::MatrixXd& u)
 inline double
 AbstractBicop::loglik(const Eigen::MatrixXd& u, const Eigen::VectorXd& weights)
 {
-  Eigen::MatrixXd log_pdf = this->pdf(u).array().log();
+  Eigen::MatrixXd log_pdf = this->logpdf(u);
   if (weights.size() > 0) {
     log_pdf = log_pdf.cwiseProduct(weights);
   }
@@ -277,37 +305,131 @@ AbstractBicop::pdf(const Eigen::MatrixXd& u, const Eigen::MatrixXd& parameters)
 }
 
 inline Eigen::VectorXd
-AbstractBicop::pdf_c_d(const Eigen::MatrixXd& u,
-                       const Eigen::MatrixXd& parameters)
+AbstractBicop::logpdf(const Eigen::MatrixXd& u,
+                      const Eigen::MatrixXd& parameters)
 {
-  Eigen::VectorXd pdf(u.rows());
-  Eigen::MatrixXd umax = u.leftCols(2);
-  Eigen::MatrixXd umin = u.rightCols(2);
-  Eigen::VectorXd udiff(u.rows());
+  Eigen::VectorXd logpdf;
+  if (var_types_ == std::vector<std::string>{ "c", "c" }) {
+    logpdf = logpdf_raw(u.leftCols(2), parameters);
+    tools_eigen::trim(logpdf, std::log(DBL_MIN), std::log(DBL_MAX));
+  } else {
+    // discrete densities are differences of h-functions or the cdf
+    logpdf = pdf(u, parameters).array().log();
+  }
+  return logpdf;
+}
+
+inline Eigen::VectorXd
+AbstractBicop::logpdf_raw(const Eigen::MatrixXd& u,
+                          const Eigen::MatrixXd& parameters)
+{
+  return pdf_raw(u, parameters).array().log();
+}
+
+inline void
+AbstractBicop::pdf_raw_into(const Eigen::MatrixXd& u,
+                            const Eigen::MatrixXd& parameters,
+                            Eigen::Ref<Eigen::VectorXd> out)
+{
+  out = pdf_raw(u, parameters);
+}
+
+inline void
+AbstractBicop::logpdf_raw_into(const Eigen::MatrixXd& u,
+                               const Eigen::MatrixXd& parameters,
+                               Eigen::Ref<Eigen::VectorXd> out)
+{
+  out = logpdf_raw(u, parameters);
+}
+
+inline void
+AbstractBicop::hfunc1_raw_into(const Eigen::MatrixXd& u,
+                               const Eigen::MatrixXd& parameters,
+                               Eigen::Ref<Eigen::VectorXd> out)
+{
+  out = hfunc1_raw(u, parameters);
+}
+
+inline void
+AbstractBicop::hfunc2_raw_into(const Eigen::MatrixXd& u,
+                               const Eigen::MatrixXd& parameters,
+                               Eigen::Ref<Eigen::VectorXd> out)
+{
+  out = hfunc2_raw(u, parameters);
+}
 
-  if (var_types_[0] != "c") {
-    udiff = (u.col(0) - u.col(2)).cwiseAbs();
+template<typename Func>
+inline void
+AbstractBicop::eval_on_rows(const Eigen::MatrixXd& u,
+                            const Eigen::MatrixXd& parameters,
+                            const std::vector<Eigen::Index>& rows,
+                            Eigen::VectorXd& out,
+                            const Func& f)
+{
+  const auto m = static_cast<Eigen::Index>(rows.size());
+  if (m == 0) {
+    return;
+  }
+  if (m == u.rows()) {
+    out = f(u, parameters);
+    return;
+  }
+  Eigen::MatrixXd u_sub(m, u.cols());
+  for (Eigen::Index k = 0; k < m; ++k) {
+    u_sub.row(k) = u.row(rows[k]);
+  }
+  Eigen::VectorXd res;
+  if (parameters.rows() == u.rows()) {
+    Eigen::MatrixXd par_sub(m, parameters.cols());
+    for (Eigen::Index k = 0; k < m; ++k) {
+      par_sub.row(k) = parameters.row(rows[k]);
+    }
+    res = f(u_sub, par_sub);
   } else {
-    udiff = (u.col(1) - u.col(3)).cwiseAbs();
+    res = f(u_sub, parameters);
+  }
+  for (Eigen::Index k = 0; k < m; ++k) {
+    out(rows[k]) = res(k);
   }
+}
 
-  const bool bc = (parameters.rows() != u.rows());
+inline Eigen::VectorXd
+AbstractBicop::pdf_c_d(const Eigen::MatrixXd& u,
+                       const Eigen::MatrixXd& parameters)
+{
+  // difference quotient of the h-functions where the discrete margin jumps,
+  // density at the midpoint otherwise
+  const bool d1 = (var_types_[0] != "c");
+  Eigen::VectorXd udiff = d1 ? (u.col(0) - u.col(2)).cwiseAbs()
+                             : (u.col(1) - u.col(3)).cwiseAbs();
+  std::vector<Eigen::Index> jump_rows, mid_rows;
   for (Eigen::Index i = 0; i < u.rows(); i++) {
-    const Eigen::MatrixXd par_i =
-      parameters.rows() == 0 ? parameters : parameters.row(bc ? 0 : i);
-    if (udiff(i) > 5e-5) {
-      if (var_types_[0] != "c") {
-        pdf(i) =
-          (hfunc2_raw(umax.row(i), par_i) - hfunc2_raw(umin.row(i), par_i))(0);
-      } else {
-        pdf(i) =
-          (hfunc1_raw(umax.row(i), par_i) - hfunc1_raw(umin.row(i), par_i))(0);
-      }
-      pdf(i) /= udiff(i);
-    } else {
-      pdf(i) = pdf_raw((umax.row(i) + umin.row(i)) / 2, par_i)(0);
-    }
+    (udiff(i) > 5e-5 ? jump_rows : mid_rows).push_back(i);
   }
+
+  Eigen::VectorXd pdf(u.rows());
+  eval_on_rows(
+    u,
+    parameters,
+    jump_rows,
+    pdf,
+    [&](const Eigen::MatrixXd& v,
+        const Eigen::MatrixXd& par) -> Eigen::VectorXd {
+      if (d1) {
+        return (hfunc2_raw(v.leftCols(2), par) -
+                hfunc2_raw(v.rightCols(2), par))
+          .cwiseQuotient((v.col(0) - v.col(2)).cwiseAbs());
+      }
+      return (hfunc1_raw(v.leftCols(2), par) - hfunc1_raw(v.rightCols(2), par))
+        .cwiseQuotient((v.col(1) - v.col(3)).cwiseAbs());
+    });
+  eval_on_rows(u,
+               parameters,
+               mid_rows,
+               pdf,
+               [&](const Eigen::MatrixXd& v, const Eigen::MatrixXd& par) {
+                 return pdf_raw((v.leftCols(2) + v.rightCols(2)) / 2, par);
+               });
   return pdf.cwiseAbs();
 }
 
@@ -315,42 +437,77 @@ inline Eigen::VectorXd
 AbstractBicop::pdf_d_d(const Eigen::MatrixXd& u,
                        const Eigen::MatrixXd& parameters)
 {
-  Eigen::VectorXd pdf(u.rows());
-  Eigen::MatrixXd umax = u.leftCols(2);
-  Eigen::MatrixXd umin = u.rightCols(2);
-  Eigen::MatrixXd udiff = (umax - umin).cwiseAbs();
+  Eigen::MatrixXd udiff = (u.leftCols(2) - u.rightCols(2)).cwiseAbs();
 
-  const bool bc = (parameters.rows() != u.rows());
+  // the difference quotient can be instable, use derivative if denominator
+  // too small
+  std::vector<Eigen::Index> mid_rows, h1_rows, h2_rows, cdf_rows;
   for (Eigen::Index i = 0; i < u.rows(); i++) {
-    const Eigen::MatrixXd par_i =
-      parameters.rows() == 0 ? parameters : parameters.row(bc ? 0 : i);
-    // the difference quotient can be instable, use derivative if denominator
-    // too small
     if (udiff.row(i).maxCoeff() < 5e-5) {
-      pdf(i) = pdf_raw((umax.row(i) + umin.row(i)) / 2, par_i)(0);
+      mid_rows.push_back(i);
     } else if (udiff(i, 0) < 5e-5) {
-      // both h-functions must be evaluated at the same collapsed argument
-      const double mid = (umax(i, 0) + umin(i, 0)) / 2;
-      umax(i, 0) = mid;
-      umin(i, 0) = mid;
-      pdf(i) = (hfunc1_raw(umax.row(i), par_i)(0) -
-                hfunc1_raw(umin.row(i), par_i)(0)) /
-               udiff(i, 1);
+      h1_rows.push_back(i);
     } else if (udiff(i, 1) < 5e-5) {
-      const double mid = (umax(i, 1) + umin(i, 1)) / 2;
-      umax(i, 1) = mid;
-      umin(i, 1) = mid;
-      pdf(i) = (hfunc2_raw(umax.row(i), par_i)(0) -
-                hfunc2_raw(umin.row(i), par_i)(0)) /
-               udiff(i, 0);
+      h2_rows.push_back(i);
     } else {
-      pdf(i) = cdf(umax.row(i), par_i)(0) + cdf(umin.row(i), par_i)(0);
-      std::swap(umax(i, 0), umin(i, 0));
-      pdf(i) -= cdf(umax.row(i), par_i)(0) + cdf(umin.row(i), par_i)(0);
-      pdf(i) /= udiff(i, 0) * udiff(i, 1);
+      cdf_rows.push_back(i);
     }
   }
 
+  Eigen::VectorXd pdf(u.rows());
+  eval_on_rows(u,
+               parameters,
+               mid_rows,
+               pdf,
+               [&](const Eigen::MatrixXd& v, const Eigen::MatrixXd& par) {
+                 return pdf_raw((v.leftCols(2) + v.rightCols(2)) / 2, par);
+               });
+  eval_on_rows(
+    u,
+    parameters,
+    h1_rows,
+    pdf,
+    [&](const Eigen::MatrixXd& v,
+        const Eigen::MatrixXd& par) -> Eigen::VectorXd {
+      // both h-functions must be evaluated at the same collapsed argument
+      Eigen::MatrixXd vmax = v.leftCols(2);
+      Eigen::MatrixXd vmin = v.rightCols(2);
+      vmax.col(0) = (v.col(0) + v.col(2)) / 2;
+      vmin.col(0) = vmax.col(0);
+      return (hfunc1_raw(vmax, par) - hfunc1_raw(vmin, par))
+        .cwiseQuotient((v.col(1) - v.col(3)).cwiseAbs());
+    });
+  eval_on_rows(
+    u,
+    parameters,
+    h2_rows,
+    pdf,
+    [&](const Eigen::MatrixXd& v,
+        const Eigen::MatrixXd& par) -> Eigen::VectorXd {
+      Eigen::MatrixXd vmax = v.leftCols(2);
+      Eigen::MatrixXd vmin = v.rightCols(2);
+      vmax.col(1) = (v.col(1) + v.col(3)) / 2;
+      vmin.col(1) = vmax.col(1);
+      return (hfunc2_raw(vmax, par) - hfunc2_raw(vmin, par))
+        .cwiseQuotient((v.col(0) - v.col(2)).cwiseAbs());
+    });
+  eval_on_rows(
+    u,
+    parameters,
+    cdf_rows,
+    pdf,
+    [&](const Eigen::MatrixXd& v,
+        const Eigen::MatrixXd& par) -> Eigen::VectorXd {
+      Eigen::MatrixXd vmax = v.leftCols(2);
+      Eigen::MatrixXd vmin = v.rightCols(2);
+      Eigen::VectorXd p = cdf(vmax, par) + cdf(vmin, par);
+      vmax.col(0).swap(vmin.col(0));
+      p -= cdf(vmax, par) + cdf(vmin, par);
+      return p.cwiseQuotient((v.col(0) - v.col(2))
+                               .cwiseAbs()
+                               .cwiseProduct((v.col(1) - v.col(3)).cwiseAbs()));
+    });
+
   return pdf.cwiseAbs();
 }
 
@@ -361,22 +518,32 @@ AbstractBicop::hfunc1(const Eigen::MatrixXd& u,
   if (var_types_[0] == "d") {
     auto uu = u;
     uu.col(3) = uu.col(1);
-    auto u1diff = (uu.col(0) - uu.col(2)).cwiseAbs();
-    Eigen::VectorXd h(u.rows());
-
-    const bool bc = (parameters.rows() != u.rows());
+    Eigen::VectorXd u1diff = (uu.col(0) - uu.col(2)).cwiseAbs();
+    std::vector<Eigen::Index> jump_rows, mid_rows;
     for (Eigen::Index i = 0; i < u.rows(); i++) {
-      const Eigen::MatrixXd par_i =
-        parameters.rows() == 0 ? parameters : parameters.row(bc ? 0 : i);
-      if (std::abs(u1diff(i)) > 5e-5) {
-        h(i) = cdf(uu.row(i).leftCols(2), par_i)(0) -
-               cdf(uu.row(i).rightCols(2), par_i)(0);
-        h(i) /= u1diff(i);
-      } else {
-        uu(i, 0) = (uu(i, 0) + uu(i, 2)) / 2;
-        h(i) = hfunc1_raw(uu.row(i).leftCols(2), par_i)(0);
-      }
+      (u1diff(i) > 5e-5 ? jump_rows : mid_rows).push_back(i);
     }
+
+    Eigen::VectorXd h(u.rows());
+    eval_on_rows(
+      uu,
+      parameters,
+      jump_rows,
+      h,
+      [&](const Eigen::MatrixXd& v,
+          const Eigen::MatrixXd& par) -> Eigen::VectorXd {
+        return (cdf(v.leftCols(2), par) - cdf(v.rightCols(2), par))
+          .cwiseQuotient((v.col(0) - v.col(2)).cwiseAbs());
+      });
+    eval_on_rows(uu,
+                 parameters,
+                 mid_rows,
+                 h,
+                 [&](const Eigen::MatrixXd& v, const Eigen::MatrixXd& par) {
+                   Eigen::MatrixXd vmid = v.leftCols(2);
+                   vmid.col(0) = (v.col(0) + v.col(2)) / 2;
+                   return hfunc1_raw(vmid, par);
+                 });
     return h.cwiseAbs();
   } else {
     return hfunc1_raw(u.leftCols(2), parameters);
@@ -390,22 +557,32 @@ AbstractBicop::hfunc2(const Eigen::MatrixXd& u,
   if (var_types_[1] == "d") {
     auto uu = u;
     uu.col(2) = uu.col(0);
-    auto u2diff = (uu.col(1) - uu.col(3)).cwiseAbs();
-    Eigen::VectorXd h(u.rows());
-
-    const bool bc = (parameters.rows() != u.rows());
+    Eigen::VectorXd u2diff = (uu.col(1) - uu.col(3)).cwiseAbs();
+    std::vector<Eigen::Index> jump_rows, mid_rows;
     for (Eigen::Index i = 0; i < u.rows(); i++) {
-      const Eigen::MatrixXd par_i =
-        parameters.rows() == 0 ? parameters : parameters.row(bc ? 0 : i);
-      if (u2diff(i) > 5e-5) {
-        h(i) = cdf(uu.row(i).leftCols(2), par_i)(0) -
-               cdf(uu.row(i).rightCols(2), par_i)(0);
-        h(i) /= u2diff(i);
-      } else {
-        uu(i, 1) = (uu(i, 1) + uu(i, 3)) / 2;
-        h(i) = hfunc2_raw(uu.row(i).leftCols(2), par_i)(0);
-      }
+      (u2diff(i) > 5e-5 ? jump_rows : mid_rows).push_back(i);
     }
+
+    Eigen::VectorXd h(u.rows());
+    eval_on_rows(
+      uu,
+      parameters,
+      jump_rows,
+      h,
+      [&](const Eigen::MatrixXd& v,
+          const Eigen::MatrixXd& par) -> Eigen::VectorXd {
+        return (cdf(v.leftCols(2), par) - cdf(v.rightCols(2), par))
+          .cwiseQuotient((v.col(1) - v.col(3)).cwiseAbs());
+      });
+    eval_on_rows(uu,
+                 parameters,
+                 mid_rows,
+                 h,
+                 [&](const Eigen::MatrixXd& v, const Eigen::MatrixXd& par) {
+                   Eigen::MatrixXd vmid = v.leftCols(2);
+                   vmid.col(1) = (v.col(1) + v.col(3)) / 2;
+                   return hfunc2_raw(vmid, par);
+                 });
     return h.cwiseAbs();
   } else {
     return hfunc2_raw(u.leftCols(2), parameters);
@@ -438,52 +615,218 @@ inline Eigen::VectorXd
 AbstractBicop::hinv1_num(const Eigen::MatrixXd& u,
                          const Eigen::MatrixXd& parameters)
 {
-  Eigen::MatrixXd u_new = u;
-  auto h1 = [&](const Eigen::VectorXd& v) {
-    u_new.col(1) = v;
-    return hfunc1(u_new, parameters);
+  auto h = [this](const Eigen::MatrixXd& v, const Eigen::MatrixXd& par) {
+    return hfunc1(v, par);
   };
-
-  return tools_eigen::invert_f(u.col(1), h1);
+  return hinv_solve(u, parameters, 1, h);
 }
 
 inline Eigen::VectorXd
 AbstractBicop::hinv2_num(const Eigen::MatrixXd& u,
                          const Eigen::MatrixXd& parameters)
 {
-  Eigen::MatrixXd u_new = u;
-  auto h1 = [&](const Eigen::VectorXd& x) {
-    u_new.col(0) = x;
-    return hfunc2(u_new, parameters);
+  auto h = [this](const Eigen::MatrixXd& v, const Eigen::MatrixXd& par) {
+    return hfunc2(v, par);
   };
-
-  return tools_eigen::invert_f(u.col(0), h1);
+  return hinv_solve(u, parameters, 0, h);
 }
 
 inline Eigen::VectorXd
 AbstractBicop::hinv1_num_raw(const Eigen::MatrixXd& u,
                              const Eigen::MatrixXd& parameters)
 {
-  Eigen::MatrixXd u_new = u;
-  auto h1 = [&](const Eigen::VectorXd& v) {
-    u_new.col(1) = v;
-    return hfunc1_raw(u_new.leftCols(2), parameters);
-  };
-
-  return tools_eigen::invert_f(u.col(1), h1);
+  if (uses_hinv_table(parameters)) {
+    return hinv_table_raw(u, parameters, 0);
+  }
+  return hinv_solve_raw(u, parameters, 0);
 }
 
 inline Eigen::VectorXd
 AbstractBicop::hinv2_num_raw(const Eigen::MatrixXd& u,
                              const Eigen::MatrixXd& parameters)
 {
-  Eigen::MatrixXd u_new = u;
-  auto h1 = [&](const Eigen::VectorXd& x) {
-    u_new.col(0) = x;
-    return hfunc2_raw(u_new.leftCols(2), parameters);
+  if (uses_hinv_table(parameters)) {
+    return hinv_table_raw(u, parameters, 1);
+  }
+  return hinv_solve_raw(u, parameters, 1);
+}
+
+inline Eigen::VectorXd
+AbstractBicop::hinv_solve_raw(const Eigen::MatrixXd& u,
+                              const Eigen::MatrixXd& parameters,
+                              Eigen::Index cond)
+{
+  return hinv_solve(
+    u.leftCols(2),
+    parameters,
+    1 - cond,
+    [this, cond](const Eigen::MatrixXd& v, const Eigen::MatrixXd& par) {
+      return cond == 0 ? hfunc1_raw(v, par) : hfunc2_raw(v, par);
+    });
+}
+
+template<typename Func>
+inline Eigen::VectorXd
+AbstractBicop::hinv_solve(const Eigen::MatrixXd& u,
+                          const Eigen::MatrixXd& parameters,
+                          Eigen::Index col,
+                          const Func& h)
+{
+  const bool per_row = (parameters.rows() == u.rows());
+  Eigen::MatrixXd u_active, par_active;
+  auto eval = [&](const std::vector<Eigen::Index>& rows,
+                  const Eigen::Ref<const Eigen::VectorXd>& v,
+                  Eigen::Ref<Eigen::VectorXd> f_out) {
+    // the active rows only shrink, so they are gathered anew on each call
+    const auto m = static_cast<Eigen::Index>(rows.size());
+    u_active.resize(m, u.cols());
+    for (Eigen::Index k = 0; k < m; ++k) {
+      u_active.row(k) = u.row(rows[k]);
+    }
+    u_active.col(col) = v;
+    if (!per_row) {
+      f_out = h(u_active, parameters);
+      return;
+    }
+    par_active.resize(m, parameters.cols());
+    for (Eigen::Index k = 0; k < m; ++k) {
+      par_active.row(k) = parameters.row(rows[k]);
+    }
+    f_out = h(u_active, par_active);
   };
 
-  return tools_eigen::invert_f(u.col(0), h1);
+  return tools_eigen::invert_f_illinois(u.col(col), eval);
+}
+//! @}
+
+//! @name Tabulated inverse h-functions
+//!
+//! Implement `HinvMethod::table` and `HinvMethod::table_newton`.
+//! @{
+
+//! whether the inverses use the table: only for the stored parameters, since
+//! a table is built for one parameter set.
+inline bool
+AbstractBicop::uses_hinv_table(const Eigen::MatrixXd& parameters) const
+{
+  if (hinv_method_ == HinvMethod::exact || parameters.rows() != 1) {
+    return false;
+  }
+  const Eigen::MatrixXd stored = get_parameters();
+  return stored.size() == parameters.size() &&
+         (stored.transpose().array() == parameters.array()).all();
+}
+
+//! inverts by interpolation in the table; points outside of the table and
+//! points where the table's value does not bracket the root (Newton polish)
+//! are inverted exactly.
+inline Eigen::VectorXd
+AbstractBicop::hinv_table_raw(const Eigen::MatrixXd& u,
+                              const Eigen::MatrixXd& parameters,
+                              Eigen::Index cond)
+{
+  auto table = std::atomic_load(&hinv_tables_[cond]);
+  if (!table || table->parameters.size() != parameters.size() ||
+      !(table->parameters.array() == parameters.array()).all()) {
+    auto quantile = [&](const Eigen::MatrixXd& x) {
+      return hinv_solve_raw(
+        cond == 0 ? x : tools_eigen::swap_cols(x), parameters, cond);
+    };
+    table = std::make_shared<const HinvTable>(
+      HinvTable{ parameters,
+                 tools_interpolation::ConditionalQuantileTable(quantile) });
+    std::atomic_store(&hinv_tables_[cond], table);
+  }
+
+  // evaluates the h-function and the density at (w, v), where w is the
+  // conditioning value
+  auto at = [cond](const Eigen::VectorXd& w, const Eigen::VectorXd& v) {
+    Eigen::MatrixXd x(w.size(), 2);
+    x.col(cond) = w;
+    x.col(1 - cond) = v;
+    return x;
+  };
+  auto h = [&](const Eigen::MatrixXd& x) {
+    return cond == 0 ? hfunc1_raw(x, parameters) : hfunc2_raw(x, parameters);
+  };
+
+  Eigen::MatrixXd wp(u.rows(), 2);
+  wp << u.col(cond), u.col(1 - cond);
+  const Eigen::VectorXd w = wp.col(0);
+  const Eigen::VectorXd p = wp.col(1);
+  Eigen::VectorXd v = table->table.interpolate(wp);
+  std::vector<Eigen::Index> rows;
+  for (Eigen::Index i = 0; i < v.size(); ++i) {
+    if (!(std::isnan)(v(i))) {
+      rows.push_back(i);
+    }
+  }
+
+  if (hinv_method_ == HinvMethod::table_newton && !rows.empty()) {
+    // bracket the inverse by a grid step around the table's value
+    const auto m = static_cast<Eigen::Index>(rows.size());
+    Eigen::VectorXd wr(m), pr(m), vr(m);
+    for (Eigen::Index k = 0; k < m; ++k) {
+      wr(k) = w(rows[k]);
+      pr(k) = p(rows[k]);
+      vr(k) = v(rows[k]);
+    }
+    const double step = table->table.get_step();
+    const Eigen::VectorXd z = tools_stats::qnorm(vr);
+    const Eigen::VectorXd lb = tools_stats::pnorm(z.array() - step);
+    const Eigen::VectorXd ub = tools_stats::pnorm(z.array() + step);
+    const Eigen::VectorXd hl = h(at(wr, lb));
+    const Eigen::VectorXd hh = h(at(wr, ub));
+
+    std::vector<Eigen::Index> bracketed;
+    for (Eigen::Index k = 0; k < m; ++k) {
+      if (hl(k) <= pr(k) && pr(k) <= hh(k)) {
+        bracketed.push_back(k);
+      } else {
+        v(rows[k]) = std::numeric_limits<double>::quiet_NaN();
+      }
+    }
+    const auto mb = static_cast<Eigen::Index>(bracketed.size());
+    Eigen::VectorXd wb(mb), pb(mb), lbb(mb), ubb(mb);
+    for (Eigen::Index k = 0; k < mb; ++k) {
+      wb(k) = wr(bracketed[k]);
+      pb(k) = pr(bracketed[k]);
+      lbb(k) = lb(bracketed[k]);
+      ubb(k) = ub(bracketed[k]);
+    }
+    auto eval = [&](const std::vector<Eigen::Index>& active,
+                    const Eigen::VectorXd& v_active,
+                    Eigen::VectorXd& f_out,
+                    Eigen::VectorXd& fprime_out) {
+      Eigen::VectorXd w_active(v_active.size());
+      for (size_t k = 0; k < active.size(); ++k) {
+        w_active(static_cast<Eigen::Index>(k)) = wb(active[k]);
+      }
+      const Eigen::MatrixXd x = at(w_active, v_active);
+      f_out = h(x);
+      fprime_out = pdf_raw(x, parameters);
+    };
+    const Eigen::VectorXd vb =
+      tools_eigen::invert_f_newton(pb, eval, lbb, ubb);
+    for (Eigen::Index k = 0; k < mb; ++k) {
+      v(rows[bracketed[k]]) = vb(k);
+    }
+  }
+
+  rows.clear();
+  for (Eigen::Index i = 0; i < v.size(); ++i) {
+    if ((std::isnan)(v(i))) {
+      rows.push_back(i);
+    }
+  }
+  eval_on_rows(u,
+               parameters,
+               rows,
+               v,
+               [&](const Eigen::MatrixXd& ur, const Eigen::MatrixXd& par) {
+                 return hinv_solve_raw(ur, par, cond);
+               });
+  return v;
 }
 //! @}
 
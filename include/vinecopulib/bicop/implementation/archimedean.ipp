@@ -37,22 +37,60 @@ ArchimedeanBicop::cdf(const Eigen::MatrixXd& u,
 inline Eigen::VectorXd
 ArchimedeanBicop::hfunc1_raw(const Eigen::MatrixXd& u,
                              const Eigen::MatrixXd& parameters)
+{
+  Eigen::VectorXd h(u.rows());
+  hfunc1_raw_into(u, parameters, h);
+  return h;
+}
+
+inline Eigen::VectorXd
+ArchimedeanBicop::hfunc2_raw(const Eigen::MatrixXd& u,
+                             const Eigen::MatrixXd& parameters)
+{
+  Eigen::VectorXd h(u.rows());
+  hfunc2_raw_into(u, parameters, h);
+  return h;
+}
+
+inline void
+ArchimedeanBicop::hfunc1_raw_into(const Eigen::MatrixXd& u,
+                                  const Eigen::MatrixXd& parameters,
+                                  Eigen::Ref<Eigen::VectorXd> out)
 {
   auto f = [this](const double& u1,
                   const double& u2,
                   const Eigen::Ref<const Eigen::VectorXd>& par) {
-    double temp = generator_inv(generator(u1, par) + generator(u2, par), par);
-    temp = generator_derivative(u1, par) / generator_derivative(temp, par);
-    return std::isnan(temp) ? u2 : std::min(temp, 1.0);
+    return hfunc1_scalar(u1, u2, par);
   };
-  return tools_eigen::binaryExpr_or_nan(u, parameters, f);
+  tools_eigen::binaryExpr_or_nan(u, parameters, f, out);
 }
 
-inline Eigen::VectorXd
-ArchimedeanBicop::hfunc2_raw(const Eigen::MatrixXd& u,
-                             const Eigen::MatrixXd& parameters)
+inline void
+ArchimedeanBicop::hfunc2_raw_into(const Eigen::MatrixXd& u,
+                                  const Eigen::MatrixXd& parameters,
+                                  Eigen::Ref<Eigen::VectorXd> out)
+{
+  // exchangeable: swap the arguments instead of the columns of u
+  auto f = [this](const double& u1,
+                  const double& u2,
+                  const Eigen::Ref<const Eigen::VectorXd>& par) {
+    return hfunc1_scalar(u2, u1, par);
+  };
+  tools_eigen::binaryExpr_or_nan(u, parameters, f, out);
+}
+
+inline double
+ArchimedeanBicop::hfunc1_scalar(
+  const double& u1,
+  const double& u2,
+  const Eigen::Ref<const Eigen::VectorXd>& parameters)
 {
-  return hfunc1_raw(tools_eigen::swap_cols(u), parameters);
+  double temp =
+    generator_inv(generator(u1, parameters) + generator(u2, parameters),
+                  parameters);
+  temp = generator_derivative(u1, parameters) /
+         generator_derivative(temp, parameters);
+  return std::isnan(temp) ? u2 : std::min(temp, 1.0);
 }
 
 inline Eigen::VectorXd
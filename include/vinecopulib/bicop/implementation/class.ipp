@@ -70,6 +70,12 @@ inline Bicop::Bicop(const Bicop& other)
   nobs_ = other.nobs_;
   bicop_->set_loglik(other.bicop_->get_loglik());
   bicop_->set_npars(other.bicop_->get_npars());
+  // the tables are immutable and can be shared
+  bicop_->hinv_method_ = other.bicop_->hinv_method_;
+  for (size_t k = 0; k < 2; ++k) {
+    bicop_->hinv_tables_[k] =
+      std::atomic_load(&other.bicop_->hinv_tables_[k]);
+  }
 }
 
 //! @brief Copy assignment operator (deep copy)
@@ -197,6 +203,23 @@ Bicop::pdf(const Eigen::MatrixXd& u) const
   return bicop_->pdf(prep_for_abstract(u));
 }
 
+//! @brief Evaluates the logarithm of the copula density.
+//!
+//! @details Equivalent to `pdf(u).array().log()`, but families with a closed
+//! form evaluate the log-density directly, which is faster and does not
+//! underflow where the density is tiny. The result is truncated to
+//! \f$ [\log(\mathrm{DBL\_MIN}), \log(\mathrm{DBL\_MAX})] \f$, consistent with
+//! `pdf()`.
+//!
+//! @param u Observations, see `pdf()`.
+//! @return A length n vector of copula log-densities evaluated at \c u.
+inline Eigen::VectorXd
+Bicop::logpdf(const Eigen::MatrixXd& u) const
+{
+  check_data(u);
+  return bicop_->logpdf(prep_for_abstract(u));
+}
+
 //! @brief Evaluates the copula distribution.
 //!
 //! @details When at least one variable is discrete, more than two
@@ -503,7 +526,7 @@ BicopView::swap_arguments(const Eigen::MatrixXd& u)
 inline Eigen::VectorXd
 Bicop::pdf(const Eigen::MatrixXd& u,
            const Eigen::MatrixXd& parameters,
-           const size_t num_threads) const
+           const tools_thread::Executor& num_threads) const
 {
   Eigen::MatrixXd par_t = format_parameters(u, parameters);
   return eval_in_batches(u,
@@ -515,11 +538,27 @@ Bicop::pdf(const Eigen::MatrixXd& u,
                          });
 }
 
+//! @brief Evaluates the copula log-density with per-row parameters.
+inline Eigen::VectorXd
+Bicop::logpdf(const Eigen::MatrixXd& u,
+              const Eigen::MatrixXd& parameters,
+              const tools_thread::Executor& num_threads) const
+{
+  Eigen::MatrixXd par_t = format_parameters(u, parameters);
+  return eval_in_batches(u,
+                         par_t,
+                         num_threads,
+                         [this](const Eigen::MatrixXd& ub,
+                                const Eigen::MatrixXd& pb) -> Eigen::VectorXd {
+                           return bicop_->logpdf(prep_for_abstract(ub), pb);
+                         });
+}
+
 //! @brief Evaluates the copula distribution with per-row parameters.
 inline Eigen::VectorXd
 Bicop::cdf(const Eigen::MatrixXd& u,
            const Eigen::MatrixXd& parameters,
-           const size_t num_threads) const
+           const tools_thread::Executor& num_threads) const
 {
   Eigen::MatrixXd par_t = format_parameters(u, parameters);
   return eval_in_batches(
@@ -547,7 +586,7 @@ Bicop::cdf(const Eigen::MatrixXd& u,
 inline Eigen::VectorXd
 Bicop::hfunc1(const Eigen::MatrixXd& u,
               const Eigen::MatrixXd& parameters,
-              const size_t num_threads) const
+              const tools_thread::Executor& num_threads) const
 {
   Eigen::MatrixXd par_t = format_parameters(u, parameters);
   return eval_in_batches(u,
@@ -568,7 +607,7 @@ Bicop::hfunc1(const Eigen::MatrixXd& u,
 inline Eigen::VectorXd
 Bicop::hfunc2(const Eigen::MatrixXd& u,
               const Eigen::MatrixXd& parameters,
-              const size_t num_threads) const
+              const tools_thread::Executor& num_threads) const
 {
   Eigen::MatrixXd par_t = format_parameters(u, parameters);
   return eval_in_batches(u,
@@ -590,7 +629,7 @@ Bicop::hfunc2(const Eigen::MatrixXd& u,
 inline Eigen::VectorXd
 Bicop::hinv1(const Eigen::MatrixXd& u,
              const Eigen::MatrixXd& parameters,
-             const size_t num_threads) const
+             const tools_thread::Executor& num_threads) const
 {
   Eigen::MatrixXd par_t = format_parameters(u, parameters);
   return eval_in_batches(u,
@@ -612,7 +651,7 @@ Bicop::hinv1(const Eigen::MatrixXd& u,
 inline Eigen::VectorXd
 Bicop::hinv2(const Eigen::MatrixXd& u,
              const Eigen::MatrixXd& parameters,
-             const size_t num_threads) const
+             const tools_thread::Executor& num_threads) const
 {
   Eigen::MatrixXd par_t = format_parameters(u, parameters);
   return eval_in_batches(u,
@@ -634,9 +673,9 @@ Bicop::hinv2(const Eigen::MatrixXd& u,
 inline double
 Bicop::loglik(const Eigen::MatrixXd& u,
               const Eigen::MatrixXd& parameters,
-              const size_t num_threads) const
+              const tools_thread::Executor& num_threads) const
 {
-  Eigen::VectorXd lpdf = pdf(u, parameters, num_threads).array().log();
+  Eigen::VectorXd lpdf = logpdf(u, parameters, num_threads);
   double ll = 0.0;
   for (Eigen::Index i = 0; i < lpdf.size(); ++i) {
     if (!(std::isnan)(lpdf(i))) {
@@ -863,7 +902,7 @@ inline Eigen::VectorXd
 Bicop::pdf_deriv(const Eigen::MatrixXd& u,
                  const std::string& deriv,
                  const Eigen::MatrixXd& parameters,
-                 const size_t num_threads) const
+                 const tools_thread::Executor& num_threads) const
 {
   check_deriv_preconditions();
   auto spec = map_pdf_deriv(tools_deriv::canonicalize(deriv, 1, deriv_npars()));
@@ -885,7 +924,7 @@ inline Eigen::VectorXd
 Bicop::pdf_deriv2(const Eigen::MatrixXd& u,
                   const std::string& deriv,
                   const Eigen::MatrixXd& parameters,
-                  const size_t num_threads) const
+                  const tools_thread::Executor& num_threads) const
 {
   check_deriv_preconditions();
   auto spec = map_pdf_deriv(tools_deriv::canonicalize(deriv, 2, deriv_npars()));
@@ -907,7 +946,7 @@ inline Eigen::VectorXd
 Bicop::hfunc1_deriv(const Eigen::MatrixXd& u,
                     const std::string& deriv,
                     const Eigen::MatrixXd& parameters,
-                    const size_t num_threads) const
+                    const tools_thread::Executor& num_threads) const
 {
   check_deriv_preconditions();
   auto canonical = tools_deriv::canonicalize(deriv, 1, deriv_npars());
@@ -936,7 +975,7 @@ inline Eigen::VectorXd
 Bicop::hfunc1_deriv2(const Eigen::MatrixXd& u,
                      const std::string& deriv,
                      const Eigen::MatrixXd& parameters,
-                     const size_t num_threads) const
+                     const tools_thread::Executor& num_threads) const
 {
   check_deriv_preconditions();
   auto canonical = tools_deriv::canonicalize(deriv, 2, deriv_npars());
@@ -967,7 +1006,7 @@ inline Eigen::VectorXd
 Bicop::hfunc2_deriv(const Eigen::MatrixXd& u,
                     const std::string& deriv,
                     const Eigen::MatrixXd& parameters,
-                    const size_t num_threads) const
+                    const tools_thread::Executor& num_threads) const
 {
   check_deriv_preconditions();
   auto canonical = tools_deriv::canonicalize(deriv, 1, deriv_npars());
@@ -996,7 +1035,7 @@ inline Eigen::VectorXd
 Bicop::hfunc2_deriv2(const Eigen::MatrixXd& u,
                      const std::string& deriv,
                      const Eigen::MatrixXd& parameters,
-                     const size_t num_threads) const
+                     const tools_thread::Executor& num_threads) const
 {
   check_deriv_preconditions();
   auto canonical = tools_deriv::canonicalize(deriv, 2, deriv_npars());
@@ -1028,7 +1067,7 @@ inline Eigen::VectorXd
 Bicop::logpdf_deriv(const Eigen::MatrixXd& u,
                     const std::string& deriv,
                     const Eigen::MatrixXd& parameters,
-                    const size_t num_threads) const
+                    const tools_thread::Executor& num_threads) const
 {
   check_deriv_preconditions();
   auto canonical = tools_deriv::canonicalize(deriv, 1, deriv_npars());
@@ -1056,7 +1095,7 @@ inline Eigen::VectorXd
 Bicop::logpdf_deriv2(const Eigen::MatrixXd& u,
                      const std::string& deriv,
                      const Eigen::MatrixXd& parameters,
-                     const size_t num_threads) const
+                     const tools_thread::Executor& num_threads) const
 {
   check_deriv_preconditions();
   auto canonical = tools_deriv::canonicalize(deriv, 2, deriv_npars());
@@ -1256,7 +1295,7 @@ Bicop::scores_full(const Eigen::MatrixXd& u) const
 inline Eigen::MatrixXd
 Bicop::scores(const Eigen::MatrixXd& u,
               const Eigen::MatrixXd& parameters,
-              const size_t num_threads) const
+              const tools_thread::Executor& num_threads) const
 {
   check_deriv_preconditions();
   return assemble_scores(
@@ -1271,7 +1310,7 @@ Bicop::scores(const Eigen::MatrixXd& u,
 inline Eigen::VectorXd
 Bicop::gradient(const Eigen::MatrixXd& u,
                 const Eigen::MatrixXd& parameters,
-                const size_t num_threads) const
+                const tools_thread::Executor& num_threads) const
 {
   return scores(u, parameters, num_threads).colwise().mean().transpose();
 }
@@ -1281,7 +1320,7 @@ Bicop::gradient(const Eigen::MatrixXd& u,
 inline Eigen::MatrixXd
 Bicop::hessian(const Eigen::MatrixXd& u,
                const Eigen::MatrixXd& parameters,
-               const size_t num_threads) const
+               const tools_thread::Executor& num_threads) const
 {
   check_deriv_preconditions();
   return assemble_hessian(static_cast<Eigen::Index>(deriv_npars()),
@@ -1299,7 +1338,7 @@ Bicop::hessian(const Eigen::MatrixXd& u,
 inline std::vector<Eigen::MatrixXd>
 Bicop::hessian_full(const Eigen::MatrixXd& u,
                     const Eigen::MatrixXd& parameters,
-                    const size_t num_threads) const
+                    const tools_thread::Executor& num_threads) const
 {
   check_deriv_preconditions();
   return assemble_hessian_full(u.rows(),
@@ -1318,7 +1357,7 @@ Bicop::hessian_full(const Eigen::MatrixXd& u,
 inline Eigen::MatrixXd
 Bicop::scores_cov(const Eigen::MatrixXd& u,
                   const Eigen::MatrixXd& parameters,
-                  const size_t num_threads) const
+                  const tools_thread::Executor& num_threads) const
 {
   Eigen::MatrixXd s = scores(u, parameters, num_threads);
   Eigen::MatrixXd sc = s.rowwise() - s.colwise().mean();
@@ -1330,7 +1369,7 @@ Bicop::scores_cov(const Eigen::MatrixXd& u,
 inline Bicop::ScoresResult
 Bicop::scores_full(const Eigen::MatrixXd& u,
                    const Eigen::MatrixXd& parameters,
-                   const size_t num_threads) const
+                   const tools_thread::Executor& num_threads) const
 {
   ScoresResult result;
   result.scores = scores(u, parameters, num_threads);
@@ -1480,7 +1519,7 @@ inline Eigen::VectorXd
 Bicop::eval_in_batches(
   const Eigen::MatrixXd& u,
   const Eigen::MatrixXd& parameters,
-  const size_t num_threads,
+  const tools_thread::Executor& num_threads,
   const std::function<Eigen::VectorXd(const Eigen::MatrixXd&,
                                       const Eigen::MatrixXd&)>& f) const
 {
@@ -1493,12 +1532,11 @@ Bicop::eval_in_batches(
     out.segment(b.begin, b.size) =
       f(u.middleRows(b.begin, b.size), parameters.middleRows(b.begin, b.size));
   };
-  if (num_threads <= 1) {
+  if (num_threads.get_num_threads() <= 1) {
     do_batch(tools_batch::Batch{ 0, n });
   } else {
-    tools_thread::ThreadPool pool(num_threads);
-    pool.map(do_batch, tools_batch::create_batches(n, num_threads));
-    pool.join();
+    num_threads.map(
+      do_batch, tools_batch::create_batches(n, num_threads.get_num_threads()));
   }
   return out;
 }
@@ -1549,7 +1587,7 @@ inline Eigen::MatrixXd
 Bicop::simulate(const Eigen::MatrixXd& parameters,
                 const bool qrng,
                 const std::vector<int>& seeds,
-                const size_t num_threads) const
+                const tools_thread::Executor& num_threads) const
 {
   if (parameters.rows() < 1) {
     throw std::runtime_error("parameters must have at least one row (one "
@@ -1992,6 +2030,18 @@ Bicop::get_var_types() const
 {
   return var_types_;
 }
+
+inline void
+Bicop::set_hinv_method(const HinvMethod method)
+{
+  bicop_->set_hinv_method(method);
+}
+
+inline HinvMethod
+Bicop::get_hinv_method() const
+{
+  return bicop_->get_hinv_method();
+}
 //! @}
 
 //! @name Utilities
@@ -2162,6 +2212,29 @@ Bicop::fit(const Eigen::MatrixXd& data, const FitControlsBicop& controls)
 //! @param controls The controls (see `FitControlsBicop`).
 inline void
 Bicop::select(const Eigen::MatrixXd& data, FitControlsBicop controls)
+{
+  tools_thread::Executor executor(controls.get_num_threads());
+  select(data, std::move(controls), executor);
+}
+
+//! @brief Selects the best fitting model, fitting the candidates on a given
+//! executor.
+//!
+//! @details Same as `select(data, controls)`, except that the candidate fits
+//! are submitted to `executor` instead of an executor built from
+//! `controls.get_num_threads()`. Callers that select many pair copulas
+//! concurrently (like `Vinecop::select()`) pass the executor they run on, so
+//! that candidate fits of slow edges are picked up by idle workers instead of
+//! each edge getting a fixed share of the threads.
+//!
+//! @param data See `select(data, controls)`.
+//! @param controls See `select(data, controls)`; the number of threads is
+//!   ignored.
+//! @param executor The executor running the candidate fits.
+inline void
+Bicop::select(const Eigen::MatrixXd& data,
+              FitControlsBicop controls,
+              const tools_thread::Executor& executor)
 {
   using namespace tools_select;
   check_weights_size(controls.get_weights(), data);
@@ -2174,6 +2247,8 @@ Bicop::select(const Eigen::MatrixXd& data, FitControlsBicop controls)
   check_data(data_no_nan);
   nobs_ = data_no_nan.rows();
 
+  const auto hinv_method =
+    bicop_ ? bicop_->get_hinv_method() : HinvMethod::exact;
   bicop_ = AbstractBicop::create();
   bicop_->set_var_types(var_types_);
   rotation_ = 0;
@@ -2235,10 +2310,9 @@ Bicop::select(const Eigen::MatrixXd& data, FitControlsBicop controls)
       }
     };
 
-    tools_thread::ThreadPool pool(controls.get_num_threads());
-    pool.map(fit_and_compare, bicops);
-    pool.wait();
+    executor.map(fit_and_compare, bicops);
   }
+  bicop_->set_hinv_method(hinv_method);
 }
 
 //! @brief Adds an additional column if there's only one discrete variable;
@@ -48,6 +48,16 @@ ClaytonBicop::generator_derivative(
 inline Eigen::VectorXd
 ClaytonBicop::pdf_raw(const Eigen::MatrixXd& u,
                       const Eigen::MatrixXd& parameters)
+{
+  Eigen::VectorXd pdf(u.rows());
+  pdf_raw_into(u, parameters, pdf);
+  return pdf;
+}
+
+inline void
+ClaytonBicop::pdf_raw_into(const Eigen::MatrixXd& u,
+                           const Eigen::MatrixXd& parameters,
+                           Eigen::Ref<Eigen::VectorXd> out)
 {
   auto f = [](const double& u1,
               const double& u2,
@@ -62,7 +72,35 @@ ClaytonBicop::pdf_raw(const Eigen::MatrixXd& u,
                     std::log(std::pow(u1, -theta) + std::pow(u2, -theta) - 1.0);
     return std::exp(temp);
   };
-  return tools_eigen::binaryExpr_or_nan(u, parameters, f);
+  tools_eigen::binaryExpr_or_nan(u, parameters, f, out);
+}
+
+inline Eigen::VectorXd
+ClaytonBicop::logpdf_raw(const Eigen::MatrixXd& u,
+                         const Eigen::MatrixXd& parameters)
+{
+  Eigen::VectorXd logpdf(u.rows());
+  logpdf_raw_into(u, parameters, logpdf);
+  return logpdf;
+}
+
+inline void
+ClaytonBicop::logpdf_raw_into(const Eigen::MatrixXd& u,
+                              const Eigen::MatrixXd& parameters,
+                              Eigen::Ref<Eigen::VectorXd> out)
+{
+  auto f = [](const double& u1,
+              const double& u2,
+              const Eigen::Ref<const Eigen::VectorXd>& par) {
+    double theta = par(0);
+    if (theta < 1e-10) {
+      return 0.0;
+    }
+    return std::log1p(theta) - (1.0 + theta) * std::log(u1 * u2) -
+           (2.0 + 1.0 / (theta)) *
+             std::log(std::pow(u1, -theta) + std::pow(u2, -theta) - 1.0);
+  };
+  tools_eigen::binaryExpr_or_nan(u, parameters, f, out);
 }
 
 inline Eigen::VectorXd
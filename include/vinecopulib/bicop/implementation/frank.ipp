@@ -46,6 +46,16 @@ FrankBicop::generator_derivative(
 
 inline Eigen::VectorXd
 FrankBicop::pdf_raw(const Eigen::MatrixXd& u, const Eigen::MatrixXd& parameters)
+{
+  Eigen::VectorXd pdf(u.rows());
+  pdf_raw_into(u, parameters, pdf);
+  return pdf;
+}
+
+inline void
+FrankBicop::pdf_raw_into(const Eigen::MatrixXd& u,
+                         const Eigen::MatrixXd& parameters,
+                         Eigen::Ref<Eigen::VectorXd> out)
 {
   auto f = [](const double& u1,
               const double& u2,
@@ -58,20 +68,50 @@ FrankBicop::pdf_raw(const Eigen::MatrixXd& u, const Eigen::MatrixXd& parameters)
                       std::exp(theta * u1 + theta) + std::exp(theta),
                     2.0);
   };
-  return tools_eigen::binaryExpr_or_nan(u, parameters, f);
+  tools_eigen::binaryExpr_or_nan(u, parameters, f, out);
+}
+
+inline Eigen::VectorXd
+FrankBicop::logpdf_raw(const Eigen::MatrixXd& u,
+                       const Eigen::MatrixXd& parameters)
+{
+  Eigen::VectorXd logpdf(u.rows());
+  logpdf_raw_into(u, parameters, logpdf);
+  return logpdf;
+}
+
+inline void
+FrankBicop::logpdf_raw_into(const Eigen::MatrixXd& u,
+                            const Eigen::MatrixXd& parameters,
+                            Eigen::Ref<Eigen::VectorXd> out)
+{
+  auto f = [](const double& u1,
+              const double& u2,
+              const Eigen::Ref<const Eigen::VectorXd>& par) {
+    double theta = par(0);
+    // theta * expm1(theta) > 0 for either sign of theta
+    return std::log(theta * std::expm1(theta)) + theta * (u1 + u2 + 1.0) -
+           2.0 * std::log(std::fabs(std::exp(theta * u2 + theta * u1) -
+                                    std::exp(theta * u2 + theta) -
+                                    std::exp(theta * u1 + theta) +
+                                    std::exp(theta)));
+  };
+  tools_eigen::binaryExpr_or_nan(u, parameters, f, out);
 }
 
 inline Eigen::MatrixXd
 FrankBicop::tau_to_parameters(const double& tau)
 {
   Eigen::VectorXd tau0 = Eigen::VectorXd::Constant(1, tau);
-  auto f = [&](const Eigen::VectorXd& par) {
-    return Eigen::VectorXd::Constant(1, parameters_to_tau(par));
+  auto f = [&](const std::vector<Eigen::Index>&,
+               const Eigen::Ref<const Eigen::VectorXd>& par,
+               Eigen::Ref<Eigen::VectorXd> f_out) {
+    f_out(0) = parameters_to_tau(par);
   };
-  return tools_eigen::invert_f(tau0,
-                               f,
-                               parameters_lower_bounds_(0) + 1e-6,
-                               parameters_upper_bounds_(0) - 1e-5);
+  return tools_eigen::invert_f_illinois(tau0,
+                                        f,
+                                        parameters_lower_bounds_(0) + 1e-6,
+                                        parameters_upper_bounds_(0) - 1e-5);
 }
 
 inline double
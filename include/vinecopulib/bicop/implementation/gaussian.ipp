@@ -4,6 +4,7 @@
 // the MIT license. For a copy, see the LICENSE file in the root directory of
 // vinecopulib or https://vinecopulib.github.io/vinecopulib/.
 
+#include <algorithm>
 #include <cmath>
 #include <vinecopulib/misc/tools_eigen.hpp>
 #include <vinecopulib/misc/tools_stats.hpp>
@@ -24,38 +25,27 @@ inline Eigen::VectorXd
 GaussianBicop::pdf_raw(const Eigen::MatrixXd& u,
                        const Eigen::MatrixXd& parameters)
 {
-  const Eigen::Index n = u.rows();
-  if (parameters.rows() == 1) {
-    // broadcast: scalar inverse-Cholesky form (bit-identical to the historical
-    // state-based path)
-    double rho = parameters(0, 0);
-    Eigen::Matrix2d L;
-    L(0, 0) = 1;
-    L(1, 1) = 1 / sqrt(1.0 - pow(rho, 2.0));
-    L(0, 1) = -rho * L(1, 1);
-    L(1, 0) = 0;
-
-    Eigen::VectorXd f = Eigen::VectorXd::Ones(n);
-    Eigen::MatrixXd tmp = tools_stats::qnorm(u);
-    f = f.cwiseQuotient(tools_stats::dnorm(tmp).rowwise().prod());
-    tmp = tmp * L;
-    f = f.cwiseProduct(tools_stats::dnorm(tmp).rowwise().prod());
-    return f / sqrt(1.0 - pow(rho, 2.0));
-  }
+  // one exponential per row on top of the closed-form log-density, instead
+  // of four normal densities
+  return logpdf_raw(u, parameters).array().exp();
+}
 
+inline Eigen::VectorXd
+GaussianBicop::logpdf_raw(const Eigen::MatrixXd& u,
+                          const Eigen::MatrixXd& parameters)
+{
+  const Eigen::Index n = u.rows();
   Eigen::ArrayXd rho =
     tools_eigen::parameter_as_vector(parameters, 0, n).array();
-  Eigen::ArrayXd s = (1.0 - rho.square()).sqrt(); // sqrt(1 - rho^2)
+  Eigen::ArrayXd s2 = 1.0 - rho.square();
 
+  // log c = -log(1 - rho^2) / 2 -
+  //   (rho^2 (z1^2 + z2^2) - 2 rho z1 z2) / (2 (1 - rho^2))
   Eigen::MatrixXd z = tools_stats::qnorm(u);
-  Eigen::MatrixXd zL(n, 2);
-  zL.col(0) = z.col(0);
-  zL.col(1) = (z.col(1).array() - rho * z.col(0).array()) / s;
-
-  Eigen::VectorXd f = tools_stats::dnorm(zL).rowwise().prod();
-  f = f.cwiseQuotient(tools_stats::dnorm(z).rowwise().prod());
-  f = (f.array() / s).matrix();
-  return f;
+  Eigen::ArrayXd z1 = z.col(0).array(), z2 = z.col(1).array();
+  Eigen::ArrayXd q = rho.square() * (z1.square() + z2.square()) -
+                     2.0 * rho * z1 * z2;
+  return (-0.5 * s2.log() - q / (2.0 * s2)).matrix();
 }
 
 inline Eigen::VectorXd
@@ -114,6 +104,94 @@ GaussianBicop::hinv1_raw(const Eigen::MatrixXd& u,
   return tools_stats::pnorm(hinv);
 }
 
+inline void
+GaussianBicop::pdf_raw_into(const Eigen::MatrixXd& u,
+                            const Eigen::MatrixXd& parameters,
+                            Eigen::Ref<Eigen::VectorXd> out)
+{
+  if (parameters.rows() != 1) {
+    out = pdf_raw(u, parameters);
+    return;
+  }
+  const double rho = parameters(0, 0);
+  const double s2 = 1.0 - rho * rho;
+  eval_on_normal_scores(u, out, [&](const auto& z1, const auto& z2, auto res) {
+    res = (-0.5 * std::log(s2) -
+           (rho * rho * (z1.square() + z2.square()) - 2.0 * rho * z1 * z2) /
+             (2.0 * s2))
+            .exp()
+            .matrix();
+  });
+}
+
+inline void
+GaussianBicop::logpdf_raw_into(const Eigen::MatrixXd& u,
+                               const Eigen::MatrixXd& parameters,
+                               Eigen::Ref<Eigen::VectorXd> out)
+{
+  if (parameters.rows() != 1) {
+    out = logpdf_raw(u, parameters);
+    return;
+  }
+  const double rho = parameters(0, 0);
+  const double s2 = 1.0 - rho * rho;
+  eval_on_normal_scores(u, out, [&](const auto& z1, const auto& z2, auto res) {
+    res = (-0.5 * std::log(s2) -
+           (rho * rho * (z1.square() + z2.square()) - 2.0 * rho * z1 * z2) /
+             (2.0 * s2))
+            .matrix();
+  });
+}
+
+inline void
+GaussianBicop::hfunc1_raw_into(const Eigen::MatrixXd& u,
+                               const Eigen::MatrixXd& parameters,
+                               Eigen::Ref<Eigen::VectorXd> out)
+{
+  if (parameters.rows() != 1) {
+    out = hfunc1_raw(u, parameters);
+    return;
+  }
+  const double rho = parameters(0, 0);
+  const double s = std::sqrt(2.0 * (1.0 - rho * rho));
+  eval_on_normal_scores(u, out, [&](const auto& z1, const auto& z2, auto res) {
+    res = (0.5 * (1.0 + ((z2 - rho * z1) / s).erf())).matrix();
+  });
+}
+
+inline void
+GaussianBicop::hfunc2_raw_into(const Eigen::MatrixXd& u,
+                               const Eigen::MatrixXd& parameters,
+                               Eigen::Ref<Eigen::VectorXd> out)
+{
+  if (parameters.rows() != 1) {
+    out = hfunc1_raw(tools_eigen::swap_cols(u), parameters);
+    return;
+  }
+  const double rho = parameters(0, 0);
+  const double s = std::sqrt(2.0 * (1.0 - rho * rho));
+  eval_on_normal_scores(u, out, [&](const auto& z1, const auto& z2, auto res) {
+    res = (0.5 * (1.0 + ((z1 - rho * z2) / s).erf())).matrix();
+  });
+}
+
+template<typename Func>
+inline void
+GaussianBicop::eval_on_normal_scores(const Eigen::MatrixXd& u,
+                                     Eigen::Ref<Eigen::VectorXd> out,
+                                     const Func& f)
+{
+  constexpr Eigen::Index chunk_size = 64;
+  Eigen::Array<double, chunk_size, 1> z1, z2;
+  const Eigen::Index n = u.rows();
+  for (Eigen::Index i = 0; i < n; i += chunk_size) {
+    const Eigen::Index m = std::min(chunk_size, n - i);
+    tools_stats::qnorm(u.col(0).data() + i, m, z1.data());
+    tools_stats::qnorm(u.col(1).data() + i, m, z2.data());
+    f(z1.head(m), z2.head(m), out.segment(i, m));
+  }
+}
+
 inline Eigen::VectorXd
 GaussianBicop::pdf_deriv_raw(const Eigen::MatrixXd& u,
                              const Eigen::MatrixXd& parameters,
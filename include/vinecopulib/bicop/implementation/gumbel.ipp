@@ -45,6 +45,16 @@ GumbelBicop::generator_derivative(
 inline Eigen::VectorXd
 GumbelBicop::pdf_raw(const Eigen::MatrixXd& u,
                      const Eigen::MatrixXd& parameters)
+{
+  Eigen::VectorXd pdf(u.rows());
+  pdf_raw_into(u, parameters, pdf);
+  return pdf;
+}
+
+inline void
+GumbelBicop::pdf_raw_into(const Eigen::MatrixXd& u,
+                          const Eigen::MatrixXd& parameters,
+                          Eigen::Ref<Eigen::VectorXd> out)
 {
   auto f = [](const double& u1,
               const double& u2,
@@ -58,7 +68,35 @@ GumbelBicop::pdf_raw(const Eigen::MatrixXd& u,
                   std::log1p((theta - 1.0) * std::pow(t1, -thetha1));
     return std::exp(temp);
   };
-  return tools_eigen::binaryExpr_or_nan(u, parameters, f);
+  tools_eigen::binaryExpr_or_nan(u, parameters, f, out);
+}
+
+inline Eigen::VectorXd
+GumbelBicop::logpdf_raw(const Eigen::MatrixXd& u,
+                        const Eigen::MatrixXd& parameters)
+{
+  Eigen::VectorXd logpdf(u.rows());
+  logpdf_raw_into(u, parameters, logpdf);
+  return logpdf;
+}
+
+inline void
+GumbelBicop::logpdf_raw_into(const Eigen::MatrixXd& u,
+                             const Eigen::MatrixXd& parameters,
+                             Eigen::Ref<Eigen::VectorXd> out)
+{
+  auto f = [](const double& u1,
+              const double& u2,
+              const Eigen::Ref<const Eigen::VectorXd>& par) {
+    double theta = par(0);
+    double thetha1 = 1.0 / theta;
+    double t1 = std::pow(-std::log(u1), theta) + std::pow(-std::log(u2), theta);
+    return -std::pow(t1, thetha1) + (2 * thetha1 - 2.0) * std::log(t1) +
+           (theta - 1.0) * std::log(std::log(u1) * std::log(u2)) -
+           std::log(u1 * u2) +
+           std::log1p((theta - 1.0) * std::pow(t1, -thetha1));
+  };
+  tools_eigen::binaryExpr_or_nan(u, parameters, f, out);
 }
 
 inline Eigen::VectorXd
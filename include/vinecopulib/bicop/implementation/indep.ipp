@@ -21,6 +21,13 @@ IndepBicop::pdf_raw(const Eigen::MatrixXd& u, const Eigen::MatrixXd&)
   return tools_eigen::binaryExpr_or_nan(u, f);
 }
 
+inline Eigen::VectorXd
+IndepBicop::logpdf_raw(const Eigen::MatrixXd& u, const Eigen::MatrixXd&)
+{
+  auto f = [](double, double) { return 0.0; };
+  return tools_eigen::binaryExpr_or_nan(u, f);
+}
+
 inline Eigen::VectorXd
 IndepBicop::cdf(const Eigen::MatrixXd& u, const Eigen::MatrixXd&)
 {
@@ -41,6 +48,42 @@ IndepBicop::hfunc2_raw(const Eigen::MatrixXd& u, const Eigen::MatrixXd&)
   return tools_eigen::binaryExpr_or_nan(u, f);
 }
 
+inline void
+IndepBicop::pdf_raw_into(const Eigen::MatrixXd& u,
+                         const Eigen::MatrixXd&,
+                         Eigen::Ref<Eigen::VectorXd> out)
+{
+  auto f = [](double, double) { return 1.0; };
+  tools_eigen::binaryExpr_or_nan(u, f, out);
+}
+
+inline void
+IndepBicop::logpdf_raw_into(const Eigen::MatrixXd& u,
+                            const Eigen::MatrixXd&,
+                            Eigen::Ref<Eigen::VectorXd> out)
+{
+  auto f = [](double, double) { return 0.0; };
+  tools_eigen::binaryExpr_or_nan(u, f, out);
+}
+
+inline void
+IndepBicop::hfunc1_raw_into(const Eigen::MatrixXd& u,
+                            const Eigen::MatrixXd&,
+                            Eigen::Ref<Eigen::VectorXd> out)
+{
+  auto f = [](double, double u2) { return u2; };
+  tools_eigen::binaryExpr_or_nan(u, f, out);
+}
+
+inline void
+IndepBicop::hfunc2_raw_into(const Eigen::MatrixXd& u,
+                            const Eigen::MatrixXd&,
+                            Eigen::Ref<Eigen::VectorXd> out)
+{
+  auto f = [](double u1, double) { return u1; };
+  tools_eigen::binaryExpr_or_nan(u, f, out);
+}
+
 inline Eigen::VectorXd
 IndepBicop::hinv1_raw(const Eigen::MatrixXd& u, const Eigen::MatrixXd&)
 {
@@ -46,6 +46,16 @@ JoeBicop::generator_derivative(
 
 inline Eigen::VectorXd
 JoeBicop::pdf_raw(const Eigen::MatrixXd& u, const Eigen::MatrixXd& parameters)
+{
+  Eigen::VectorXd pdf(u.rows());
+  pdf_raw_into(u, parameters, pdf);
+  return pdf;
+}
+
+inline void
+JoeBicop::pdf_raw_into(const Eigen::MatrixXd& u,
+                       const Eigen::MatrixXd& parameters,
+                       Eigen::Ref<Eigen::VectorXd> out)
 {
   auto f = [](const double& u1,
               const double& u2,
@@ -57,7 +67,34 @@ JoeBicop::pdf_raw(const Eigen::MatrixXd& u, const Eigen::MatrixXd& parameters)
            std::pow(1 - u1, theta - 1) * std::pow(1 - u2, theta - 1) *
            (theta - 1 + t1 + t2 - t1 * t2);
   };
-  return tools_eigen::binaryExpr_or_nan(u, parameters, f);
+  tools_eigen::binaryExpr_or_nan(u, parameters, f, out);
+}
+
+inline Eigen::VectorXd
+JoeBicop::logpdf_raw(const Eigen::MatrixXd& u,
+                     const Eigen::MatrixXd& parameters)
+{
+  Eigen::VectorXd logpdf(u.rows());
+  logpdf_raw_into(u, parameters, logpdf);
+  return logpdf;
+}
+
+inline void
+JoeBicop::logpdf_raw_into(const Eigen::MatrixXd& u,
+                          const Eigen::MatrixXd& parameters,
+                          Eigen::Ref<Eigen::VectorXd> out)
+{
+  auto f = [](const double& u1,
+              const double& u2,
+              const Eigen::Ref<const Eigen::VectorXd>& par) {
+    double theta = par(0);
+    double t1 = std::pow(1 - u1, theta);
+    double t2 = std::pow(1 - u2, theta);
+    return (1 / theta - 2) * std::log(t1 + t2 - t1 * t2) +
+           (theta - 1) * (std::log1p(-u1) + std::log1p(-u2)) +
+           std::log(theta - 1 + t1 + t2 - t1 * t2);
+  };
+  tools_eigen::binaryExpr_or_nan(u, parameters, f, out);
 }
 
 // inverse h-function
@@ -7,6 +7,7 @@
 #include <boost/math/special_functions/beta.hpp>
 #include <boost/math/special_functions/digamma.hpp>
 #include <boost/math/special_functions/trigamma.hpp>
+#include <cmath>
 #include <vinecopulib/misc/tools_eigen.hpp>
 #include <vinecopulib/misc/tools_stats.hpp>
 
@@ -523,19 +524,28 @@ inline StudentBicop::StudentBicop()
 inline Eigen::VectorXd
 StudentBicop::pdf_impl(const Eigen::MatrixXd& u, double rho, double nu)
 {
-  Eigen::VectorXd f = Eigen::VectorXd::Ones(u.rows());
-  Eigen::MatrixXd tmp = tools_stats::qt(u, nu);
-
-  f = tmp.col(0).cwiseAbs2() + tmp.col(1).cwiseAbs2() -
-      (2 * rho) * tmp.rowwise().prod();
-  f /= nu * (1.0 - pow(rho, 2.0));
-  f = f + Eigen::VectorXd::Ones(u.rows());
-  f = f.array().pow(-(nu + 2.0) / 2.0);
-  f = f.cwiseQuotient(tools_stats::dt(tmp, nu).rowwise().prod());
-  f *= boost::math::tgamma_ratio((nu + 2.0) / 2.0, nu / 2.0);
-  f /= (nu * constant::pi * sqrt(1.0 - pow(rho, 2.0)));
+  // the closed-form log-density vectorizes; the textbook form needs two
+  // univariate densities per row on top
+  return logpdf_impl(u, rho, nu).array().exp();
+}
 
-  return f;
+inline Eigen::VectorXd
+StudentBicop::logpdf_impl(const Eigen::MatrixXd& u, double rho, double nu)
+{
+  Eigen::MatrixXd tmp = tools_stats::qt(u, nu);
+  Eigen::ArrayXd q = tmp.col(0).cwiseAbs2() + tmp.col(1).cwiseAbs2() -
+                     (2 * rho) * tmp.rowwise().prod();
+  q /= nu * (1.0 - pow(rho, 2.0));
+  // log of the bivariate t density over the product of the univariate ones;
+  // the normalizing constants combine into one lgamma sum
+  double log_const = std::lgamma((nu + 2.0) / 2.0) + std::lgamma(nu / 2.0) -
+                     2 * std::lgamma((nu + 1.0) / 2.0) -
+                     0.5 * std::log(1.0 - pow(rho, 2.0));
+  Eigen::ArrayXd log_marg =
+    (tmp.array().square() / nu).log1p().rowwise().sum();
+  return (log_const - (nu + 2.0) / 2.0 * q.log1p() +
+          (nu + 1.0) / 2.0 * log_marg)
+    .matrix();
 }
 
 inline Eigen::VectorXd
@@ -588,6 +598,52 @@ StudentBicop::hinv1_impl(const Eigen::MatrixXd& u, double rho, double nu)
   return hinv;
 }
 
+inline Eigen::VectorXd
+StudentBicop::logpdf_impl(const Eigen::MatrixXd& u,
+                          const Eigen::ArrayXd& rho,
+                          const Eigen::ArrayXd& nu)
+{
+  Eigen::MatrixXd tmp = tools_stats::qt(u, nu.matrix());
+  Eigen::ArrayXd x1 = tmp.col(0).array(), x2 = tmp.col(1).array();
+  Eigen::ArrayXd s2 = 1.0 - rho.square();
+  Eigen::ArrayXd q =
+    (x1.square() + x2.square() - 2.0 * rho * x1 * x2) / (nu * s2);
+  Eigen::ArrayXd log_const = ((nu + 2.0) / 2.0).lgamma() +
+                             (nu / 2.0).lgamma() -
+                             2.0 * ((nu + 1.0) / 2.0).lgamma() - 0.5 * s2.log();
+  Eigen::ArrayXd log_marg =
+    (x1.square() / nu).log1p() + (x2.square() / nu).log1p();
+  return (log_const - (nu + 2.0) / 2.0 * q.log1p() +
+          (nu + 1.0) / 2.0 * log_marg)
+    .matrix();
+}
+
+inline Eigen::VectorXd
+StudentBicop::hfunc1_impl(const Eigen::MatrixXd& u,
+                          const Eigen::ArrayXd& rho,
+                          const Eigen::ArrayXd& nu)
+{
+  Eigen::MatrixXd tmp = tools_stats::qt(u, nu.matrix());
+  Eigen::ArrayXd x1 = tmp.col(0).array(), x2 = tmp.col(1).array();
+  Eigen::ArrayXd h = (x2 - rho * x1) /
+                     ((nu + x1.square()) * (1.0 - rho.square()) / (nu + 1.0))
+                       .sqrt();
+  return tools_stats::pt(h.matrix(), (nu + 1.0).matrix());
+}
+
+inline Eigen::VectorXd
+StudentBicop::hinv1_impl(const Eigen::MatrixXd& u,
+                         const Eigen::ArrayXd& rho,
+                         const Eigen::ArrayXd& nu)
+{
+  Eigen::ArrayXd x1 = tools_stats::qt(u.col(0), nu.matrix()).array();
+  Eigen::ArrayXd x2 = tools_stats::qt(u.col(1), (nu + 1.0).matrix()).array();
+  Eigen::ArrayXd hinv =
+    ((nu + x1.square()) * (1.0 - rho.square()) / (nu + 1.0)).sqrt() * x2 +
+    rho * x1;
+  return tools_stats::pt(hinv.matrix(), nu.matrix());
+}
+
 inline Eigen::VectorXd
 StudentBicop::pdf_raw(const Eigen::MatrixXd& u,
                       const Eigen::MatrixXd& parameters)
@@ -595,11 +651,19 @@ StudentBicop::pdf_raw(const Eigen::MatrixXd& u,
   if (parameters.rows() == 1) {
     return pdf_impl(u, parameters(0, 0), parameters(0, 1));
   }
-  Eigen::VectorXd out(u.rows());
-  for (Eigen::Index i = 0; i < u.rows(); ++i) {
-    out(i) = pdf_impl(u.row(i), parameters(i, 0), parameters(i, 1))(0);
+  return logpdf_impl(u, parameters.col(0).array(), parameters.col(1).array())
+    .array()
+    .exp();
+}
+
+inline Eigen::VectorXd
+StudentBicop::logpdf_raw(const Eigen::MatrixXd& u,
+                         const Eigen::MatrixXd& parameters)
+{
+  if (parameters.rows() == 1) {
+    return logpdf_impl(u, parameters(0, 0), parameters(0, 1));
   }
-  return out;
+  return logpdf_impl(u, parameters.col(0).array(), parameters.col(1).array());
 }
 
 inline Eigen::VectorXd
@@ -622,11 +686,7 @@ StudentBicop::hfunc1_raw(const Eigen::MatrixXd& u,
   if (parameters.rows() == 1) {
     return hfunc1_impl(u, parameters(0, 0), parameters(0, 1));
   }
-  Eigen::VectorXd out(u.rows());
-  for (Eigen::Index i = 0; i < u.rows(); ++i) {
-    out(i) = hfunc1_impl(u.row(i), parameters(i, 0), parameters(i, 1))(0);
-  }
-  return out;
+  return hfunc1_impl(u, parameters.col(0).array(), parameters.col(1).array());
 }
 
 inline Eigen::VectorXd
@@ -636,11 +696,7 @@ StudentBicop::hinv1_raw(const Eigen::MatrixXd& u,
   if (parameters.rows() == 1) {
     return hinv1_impl(u, parameters(0, 0), parameters(0, 1));
   }
-  Eigen::VectorXd out(u.rows());
-  for (Eigen::Index i = 0; i < u.rows(); ++i) {
-    out(i) = hinv1_impl(u.row(i), parameters(i, 0), parameters(i, 1))(0);
-  }
-  return out;
+  return hinv1_impl(u, parameters.col(0).array(), parameters.col(1).array());
 }
 
 inline Eigen::VectorXd
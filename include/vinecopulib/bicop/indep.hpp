@@ -29,6 +29,9 @@ private:
   Eigen::VectorXd pdf_raw(const Eigen::MatrixXd& u,
                           const Eigen::MatrixXd& parameters) override;
 
+  Eigen::VectorXd logpdf_raw(const Eigen::MatrixXd& u,
+                             const Eigen::MatrixXd& parameters) override;
+
   Eigen::VectorXd cdf(const Eigen::MatrixXd& u,
                       const Eigen::MatrixXd& parameters) override;
 
@@ -38,6 +41,22 @@ private:
   Eigen::VectorXd hfunc2_raw(const Eigen::MatrixXd& u,
                              const Eigen::MatrixXd& parameters) override;
 
+  void pdf_raw_into(const Eigen::MatrixXd& u,
+                    const Eigen::MatrixXd& parameters,
+                    Eigen::Ref<Eigen::VectorXd> out) override;
+
+  void logpdf_raw_into(const Eigen::MatrixXd& u,
+                       const Eigen::MatrixXd& parameters,
+                       Eigen::Ref<Eigen::VectorXd> out) override;
+
+  void hfunc1_raw_into(const Eigen::MatrixXd& u,
+                       const Eigen::MatrixXd& parameters,
+                       Eigen::Ref<Eigen::VectorXd> out) override;
+
+  void hfunc2_raw_into(const Eigen::MatrixXd& u,
+                       const Eigen::MatrixXd& parameters,
+                       Eigen::Ref<Eigen::VectorXd> out) override;
+
   Eigen::VectorXd hinv1_raw(const Eigen::MatrixXd& u,
                             const Eigen::MatrixXd& parameters) override;
 
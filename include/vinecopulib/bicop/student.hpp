@@ -29,6 +29,9 @@ private:
   Eigen::VectorXd pdf_raw(const Eigen::MatrixXd& u,
                           const Eigen::MatrixXd& parameters) override;
 
+  Eigen::VectorXd logpdf_raw(const Eigen::MatrixXd& u,
+                             const Eigen::MatrixXd& parameters) override;
+
   Eigen::VectorXd cdf(const Eigen::MatrixXd& u,
                       const Eigen::MatrixXd& parameters) override;
 
@@ -111,6 +114,9 @@ private:
   static Eigen::VectorXd pdf_impl(const Eigen::MatrixXd& u,
                                   double rho,
                                   double nu);
+  static Eigen::VectorXd logpdf_impl(const Eigen::MatrixXd& u,
+                                     double rho,
+                                     double nu);
   static Eigen::VectorXd cdf_impl(const Eigen::MatrixXd& u,
                                   double rho,
                                   double nu);
@@ -121,6 +127,18 @@ private:
                                     double rho,
                                     double nu);
 
+  // same math with per-observation parameters: `rho(i)` and `nu(i)` apply to
+  // `u.row(i)`
+  static Eigen::VectorXd logpdf_impl(const Eigen::MatrixXd& u,
+                                     const Eigen::ArrayXd& rho,
+                                     const Eigen::ArrayXd& nu);
+  static Eigen::VectorXd hfunc1_impl(const Eigen::MatrixXd& u,
+                                     const Eigen::ArrayXd& rho,
+                                     const Eigen::ArrayXd& nu);
+  static Eigen::VectorXd hinv1_impl(const Eigen::MatrixXd& u,
+                                    const Eigen::ArrayXd& rho,
+                                    const Eigen::ArrayXd& nu);
+
   Eigen::MatrixXd tau_to_parameters(const double& tau) override;
 
   Eigen::MatrixXd parameters_to_taildep(
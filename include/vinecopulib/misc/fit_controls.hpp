@@ -105,6 +105,10 @@ struct FitControlsConfig
   //! conditioned on with `Vinecop::simulate_conditional()`). Default: empty
   //! (unconditional selection).
   std::optional<std::vector<size_t>> conditioning_set;
+
+  //! Number of observations on which the tree criteria are screened before
+  //! computing them exactly. Default: 0 (no screening).
+  std::optional<size_t> screening_size;
 };
 
 }
\ No newline at end of file
@@ -81,7 +81,7 @@ trim(Eigen::MatrixXd& x, const double& lower, const double& upper)
 //! @param lower Lower bound of the interval.
 //! @param upper Upper bound of the interval.
 inline void
-trim(Eigen::VectorXd& x, const double& lower, const double& upper)
+trim(Eigen::Ref<Eigen::VectorXd> x, const double& lower, const double& upper)
 {
   // code of std::for_each (save some compile time by not including <algorithm>)
   auto it = x.data();
@@ -96,7 +96,7 @@ trim(Eigen::VectorXd& x, const double& lower, const double& upper)
 //! @param u Copula data.
 //! @return `true` if all data lie in the unit cube; throws an error otherwise.
 inline bool
-check_if_in_unit_cube(const Eigen::MatrixXd& u)
+check_if_in_unit_cube(const tools_eigen::ConstMatRef& u)
 {
   bool any_outside = (u.array() < 0.0).any() || (u.array() > 1.0).any();
   if (any_outside) {
@@ -125,46 +125,6 @@ unique(const Eigen::VectorXd& x)
   return Eigen::Map<Eigen::VectorXd>(&v[0], v.size());
 }
 
-//! computes the inverse \f$ f^{-1} \f$ of a function \f$ f \f$ by the
-//! bisection method.
-//!
-//! @param x Evaluation points.
-//! @param f The function to invert.
-//! @param lb Lower bound.
-//! @param ub Upper bound.
-//! @param n_iter The number of iterations for the bisection (defaults to 35,
-//! guaranteeing an accuracy of 0.5^35 ~= 6e-11).
-//!
-//! @return \f$ f^{-1}(x) \f$.
-inline Eigen::VectorXd
-invert_f(const Eigen::VectorXd& x,
-         std::function<Eigen::VectorXd(const Eigen::VectorXd&)> f,
-         const double lb,
-         const double ub,
-         int n_iter)
-{
-  Eigen::VectorXd xl = Eigen::VectorXd::Constant(x.size(), lb);
-  Eigen::VectorXd xh = Eigen::VectorXd::Constant(x.size(), ub);
-  Eigen::VectorXd x_tmp = x;
-  Eigen::VectorXd fm(x.size());
-  for (int iter = 0; iter < n_iter; ++iter) {
-    x_tmp = (xh + xl) / 2.0;
-    fm = f(x_tmp) - x;
-    xl = (fm.array() < 0).select(x_tmp, xl);
-    xh = (fm.array() < 0).select(xh, x_tmp);
-  }
-  if (fm.array().isNaN().any()) {
-    size_t n = x.size();
-    for (size_t j = 0; j < n; j++) {
-      if ((std::isnan)(fm(j))) {
-        x_tmp(j) = std::numeric_limits<double>::quiet_NaN();
-      }
-    }
-  }
-
-  return x_tmp;
-}
-
 //! computes the inverse \f$ f^{-1} \f$ of a monotone increasing function
 //! \f$ f \f$ by a vectorized safeguarded Newton method (the `rtsafe`
 //! algorithm of Numerical Recipes, run per element).
@@ -197,12 +157,35 @@ invert_f_newton(const Eigen::VectorXd& x,
                 const double ub,
                 const double tol,
                 int n_iter)
+{
+  return invert_f_newton(x,
+                         eval,
+                         Eigen::VectorXd::Constant(x.size(), lb),
+                         Eigen::VectorXd::Constant(x.size(), ub),
+                         tol,
+                         n_iter);
+}
+
+//! computes the inverse \f$ f^{-1} \f$ of a monotone increasing function
+//! \f$ f \f$ by a vectorized safeguarded Newton method, starting from
+//! per-element brackets.
+//!
+//! @details Same as above, but each element starts from its own bracket
+//! \f$ [\text{lb}_j, \text{ub}_j] \f$; a narrow bracket around a good guess
+//! converges in a few Newton steps.
+inline Eigen::VectorXd
+invert_f_newton(const Eigen::VectorXd& x,
+                const NewtonEval& eval,
+                const Eigen::VectorXd& lb,
+                const Eigen::VectorXd& ub,
+                const double tol,
+                int n_iter)
 {
   const Eigen::Index n = x.size();
   const double nan = std::numeric_limits<double>::quiet_NaN();
   const Eigen::ArrayXd xa = x.array();
-  Eigen::ArrayXd xl = Eigen::ArrayXd::Constant(n, lb);
-  Eigen::ArrayXd xh = Eigen::ArrayXd::Constant(n, ub);
+  Eigen::ArrayXd xl = lb.array();
+  Eigen::ArrayXd xh = ub.array();
   Eigen::ArrayXd v = 0.5 * (xl + xh);
   Eigen::ArrayXd dx = (xh - xl).abs();
   Eigen::ArrayXd dxold = dx;
@@ -4,8 +4,11 @@
 // the MIT license. For a copy, see the LICENSE file in the root directory of
 // vinecopulib or https://vinecopulib.github.io/vinecopulib/.
 
+#include <algorithm>
+#include <limits>
 #include <stdexcept>
 #include <vinecopulib/misc/tools_eigen.hpp>
+#include <vinecopulib/misc/tools_stats.hpp>
 
 namespace vinecopulib {
 
@@ -520,5 +523,67 @@ InterpolationGrid::int_on_grid(const double& upr,
 
   return tmpint;
 }
+
+//! Constructor
+//!
+//! @param quantile Computes \f$ F^{-1}(p \mid w) \f$ for each row
+//!   \f$ (w, p) \f$ of an \f$ n \times 2 \f$ matrix; called once, on all
+//!   grid points.
+//! @param grid_size Number of grid points in each dimension.
+//! @param z_max The grid covers \f$ [-z_{max}, z_{max}]^2 \f$ on the normal
+//!   scale.
+inline ConditionalQuantileTable::ConditionalQuantileTable(
+  const std::function<Eigen::VectorXd(const Eigen::MatrixXd&)>& quantile,
+  size_t grid_size,
+  double z_max)
+  : grid_size_(grid_size)
+  , z_max_(z_max)
+{
+  if (grid_size_ < 2) {
+    throw std::runtime_error("grid_size must be at least 2.");
+  }
+  step_ = 2.0 * z_max_ / static_cast<double>(grid_size_ - 1);
+  const auto m = static_cast<Eigen::Index>(grid_size_);
+  const Eigen::VectorXd x =
+    tools_stats::pnorm(Eigen::VectorXd::LinSpaced(m, -z_max_, z_max_));
+  Eigen::MatrixXd grid(m * m, 2);
+  for (Eigen::Index i = 0; i < m; ++i) {
+    grid.block(i * m, 0, m, 1).setConstant(x(i));
+    grid.block(i * m, 1, m, 1) = x;
+  }
+  Eigen::VectorXd q = quantile(grid);
+  tools_eigen::trim(q, 1e-20, 1.0 - 1e-16);
+  scores_ =
+    tools_stats::qnorm(Eigen::Map<const Eigen::MatrixXd>(q.data(), m, m));
+}
+
+//! Interpolates the conditional quantile function.
+//!
+//! @param x An \f$ n \times 2 \f$ matrix of points \f$ (w, p) \f$.
+//! @return The interpolated quantiles; NaN for points outside of the grid
+//!   (and for NaN input).
+inline Eigen::VectorXd
+ConditionalQuantileTable::interpolate(const Eigen::MatrixXd& x) const
+{
+  const Eigen::MatrixXd z = tools_stats::qnorm(x.leftCols(2));
+  const double last = static_cast<double>(grid_size_ - 1);
+  Eigen::VectorXd scores(x.rows());
+  for (Eigen::Index k = 0; k < x.rows(); ++k) {
+    const double a = (z(k, 0) + z_max_) / step_;
+    const double b = (z(k, 1) + z_max_) / step_;
+    if (!(a >= 0.0 && a <= last && b >= 0.0 && b <= last)) {
+      scores(k) = std::numeric_limits<double>::quiet_NaN();
+      continue;
+    }
+    const auto i = static_cast<Eigen::Index>(std::min(a, last - 1.0));
+    const auto j = static_cast<Eigen::Index>(std::min(b, last - 1.0));
+    const double s = a - static_cast<double>(i);
+    const double t = b - static_cast<double>(j);
+    scores(k) =
+      (1.0 - s) * ((1.0 - t) * scores_(j, i) + t * scores_(j + 1, i)) +
+      s * ((1.0 - t) * scores_(j, i + 1) + t * scores_(j + 1, i + 1));
+  }
+  return tools_stats::pnorm(scores);
+}
 }
 }
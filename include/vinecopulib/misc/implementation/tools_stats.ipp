@@ -4,11 +4,15 @@
 // the MIT license. For a copy, see the LICENSE file in the root directory of
 // vinecopulib or https://vinecopulib.github.io/vinecopulib/.
 
+#include <algorithm>
 #include <array>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/seed_seq.hpp>
 #include <boost/random/uniform_real_distribution.hpp>
+#include <limits>
 #include <memory>
+#include <numeric>
+#include <sstream>
 #include <unsupported/Eigen/FFT>
 #include <vinecopulib/misc/tools_stats_ghalton.hpp>
 #include <vinecopulib/misc/tools_stats_sobol.hpp>
@@ -68,6 +72,74 @@ simulate_uniform(const size_t& n,
     n, d, [&]() { return distribution(generator); });
 }
 
+//! @brief Simulates a block of rows from the multivariate uniform
+//! distribution.
+//!
+//! @details Returns the rows `begin` to `begin + size - 1` of
+//! `simulate_uniform(n, d, qrng, seeds)` without simulating the others, so
+//! that blocks of a sample can be simulated independently and in any order.
+//! The Mersenne twister skips ahead to the start of each column of the block;
+//! Boost jumps ahead in a few milliseconds instead of drawing the skipped
+//! numbers when there are more than ten million of them. The quasi-random
+//! sequences start at point `begin`.
+//!
+//! @param n Number of observations of the full sample.
+//! @param d Dimension.
+//! @param begin Index of the first row of the block.
+//! @param size Number of rows of the block.
+//! @param qrng If true, quasi-numbers are generated.
+//! @param seeds Seeds of the random number generator; if empty (default),
+//!   the random number generator is seeded randomly, so that blocks from
+//!   different calls do not belong to the same sample.
+//! @return A \f$ \mathrm{size} \times d \f$ matrix of independent
+//! \f$ \mathrm{U}[0, 1] \f$ random variables.
+inline Eigen::MatrixXd
+simulate_uniform_rows(const size_t& n,
+                      const size_t& d,
+                      const size_t& begin,
+                      const size_t& size,
+                      bool qrng,
+                      std::vector<int> seeds)
+{
+  if ((n < 1) || (d < 1) || (size < 1)) {
+    throw std::runtime_error("n, d, and size must be at least 1.");
+  }
+  if (begin + size > n) {
+    throw std::runtime_error("the block must lie within the n rows.");
+  }
+  if (qrng) {
+    if (d > 300) {
+      return tools_stats::sobol(size, d, seeds, begin);
+    } else {
+      return tools_stats::ghalton(size, d, seeds, begin);
+    }
+  }
+  if (seeds.size() == 0) {
+    // no seeds provided, seed randomly
+    std::random_device rd{};
+    seeds = std::vector<int>(20);
+    std::generate(
+      seeds.begin(), seeds.end(), [&]() { return static_cast<int>(rd()); });
+  }
+
+  boost::random::seed_seq seq(seeds.begin(), seeds.end());
+  boost::random::mt19937 generator(seq);
+  boost::random::uniform_real_distribution<double> distribution(0.0, 1.0);
+
+  // column j of the full sample starts at draw j * n
+  Eigen::MatrixXd u(size, d);
+  generator.discard(begin);
+  for (size_t j = 0; j < d; ++j) {
+    for (size_t i = 0; i < size; ++i) {
+      u(i, j) = distribution(generator);
+    }
+    if (j + 1 < d) {
+      generator.discard(n - size);
+    }
+  }
+  return u;
+}
+
 //! @brief Simulates from independendent normals.
 //!
 //! @param n Number of observations.
@@ -549,6 +621,257 @@ pairwise_cxi(const Eigen::MatrixXd& x, const Eigen::VectorXd& weights)
   }
   return std::max(xi12, xi21);
 }
+
+//! (internal) weight of the pairs tied in the sorted vector `x`, i.e.,
+//! \f$ \sum_{i < j} w_i w_j \f$ over the pairs with \f$ x_i = x_j \f$; all
+//! weights are one if `w` is empty.
+inline double
+ktau_tied_weight(const uint32_t* x, const std::vector<double>& w, size_t n)
+{
+  double ties = 0.0;
+  for (size_t i = 0; i < n;) {
+    double sum = 0.0, sum_sq = 0.0;
+    size_t j = i;
+    for (; (j < n) && (x[j] == x[i]); ++j) {
+      const double w_j = w.empty() ? 1.0 : w[j];
+      sum += w_j;
+      sum_sq += w_j * w_j;
+    }
+    ties += (sum * sum - sum_sq) / 2.0;
+    i = j;
+  }
+  return ties;
+}
+
+//! (internal) weight of the pairs in the wrong order in `y`, i.e.,
+//! \f$ \sum_{i < j} w_i w_j \f$ over the pairs with \f$ y_i > y_j \f$; all
+//! weights are one if `w` is empty. The elements of `y` must be less than its
+//! size; `sums` is scratch space with one more element.
+inline double
+ktau_discordant(const std::vector<uint32_t>& y,
+                const std::vector<double>& w,
+                std::vector<double>& sums)
+{
+  // a Fenwick tree of the weights seen so far, indexed by rank
+  const size_t n = y.size();
+  std::fill(sums.begin(), sums.end(), 0.0);
+  double seen = 0.0, discordant = 0.0;
+  for (size_t k = 0; k < n; ++k) {
+    const double w_k = w.empty() ? 1.0 : w[k];
+    double below = 0.0;
+    for (size_t r = y[k] + 1; r > 0; r &= r - 1) {
+      below += sums[r];
+    }
+    discordant += w_k * (seen - below);
+    for (size_t r = y[k] + 1; r <= n; r += r & (~r + 1)) {
+      sums[r] += w_k;
+    }
+    seen += w_k;
+  }
+  return discordant;
+}
+
+//! (internal) the permutation that sorts `x` (stably).
+inline std::vector<size_t>
+sort_order(const Eigen::Ref<const Eigen::VectorXd>& x)
+{
+  std::vector<size_t> order(static_cast<size_t>(x.size()));
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return x(a) < x(b);
+  });
+  return order;
+}
+
+//! (internal) Kendall's tau-b for all pairs of columns of `x`, with Knight's
+//! algorithm. Each column is sorted once and replaced by its ranks. For a pair
+//! of columns, the ranks of the second are arranged in the order of the first
+//! (breaking ties by their own values), and the discordant pairs are counted
+//! with a Fenwick tree.
+inline Eigen::MatrixXd
+ktau_matrix(const Eigen::MatrixXd& x,
+            const Eigen::VectorXd& weights,
+            const tools_thread::Executor& num_threads)
+{
+  const size_t n = static_cast<size_t>(x.rows());
+  const size_t d = static_cast<size_t>(x.cols());
+  if (n >= std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("x has too many rows.");
+  }
+  const std::vector<double> w = wdm::utils::convert_vec(weights);
+  double pairs = static_cast<double>(n) * static_cast<double>(n - 1) / 2.0;
+  if (!w.empty()) {
+    pairs = (weights.sum() * weights.sum() - weights.squaredNorm()) / 2.0;
+  }
+
+  // ranks of each column (equal values get equal ranks), whether it has ties,
+  // and the weight of its tied pairs
+  std::vector<std::vector<uint32_t>> ranks(d);
+  std::vector<char> has_ties(d, 0);
+  std::vector<double> ties(d, 0.0);
+  auto rank_column = [&](size_t j) {
+    const std::vector<size_t> order = sort_order(x.col(j));
+    std::vector<uint32_t> sorted(n);
+    std::vector<double> w_sorted(w.empty() ? 0 : n);
+    uint32_t rank = 0;
+    ranks[j].resize(n);
+    for (size_t k = 0; k < n; ++k) {
+      if ((k > 0) && (x(order[k], j) != x(order[k - 1], j))) {
+        ++rank;
+      }
+      ranks[j][order[k]] = sorted[k] = rank;
+      if (!w.empty()) {
+        w_sorted[k] = w[order[k]];
+      }
+    }
+    has_ties[j] = static_cast<char>(rank + 1 < n);
+    ties[j] = ktau_tied_weight(sorted.data(), w_sorted, n);
+  };
+  num_threads.map(rank_column, tools_stl::seq_int(0, d));
+
+  // one task per column `i`, pairing it with all later columns
+  Eigen::MatrixXd tau = Eigen::MatrixXd::Identity(d, d);
+  auto do_column = [&](size_t i) {
+    tools_interface::check_user_interrupt();
+    const std::vector<size_t> order = sort_order(x.col(i));
+    std::vector<uint32_t> y(n);
+    std::vector<double> w_y(w.size()), sums(n + 1);
+    std::vector<std::pair<uint32_t, double>> group;
+    for (size_t j = i + 1; j < d; ++j) {
+      const auto& ranks_j = ranks[j];
+      for (size_t k = 0; k < n; ++k) {
+        y[k] = ranks_j[order[k]];
+      }
+      for (size_t k = 0; k < w.size(); ++k) {
+        w_y[k] = w[order[k]];
+      }
+      // within runs of ties in column i, sort by column j and count the pairs
+      // tied in both
+      double joint_ties = 0.0;
+      for (size_t lo = 0; has_ties[i] && (lo < n);) {
+        size_t hi = lo + 1;
+        while ((hi < n) && (ranks[i][order[hi]] == ranks[i][order[lo]])) {
+          ++hi;
+        }
+        if (hi - lo > 1) {
+          group.clear();
+          for (size_t k = lo; k < hi; ++k) {
+            group.emplace_back(y[k], w.empty() ? 1.0 : w_y[k]);
+          }
+          std::stable_sort(
+            group.begin(), group.end(), [](const auto& a, const auto& b) {
+              return a.first < b.first;
+            });
+          std::vector<double> w_group(w.empty() ? 0 : hi - lo);
+          for (size_t k = lo; k < hi; ++k) {
+            y[k] = group[k - lo].first;
+            if (!w.empty()) {
+              w_y[k] = w_group[k - lo] = group[k - lo].second;
+            }
+          }
+          joint_ties += ktau_tied_weight(&y[lo], w_group, hi - lo);
+        }
+        lo = hi;
+      }
+      const double discordant = ktau_discordant(y, w_y, sums);
+      tau(i, j) = (pairs - 2.0 * discordant - ties[i] - ties[j] + joint_ties) /
+                  std::sqrt((pairs - ties[i]) * (pairs - ties[j]));
+      tau(j, i) = tau(i, j);
+    }
+  };
+  num_threads.map(do_column, tools_stl::seq_int(0, d));
+  return tau;
+}
+
+//! (internal) weighted Pearson correlations of all pairs of columns of `x`,
+//! computed block by block of columns.
+inline Eigen::MatrixXd
+pearson_matrix(Eigen::MatrixXd x,
+               const Eigen::VectorXd& weights,
+               const tools_thread::Executor& num_threads)
+{
+  const Eigen::Index d = x.cols();
+  const Eigen::VectorXd w =
+    (weights.size() > 0) ? weights : Eigen::VectorXd::Ones(x.rows());
+  const Eigen::ArrayXd sqrt_w = w.array().sqrt();
+  for (Eigen::Index j = 0; j < d; ++j) {
+    x.col(j).array() -= w.dot(x.col(j)) / w.sum();
+    x.col(j).array() *= sqrt_w;
+    x.col(j).normalize();
+  }
+
+  // each task multiplies two blocks of columns, so that both stay in cache
+  const Eigen::Index block = 64;
+  std::vector<std::pair<Eigen::Index, Eigen::Index>> tiles;
+  for (Eigen::Index i = 0; i < d; i += block) {
+    for (Eigen::Index j = 0; j <= i; j += block) {
+      tiles.emplace_back(i, j);
+    }
+  }
+  Eigen::MatrixXd cor(d, d);
+  auto do_tile = [&](const std::pair<Eigen::Index, Eigen::Index>& tile) {
+    tools_interface::check_user_interrupt();
+    const Eigen::Index rows = std::min(block, d - tile.first);
+    const Eigen::Index cols = std::min(block, d - tile.second);
+    cor.block(tile.first, tile.second, rows, cols).noalias() =
+      x.middleCols(tile.first, rows).transpose() *
+      x.middleCols(tile.second, cols);
+    cor.block(tile.second, tile.first, cols, rows) =
+      cor.block(tile.first, tile.second, rows, cols).transpose();
+  };
+  num_threads.map(do_tile, tiles);
+  cor.diagonal().setOnes();
+  return cor;
+}
+
+//! @brief Computes a dependence measure for all pairs of columns of a matrix.
+//!
+//! @details Equivalent to `wdm::wdm(x, method, weights)`, but prepares each
+//! column once rather than once per pair. Kendall's tau replaces each column
+//! by its ranks, which take half the memory of `x`, and reuses them for all
+//! pairs the column is part of (Knight's algorithm). Spearman's rho ranks
+//! each column once, and the (rank) correlations are computed as blocked
+//! matrix products.
+//!
+//! @param x An \f$ n \times d \f$ matrix without missing values.
+//! @param method The dependence measure; one of `"kendall"` (or `"ktau"`,
+//!   `"tau"`), `"spearman"` (or `"srho"`, `"rho"`), and `"pearson"` (or
+//!   `"prho"`, `"cor"`).
+//! @param weights Vector of weights for the observations (can be empty).
+//! @param num_threads The number of threads to use for computations.
+//! @return A symmetric \f$ d \times d \f$ matrix with unit diagonal.
+inline Eigen::MatrixXd
+dependence_matrix(const Eigen::MatrixXd& x,
+                  const std::string& method,
+                  const Eigen::VectorXd& weights,
+                  const tools_thread::Executor& num_threads)
+{
+  if ((weights.size() > 0) && (weights.size() != x.rows())) {
+    throw std::runtime_error("sizes of x and weights don't match.");
+  }
+  if (x.array().isNaN().any()) {
+    throw std::runtime_error("x must not contain missing values.");
+  }
+  if ((method == "kendall") || (method == "ktau") || (method == "tau")) {
+    return ktau_matrix(x, weights, num_threads);
+  } else if ((method == "spearman") || (method == "srho") ||
+             (method == "rho")) {
+    Eigen::MatrixXd ranks(x.rows(), x.cols());
+    const auto wvec = wdm::utils::convert_vec(weights);
+    auto rank_column = [&](size_t j) {
+      auto r =
+        wdm::impl::rank(wdm::utils::convert_vec(x.col(j)), wvec, "average");
+      ranks.col(j) = Eigen::Map<Eigen::VectorXd>(r.data(), r.size());
+    };
+    num_threads.map(rank_column,
+                    tools_stl::seq_int(0, static_cast<size_t>(x.cols())));
+    return pearson_matrix(std::move(ranks), weights, num_threads);
+  } else if ((method == "pearson") || (method == "prho") ||
+             (method == "cor")) {
+    return pearson_matrix(x, weights, num_threads);
+  }
+  throw std::runtime_error("method not implemented: " + method + ".");
+}
 //! @}
 
 //! @brief Simulates from the multivariate Generalized Halton Sequence.
@@ -562,58 +885,23 @@ pairwise_cxi(const Eigen::MatrixXd& x, const Eigen::VectorXd& weights)
 //! @param seeds Seeds to scramble the quasi-random numbers; if empty
 //! (default),
 //!   the quasi-random number generator is seeded randomly.
+//! @param begin Index of the first point; the result holds the points
+//!   `begin` to `begin + n - 1` of the sequence.
 //!
 //! @return An \f$ n \times d \f$ matrix of quasi-random
 //! \f$ \mathrm{U}[0, 1] \f$ variables.
 inline Eigen::MatrixXd
-ghalton(const size_t& n, const size_t& d, const std::vector<int>& seeds)
+ghalton(const size_t& n,
+        const size_t& d,
+        const std::vector<int>& seeds,
+        const size_t& begin)
 {
   if ((n < 1) || (d < 1)) {
     throw std::runtime_error("n and d must be at least 1.");
   }
-
-  Eigen::MatrixXd res(d, n);
-
-  // Coefficients of the shift
-  Eigen::MatrixXi shcoeff(d, 32);
-  Eigen::VectorXi base = tools_ghalton::primes.block(0, 0, d, 1);
-  Eigen::MatrixXd u = Eigen::VectorXd::Zero(d, 1);
-  auto U = simulate_uniform(d, 32, false, seeds);
-  for (int k = 31; k >= 0; k--) {
-    shcoeff.col(k) =
-      (base.cast<double>()).cwiseProduct(U.block(0, k, d, 1)).cast<int>();
-    u = (u + shcoeff.col(k).cast<double>()).cwiseQuotient(base.cast<double>());
-  }
-  res.block(0, 0, d, 1) = u;
-
-  Eigen::VectorXi perm = tools_ghalton::permTN2.block(0, 0, d, 1);
-  Eigen::MatrixXi coeff(d, 32);
-  Eigen::VectorXi tmp(d);
-  auto mod = [](const int& u1, const int& u2) { return u1 % u2; };
-  for (size_t i = 1; i < n; i++) {
-
-    // Find i in the prime base
-    tmp = Eigen::VectorXi::Constant(d, static_cast<int>(i));
-    coeff = Eigen::MatrixXi::Zero(d, 32);
-    int k = 0;
-    while ((tmp.maxCoeff() > 0) && (k < 32)) {
-      coeff.col(k) = tmp.binaryExpr(base, mod);
-      tmp = tmp.cwiseQuotient(base);
-      k++;
-    }
-
-    u = Eigen::VectorXd::Zero(d);
-    k = 31;
-    while (k >= 0) {
-      tmp = perm.cwiseProduct(coeff.col(k)) + shcoeff.col(k);
-      u = u + tmp.binaryExpr(base, mod).cast<double>();
-      u = u.cwiseQuotient(base.cast<double>());
-      k--;
-    }
-    res.block(0, i, d, 1) = u;
-  }
-
-  return res.transpose();
+  GhaltonSequence sequence(d, seeds);
+  sequence.skip(begin);
+  return sequence.next(n);
 }
 
 //! @brief Simulates from the multivariate Sobol sequence.
@@ -627,87 +915,354 @@ ghalton(const size_t& n, const size_t& d, const std::vector<int>& seeds)
 //! @param seeds Seeds to scramble the quasi-random numbers; if empty
 //! (default),
 //!   the quasi-random number generator is seeded randomly.
+//! @param begin Index of the first point; the result holds the points
+//!   `begin` to `begin + n - 1` of the sequence.
 //!
 //! @return An \f$ n \times d \f$ matrix of quasi-random
 //! \f$ \mathrm{U}[0, 1] \f$ variables.
 inline Eigen::MatrixXd
-sobol(const size_t& n, const size_t& d, const std::vector<int>& seeds)
+sobol(const size_t& n,
+      const size_t& d,
+      const std::vector<int>& seeds,
+      const size_t& begin)
 {
   if ((n < 1) || (d < 1)) {
     throw std::runtime_error("n and d must be at least 1.");
   }
+  SobolSequence sequence(d, seeds);
+  sequence.skip(begin);
+  return sequence.next(n);
+}
 
-  // output matrix
-  Eigen::MatrixXd output = Eigen::MatrixXd::Zero(n, d);
-
-  // L = max number of bits needed
-  size_t L =
-    static_cast<size_t>(std::ceil(log(static_cast<double>(n)) / log(2.0)));
+//! @brief Creates the sequence; it starts at the first point.
+//!
+//! @param d Dimension.
+//! @param seeds Seeds to scramble the quasi-random numbers; if empty
+//!   (default), the quasi-random number generator is seeded randomly.
+inline SobolSequence::SobolSequence(const size_t& d,
+                                    const std::vector<int>& seeds)
+  : d_(d)
+  , scrambling_(d)
+  , directions_(33 * d, 0)
+{
+  if ((d_ < 1) || (d_ > sobol_max_dim)) {
+    std::stringstream msg;
+    msg << "d must be between 1 and " << sobol_max_dim << ".";
+    throw std::runtime_error(msg.str());
+  }
 
-  // Vector of scrambling factors
-  Eigen::MatrixXd scrambling = simulate_uniform(d, 1, false, seeds);
+  Eigen::MatrixXd scrambling = simulate_uniform(d_, 1, false, seeds);
+  for (size_t j = 0; j < d_; ++j) {
+    scrambling_[j] = static_cast<uint32_t>(scrambling(j) * 4294967296.0);
+  }
 
-  // C(i) = index from the right of the first zero bit of i + 1
-  Eigen::Matrix<size_t, Eigen::Dynamic, 1> C(n);
-  C(0) = 1;
-  for (size_t i = 1; i < n; i++) {
-    C(i) = 1;
-    size_t value = i;
-    while (value & 1) {
-      value >>= 1;
-      C(i)++;
+  // the first dimension has all m's = 1
+  for (size_t k = 0; k < 32; ++k) {
+    directions_[k] = uint32_t{ 1 } << (31 - k);
+  }
+  tools_sobol::DirectionNumberReader reader;
+  size_t s, a, m[18];
+  for (size_t j = 1; j < d_; ++j) {
+    reader.next(s, a, m);
+    uint32_t* V = directions_.data() + 33 * j;
+    for (size_t k = 0; k < 32; ++k) {
+      if (k < s) {
+        V[k] = static_cast<uint32_t>(m[k] << (31 - k));
+      } else {
+        V[k] = V[k - s] ^ (V[k - s] >> s);
+        for (size_t l = 0; l < s - 1; ++l) {
+          if ((a >> (s - 2 - l)) & 1) {
+            V[k] ^= V[k - l - 1];
+          }
+        }
+      }
     }
   }
+  set_point();
+}
 
-  // Compute the first dimension
+//! @brief Simulates the next points of the sequence.
+//!
+//! @param n Number of points.
+//! @return An \f$ n \times d \f$ matrix of quasi-random
+//! \f$ \mathrm{U}[0, 1] \f$ variables.
+inline Eigen::MatrixXd
+SobolSequence::next(const size_t& n)
+{
+  if (position_ + n > (size_t{ 1 } << 32)) {
+    throw std::runtime_error("the Sobol sequence has only 2^32 points.");
+  }
 
-  // Compute direction numbers scaled by pow(2,32)
-  Eigen::Matrix<size_t, Eigen::Dynamic, 1> V(L);
-  for (size_t i = 0; i < L; i++) {
-    V(i) = static_cast<size_t>(1) << (32 - (i + 1)); // all m's = 1
+  // the Gray codes of i and i + 1 differ in the bit of the first zero of i;
+  // the same for all dimensions
+  std::vector<uint8_t> C(n);
+  for (size_t i = 0; i < n; ++i) {
+    uint8_t k = 0;
+    for (size_t value = position_ + i; value & 1; value >>= 1) {
+      ++k;
+    }
+    C[i] = k;
   }
 
-  // Evalulate X scaled by pow(2,32)
-  Eigen::Matrix<size_t, Eigen::Dynamic, 1> X(n);
-  X(0) = static_cast<size_t>(scrambling(0) * 4294967296.0);
-  for (size_t i = 1; i < n; i++) {
-    X(i) = X(i - 1) ^ V(C(i - 1) - 1);
+  Eigen::MatrixXd res(n, d_);
+  for (size_t j = 0; j < d_; ++j) {
+    const uint32_t* V = directions_.data() + 33 * j;
+    double* col = res.data() + n * j;
+    uint32_t x = point_[j];
+    for (size_t i = 0; i < n; ++i) {
+      col[i] = static_cast<double>(x) / 4294967296.0;
+      x ^= V[C[i]];
+    }
+    point_[j] = x;
   }
-  output.block(0, 0, n, 1) = X.cast<double>();
+  position_ += n;
+  return res;
+}
 
-  // Compute the remaining dimensions
-  for (size_t j = 0; j < d - 1; j++) {
+//! @brief Skips points of the sequence.
+//!
+//! @param k Number of points to skip.
+inline void
+SobolSequence::skip(const size_t& k)
+{
+  if (position_ + k > (size_t{ 1 } << 32)) {
+    throw std::runtime_error("the Sobol sequence has only 2^32 points.");
+  }
+  position_ += k;
+  set_point();
+}
 
-    // Get parameters from static vectors
-    size_t a = tools_sobol::a_sobol[j];
-    size_t s = tools_sobol::s_sobol[j];
+//! @brief The dimension of the sequence.
+inline size_t
+SobolSequence::dim() const
+{
+  return d_;
+}
 
-    Eigen::Map<Eigen::Matrix<size_t, Eigen::Dynamic, 1>> m(
-      tools_sobol::minit_sobol[j], s);
+//! @brief The index of the next point.
+inline size_t
+SobolSequence::position() const
+{
+  return position_;
+}
 
-    // Compute direction numbers scaled by pow(2,32)
-    for (size_t i = 0; i < std::min(L, s); i++)
-      V(i) = m(i) << (32 - (i + 1));
+//! computes the point at position_: the scrambling factors XORed with the
+//! direction numbers of the bits of the Gray code of position_.
+inline void
+SobolSequence::set_point()
+{
+  point_ = scrambling_;
+  const size_t gray = position_ ^ (position_ >> 1);
+  for (size_t j = 0; j < d_; ++j) {
+    const uint32_t* V = directions_.data() + 33 * j;
+    for (size_t k = 0; k < 32; ++k) {
+      if ((gray >> k) & 1) {
+        point_[j] ^= V[k];
+      }
+    }
+  }
+}
 
-    if (L > s) {
-      for (size_t i = s; i < L; i++) {
-        V(i) = V(i - s) ^ (V(i - s) >> s);
-        for (size_t k = 0; k < s - 1; k++)
-          V(i) ^= (((a >> (s - 2 - k)) & 1) * V(i - k - 1));
+//! @brief Creates the sequence; it starts at the first point.
+//!
+//! @param d Dimension.
+//! @param seeds Seeds to scramble the quasi-random numbers; if empty
+//!   (default), the quasi-random number generator is seeded randomly.
+inline GhaltonSequence::GhaltonSequence(const size_t& d,
+                                        const std::vector<int>& seeds)
+  : d_(d)
+  , base_(d)
+  , perm_(d)
+  , shift_(d * num_digits)
+  , digits_(d * num_digits)
+  , partial_(d * (num_digits + 1))
+{
+  if ((d_ < 1) || (d_ > ghalton_max_dim)) {
+    std::stringstream msg;
+    msg << "d must be between 1 and " << ghalton_max_dim << ".";
+    throw std::runtime_error(msg.str());
+  }
+
+  // coefficients of the shift
+  auto U = simulate_uniform(d_, num_digits, false, seeds);
+  for (size_t j = 0; j < d_; ++j) {
+    base_[j] = tools_ghalton::primes(j);
+    perm_[j] = tools_ghalton::permTN2(j);
+    for (size_t k = 0; k < num_digits; ++k) {
+      shift_[j * num_digits + k] =
+        static_cast<int>(static_cast<double>(base_[j]) * U(j, k));
+    }
+  }
+  set_digits();
+}
+
+//! @brief Simulates the next points of the sequence.
+//!
+//! @param n Number of points.
+//! @return An \f$ n \times d \f$ matrix of quasi-random
+//! \f$ \mathrm{U}[0, 1] \f$ variables.
+inline Eigen::MatrixXd
+GhaltonSequence::next(const size_t& n)
+{
+  Eigen::MatrixXd res(d_, n);
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < d_; ++j) {
+      res(j, i) = partial_[j * (num_digits + 1)];
+    }
+    ++position_;
+    for (size_t j = 0; j < d_; ++j) {
+      // add one and carry
+      int* digits = digits_.data() + j * num_digits;
+      size_t k = 0;
+      while ((k < num_digits - 1) && (digits[k] == base_[j] - 1)) {
+        digits[k++] = 0;
       }
+      digits[k] = (digits[k] + 1) % base_[j];
+      update(j, k);
     }
+  }
+  return res.transpose();
+}
 
-    // Evalulate X
-    X(0) = static_cast<size_t>(scrambling(j + 1) * 4294967296.0);
-    for (size_t i = 1; i < n; i++)
-      X(i) = X(i - 1) ^ V(C(i - 1) - 1);
-    output.block(0, j + 1, n, 1) = X.cast<double>();
+//! @brief Skips points of the sequence.
+//!
+//! @param k Number of points to skip.
+inline void
+GhaltonSequence::skip(const size_t& k)
+{
+  position_ += k;
+  set_digits();
+}
+
+//! @brief The dimension of the sequence.
+inline size_t
+GhaltonSequence::dim() const
+{
+  return d_;
+}
+
+//! @brief The index of the next point.
+inline size_t
+GhaltonSequence::position() const
+{
+  return position_;
+}
+
+//! computes the digits of position_ and their values from scratch.
+inline void
+GhaltonSequence::set_digits()
+{
+  for (size_t j = 0; j < d_; ++j) {
+    size_t value = position_;
+    for (size_t k = 0; k < num_digits; ++k) {
+      digits_[j * num_digits + k] = static_cast<int>(value % base_[j]);
+      value /= base_[j];
+    }
+    partial_[j * (num_digits + 1) + num_digits] = 0.0;
+    update(j, num_digits - 1);
+  }
+}
+
+//! recomputes the values of the digits k, ..., 0 of dimension j, in the order
+//! of `ghalton()`.
+inline void
+GhaltonSequence::update(const size_t& j, const size_t& k)
+{
+  const int* digits = digits_.data() + j * num_digits;
+  const int* shift = shift_.data() + j * num_digits;
+  double* partial = partial_.data() + j * (num_digits + 1);
+  const auto base = static_cast<double>(base_[j]);
+  for (size_t l = k + 1; l-- > 0;) {
+    const int tmp = (perm_[j] * digits[l] + shift[l]) % base_[j];
+    partial[l] = (partial[l + 1] + static_cast<double>(tmp)) / base;
+  }
+}
+
+//! @brief Creates the stream.
+//!
+//! @param n Total number of observations.
+//! @param d Dimension.
+//! @param qrng If true, quasi-numbers are generated.
+//! @param seeds Seeds of the random number generator; if empty (default),
+//!   the random number generator is seeded randomly.
+inline UniformStream::UniformStream(const size_t& n,
+                                    const size_t& d,
+                                    bool qrng,
+                                    std::vector<int> seeds)
+  : n_(n)
+  , d_(d)
+  , qrng_(qrng)
+{
+  if ((n_ < 1) || (d_ < 1)) {
+    throw std::runtime_error("n and d must be at least 1.");
+  }
+  if (qrng_) {
+    if (d_ > 300) {
+      sobol_ = SobolSequence(d_, seeds);
+    } else {
+      ghalton_ = GhaltonSequence(d_, seeds);
+    }
+    return;
+  }
+  if (seeds.size() == 0) {
+    // no seeds provided, seed randomly
+    std::random_device rd{};
+    seeds = std::vector<int>(20);
+    std::generate(
+      seeds.begin(), seeds.end(), [&]() { return static_cast<int>(rd()); });
   }
 
-  // Scale output by pow(2,32)
-  output /= 4294967296.0;
+  boost::random::seed_seq seq(seeds.begin(), seeds.end());
+  boost::random::mt19937 generator(seq);
+  generators_.reserve(d_);
+  for (size_t j = 0; j < d_; ++j) {
+    generators_.push_back(generator);
+    if (j + 1 < d_) {
+      generator.discard(n_);
+    }
+  }
+}
 
-  return output;
+//! @brief Simulates the next block.
+//!
+//! @param size Number of observations in the block.
+//! @return A matrix with `d` columns and `size` rows, or fewer if the stream
+//!   has less than `size` observations left.
+inline Eigen::MatrixXd
+UniformStream::next(const size_t& size)
+{
+  const size_t m = std::min(size, n_ - position_);
+  if (m == 0) {
+    return Eigen::MatrixXd(0, d_);
+  }
+  Eigen::MatrixXd u;
+  if (qrng_) {
+    u = (d_ > 300) ? sobol_.next(m) : ghalton_.next(m);
+  } else {
+    boost::random::uniform_real_distribution<double> distribution(0.0, 1.0);
+    u.resize(m, d_);
+    for (size_t j = 0; j < d_; ++j) {
+      for (size_t i = 0; i < m; ++i) {
+        u(i, j) = distribution(generators_[j]);
+      }
+    }
+  }
+  position_ += m;
+  return u;
+}
+
+//! @brief The total number of observations of the stream.
+inline size_t
+UniformStream::size() const
+{
+  return n_;
+}
+
+//! @brief The number of observations simulated so far.
+inline size_t
+UniformStream::position() const
+{
+  return position_;
 }
 
 //! @brief Computes bivariate t probabilities.
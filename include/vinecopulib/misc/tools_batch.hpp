@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <vector>
 
 namespace vinecopulib {
@@ -19,6 +21,29 @@ struct Batch
   size_t size;
 };
 
+//! @brief What one row (task) of a batched computation costs.
+//!
+//! @details Passed to `create_batches()` to size the batches by the work they
+//! carry instead of by the number of rows alone. The defaults describe cheap
+//! rows without per-row scratch memory.
+struct BatchCost
+{
+  //! work per row, in units of one vectorized pair-copula evaluation
+  double row_cost = 1.0;
+  //! scratch memory a batch allocates and reuses per row, in bytes
+  size_t row_bytes = 0;
+  //! target size of a batch's scratch memory, roughly one core's L2 cache
+  size_t cache_bytes = 256 * 1024;
+  //! least number of rows per batch, so that vectorized kernels amortize their
+  //! per-call overhead
+  size_t min_rows = 32;
+  //! least work per batch, so that scheduling overhead stays negligible
+  double min_cost = 1e4;
+  //! number of batches per thread to aim for, so that threads finishing early
+  //! can take over work from the others
+  size_t batches_per_thread = 4;
+};
+
 inline size_t
 compute_num_batches(size_t num_tasks, size_t num_threads)
 {
@@ -49,5 +74,73 @@ create_batches(size_t num_tasks, size_t num_threads)
 
   return batches;
 }
+
+//! @brief Computes the number of rows per batch for a given cost profile.
+//!
+//! @details Starts from `batches_per_thread` batches per thread (one batch
+//! when running serially), shrinks the batches until their scratch memory fits
+//! `cache_bytes`, and grows them again if they would fall below `min_rows` rows
+//! or `min_cost` work.
+//!
+//! @param num_tasks The number of rows.
+//! @param num_threads The number of threads working on the batches.
+//! @param cost The per-row cost profile.
+inline size_t
+compute_batch_size(size_t num_tasks, size_t num_threads, const BatchCost& cost)
+{
+  if (num_tasks == 0)
+    return 0;
+  num_threads = std::max(static_cast<size_t>(1), num_threads);
+
+  size_t size = num_tasks;
+  if (num_threads > 1) {
+    size_t num_batches =
+      num_threads * std::max(static_cast<size_t>(1), cost.batches_per_thread);
+    size = (num_tasks + num_batches - 1) / num_batches;
+  }
+  if (cost.row_bytes > 0) {
+    size = std::min(size, cost.cache_bytes / cost.row_bytes);
+  }
+
+  size_t min_size = cost.min_rows;
+  if (cost.row_cost > 0) {
+    min_size = std::max(
+      min_size, static_cast<size_t>(std::ceil(cost.min_cost / cost.row_cost)));
+  }
+  size = std::max(std::max(size, min_size), static_cast<size_t>(1));
+  return std::min(size, num_tasks);
+}
+
+//! @brief Splits rows into batches sized by their cost.
+//!
+//! @details The batches have (almost) equal size, as computed by
+//! `compute_batch_size()`. Unlike `create_batches(num_tasks, num_threads)`,
+//! which only looks at the number of rows, this keeps the scratch memory of
+//! expensive rows (e.g., the h-function matrices of a high-dimensional vine) in
+//! cache and avoids splitting cheap rows into batches that cost more to
+//! schedule than to compute.
+//!
+//! @param num_tasks The number of rows.
+//! @param num_threads The number of threads working on the batches.
+//! @param cost The per-row cost profile.
+inline std::vector<Batch>
+create_batches(size_t num_tasks, size_t num_threads, const BatchCost& cost)
+{
+  if (num_tasks == 0)
+    return { Batch{ 0, 0 } };
+
+  size_t size = compute_batch_size(num_tasks, num_threads, cost);
+  size_t num_batches = (num_tasks + size - 1) / size;
+  std::vector<Batch> batches(num_batches);
+
+  size_t min_size = num_tasks / num_batches;
+  size_t rem_size = num_tasks % num_batches;
+  for (size_t i = 0, k = 0; k < num_batches; k++) {
+    batches[k] = Batch{ i, min_size + (k < rem_size) };
+    i += batches[k].size;
+  }
+
+  return batches;
+}
 }
 }
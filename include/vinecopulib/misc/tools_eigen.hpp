@@ -7,7 +7,9 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <cmath>
 #include <functional>
+#include <limits>
 #include <vector>
 
 namespace vinecopulib {
@@ -43,16 +45,19 @@ unaryExpr_or_nan(const tools_eigen::ConstMatRef& x, const T& func)
   return out;
 }
 
+//! @brief Applies a bivariate function row-wise, propagating NaNs, and writes
+//! the results into `out` (of length `u.rows()`).
 template<typename T>
-Eigen::VectorXd
-binaryExpr_or_nan(const tools_eigen::ConstMatRef& u, const T& func)
+void
+binaryExpr_or_nan(const tools_eigen::ConstMatRef& u,
+                  const T& func,
+                  Eigen::Ref<Eigen::VectorXd> out)
 {
   // raw-pointer loop: coefficient access through the Ref's dynamic strides
   // is measurably slower in the hot per-element paths
   const Eigen::Index n = u.rows();
   const double* p0 = u.data();
   const double* p1 = u.data() + u.outerStride();
-  Eigen::VectorXd out(n);
   for (Eigen::Index i = 0; i < n; ++i) {
     if ((std::isnan)(p0[i]) || (std::isnan)(p1[i])) {
       out(i) = std::numeric_limits<double>::quiet_NaN();
@@ -60,9 +65,21 @@ binaryExpr_or_nan(const tools_eigen::ConstMatRef& u, const T& func)
       out(i) = func(p0[i], p1[i]);
     }
   }
+}
+
+template<typename T>
+Eigen::VectorXd
+binaryExpr_or_nan(const tools_eigen::ConstMatRef& u, const T& func)
+{
+  Eigen::VectorXd out(u.rows());
+  binaryExpr_or_nan(u, func, out);
   return out;
 }
 
+//! A parameter set of a single observation. Kept on the stack (families have
+//! at most three parameters), so that row-wise evaluation does not allocate.
+using ParameterVector = Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 8, 1>;
+
 //! @brief Applies a bivariate function row-wise with per-observation
 //! parameters, propagating NaNs.
 //!
@@ -73,21 +90,25 @@ binaryExpr_or_nan(const tools_eigen::ConstMatRef& u, const T& func)
 //! @param func A callable
 //!   `(double u1, double u2, const Eigen::Ref<const Eigen::VectorXd>& par) ->
 //!   double`.
+//! @param out A vector of length \f$ n \f$ to write the results to.
 template<typename T>
-Eigen::VectorXd
+void
 binaryExpr_or_nan(const tools_eigen::ConstMatRef& u,
                   const tools_eigen::ConstMatRef& parameters,
-                  const T& func)
+                  const T& func,
+                  Eigen::Ref<Eigen::VectorXd> out)
 {
   const Eigen::Index n = u.rows();
   const bool broadcast = (parameters.rows() == 1);
   // hoist the broadcast parameter set out of the loop so the common
   // single-parameter (state-based) path does not rebuild it on every row
-  const Eigen::VectorXd par0 =
-    broadcast ? parameters.row(0).transpose() : Eigen::VectorXd();
+  ParameterVector par0;
+  if (broadcast) {
+    par0 = parameters.row(0).transpose();
+  }
+  ParameterVector par_i(parameters.cols());
   const double* p0 = u.data();
   const double* p1 = u.data() + u.outerStride();
-  Eigen::VectorXd out(n);
   for (Eigen::Index i = 0; i < n; ++i) {
     const double u1 = p0[i];
     const double u2 = p1[i];
@@ -96,10 +117,22 @@ binaryExpr_or_nan(const tools_eigen::ConstMatRef& u,
     } else if (broadcast) {
       out(i) = func(u1, u2, par0);
     } else {
-      const Eigen::VectorXd par_i = parameters.row(i).transpose();
+      par_i = parameters.row(i).transpose();
       out(i) = func(u1, u2, par_i);
     }
   }
+}
+
+//! @brief Applies a bivariate function row-wise with per-observation
+//! parameters, propagating NaNs; see the overload writing into `out`.
+template<typename T>
+Eigen::VectorXd
+binaryExpr_or_nan(const tools_eigen::ConstMatRef& u,
+                  const tools_eigen::ConstMatRef& parameters,
+                  const T& func)
+{
+  Eigen::VectorXd out(u.rows());
+  binaryExpr_or_nan(u, parameters, func, out);
   return out;
 }
 
@@ -133,12 +166,12 @@ trim(Eigen::MatrixXd& x,
      const double& upper = 1 - 1e-10);
 
 void
-trim(Eigen::VectorXd& x,
+trim(Eigen::Ref<Eigen::VectorXd> x,
      const double& lower = 1e-10,
      const double& upper = 1 - 1e-10);
 
 bool
-check_if_in_unit_cube(const Eigen::MatrixXd& u);
+check_if_in_unit_cube(const tools_eigen::ConstMatRef& u);
 
 Eigen::MatrixXd
 swap_cols(Eigen::MatrixXd u);
@@ -146,12 +179,171 @@ swap_cols(Eigen::MatrixXd u);
 Eigen::VectorXd
 unique(const Eigen::VectorXd& x);
 
+//! computes the inverse \f$ f^{-1} \f$ of a function \f$ f \f$ by the
+//! bisection method.
+//!
+//! @param x Evaluation points.
+//! @param f The function to invert, a callable
+//!   `(const Eigen::VectorXd&) -> Eigen::VectorXd`.
+//! @param lb Lower bound.
+//! @param ub Upper bound.
+//! @param n_iter The number of iterations for the bisection (defaults to 35,
+//! guaranteeing an accuracy of 0.5^35 ~= 6e-11).
+//!
+//! @return \f$ f^{-1}(x) \f$.
+template<typename F>
 Eigen::VectorXd
 invert_f(const Eigen::VectorXd& x,
-         std::function<Eigen::VectorXd(const Eigen::VectorXd&)> f,
+         const F& f,
          const double lb = 1e-20,
          const double ub = 1 - 1e-20,
-         int n_iter = 35);
+         int n_iter = 35)
+{
+  Eigen::VectorXd xl = Eigen::VectorXd::Constant(x.size(), lb);
+  Eigen::VectorXd xh = Eigen::VectorXd::Constant(x.size(), ub);
+  Eigen::VectorXd x_tmp = x;
+  Eigen::VectorXd fm(x.size());
+  for (int iter = 0; iter < n_iter; ++iter) {
+    x_tmp = (xh + xl) / 2.0;
+    fm = f(x_tmp) - x;
+    xl = (fm.array() < 0).select(x_tmp, xl);
+    xh = (fm.array() < 0).select(xh, x_tmp);
+  }
+  for (Eigen::Index j = 0; j < x.size(); ++j) {
+    if ((std::isnan)(fm(j))) {
+      x_tmp(j) = std::numeric_limits<double>::quiet_NaN();
+    }
+  }
+
+  return x_tmp;
+}
+
+//! computes the inverse \f$ f^{-1} \f$ of a monotone increasing function
+//! \f$ f \f$ by the Illinois method, safeguarded by bisection.
+//!
+//! @details Each element keeps its own bracket \f$ [a, b] \f$ with
+//! \f$ f(a) < x < f(b) \f$. It bisects until \f$ f \f$ has been evaluated
+//! at both ends, which keeps \f$ f \f$ from being evaluated at `lb` and `ub`
+//! themselves, and then steps to the root of the secant through the ends
+//! (false position). When the same end is kept twice in a row, its function
+//! value is halved (the Illinois modification), which keeps both ends moving;
+//! when the bracket did not halve over two steps, the element bisects
+//! instead. For smooth functions this needs about half the evaluations of
+//! bisection, and never many more.
+//!
+//! Only the elements whose bracket is still wider than `tol` are evaluated,
+//! and the work buffers are allocated once, so the cost is proportional to
+//! the total number of evaluations rather than `n_iter` times the size of
+//! `x`.
+//!
+//! @param x Evaluation points (the target values of \f$ f \f$).
+//! @param eval A callable
+//!   `(const std::vector<Eigen::Index>& rows,
+//!     const Eigen::Ref<const Eigen::VectorXd>& v,
+//!     Eigen::Ref<Eigen::VectorXd> f_out)`
+//!   setting `f_out(k)` to \f$ f \f$ of element `rows[k]` at `v(k)`.
+//! @param lb Lower bound.
+//! @param ub Upper bound.
+//! @param tol Width of the bracket at which an element has converged.
+//! @param n_iter Maximum number of iterations.
+//!
+//! @return \f$ f^{-1}(x) \f$; NaN where \f$ f \f$ or \f$ x \f$ is NaN.
+//! As for bisection, elements converge to `lb` (`ub`) where \f$ f \f$ stays
+//! above (below) \f$ x \f$.
+template<typename F>
+Eigen::VectorXd
+invert_f_illinois(const Eigen::VectorXd& x,
+                  const F& eval,
+                  const double lb = 1e-20,
+                  const double ub = 1 - 1e-20,
+                  const double tol = 1e-11,
+                  int n_iter = 100)
+{
+  const Eigen::Index n = x.size();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  Eigen::VectorXd a = Eigen::VectorXd::Constant(n, lb);
+  Eigen::VectorXd b = Eigen::VectorXd::Constant(n, ub);
+  Eigen::VectorXd c(n);
+  // function values at the ends; NaN until evaluated
+  Eigen::VectorXd fa = Eigen::VectorXd::Constant(n, nan);
+  Eigen::VectorXd fb = Eigen::VectorXd::Constant(n, nan);
+  Eigen::VectorXd fc(n);
+  // bracket widths one and two steps ago, for the bisection safeguard
+  Eigen::VectorXd width1 = b - a;
+  Eigen::VectorXd width2 = 2.0 * width1;
+  // the end kept by the last step: -1 for a, 1 for b
+  std::vector<int> kept(static_cast<size_t>(n), 0);
+  std::vector<Eigen::Index> active, next;
+  active.reserve(static_cast<size_t>(n));
+  next.reserve(static_cast<size_t>(n));
+  for (Eigen::Index i = 0; i < n; ++i) {
+    active.push_back(i);
+  }
+  Eigen::VectorXd v_active(n), f_active(n);
+
+  for (int iter = 0; iter < n_iter && !active.empty(); ++iter) {
+    for (Eigen::Index i : active) {
+      const double width = b(i) - a(i);
+      double s = b(i) - fb(i) * width / (fb(i) - fa(i));
+      // NaN while an end has not been evaluated
+      if (!(s > a(i) && s < b(i)) || (width > 0.5 * width2(i))) {
+        s = 0.5 * (a(i) + b(i));
+        width1(i) = 2.0 * width;
+        width2(i) = 2.0 * width;
+      } else {
+        width2(i) = width1(i);
+        width1(i) = width;
+      }
+      c(i) = s;
+    }
+
+    // evaluate f(c) - x on the active elements
+    const auto m = static_cast<Eigen::Index>(active.size());
+    for (Eigen::Index k = 0; k < m; ++k) {
+      v_active(k) = c(active[k]);
+    }
+    eval(active, v_active.head(m), f_active.head(m));
+    for (Eigen::Index k = 0; k < m; ++k) {
+      fc(active[k]) = f_active(k) - x(active[k]);
+    }
+
+    next.clear();
+    for (Eigen::Index i : active) {
+      const auto j = static_cast<size_t>(i);
+      if ((std::isnan)(fc(i))) {
+        c(i) = nan;
+        continue;
+      } else if (fc(i) < 0.0) {
+        a(i) = c(i);
+        fa(i) = fc(i);
+        if (kept[j] == 1) {
+          fb(i) *= 0.5;
+        }
+        kept[j] = 1;
+      } else if (fc(i) > 0.0) {
+        b(i) = c(i);
+        fb(i) = fc(i);
+        if (kept[j] == -1) {
+          fa(i) *= 0.5;
+        }
+        kept[j] = -1;
+      } else {
+        continue; // exact root
+      }
+      if (b(i) - a(i) > tol) {
+        next.push_back(i);
+      } else {
+        c(i) = 0.5 * (a(i) + b(i));
+      }
+    }
+    active.swap(next);
+  }
+  for (Eigen::Index i : active) {
+    c(i) = 0.5 * (a(i) + b(i));
+  }
+
+  return c;
+}
 
 //! evaluates the function and its derivative at the active rows only.
 //! Given the still-unconverged row indices and their current values, it fills
@@ -170,6 +362,14 @@ invert_f_newton(const Eigen::VectorXd& x,
                 const double tol = 1e-10,
                 int n_iter = 50);
 
+Eigen::VectorXd
+invert_f_newton(const Eigen::VectorXd& x,
+                const NewtonEval& eval,
+                const Eigen::VectorXd& lb,
+                const Eigen::VectorXd& ub,
+                const double tol = 1e-10,
+                int n_iter = 50);
+
 Eigen::MatrixXd
 expand_grid(const Eigen::VectorXd& grid_points);
 
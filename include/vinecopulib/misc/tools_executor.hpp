@@ -0,0 +1,201 @@
+// Copyright © 2016-2026 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <vinecopulib/misc/tools_interface.hpp>
+#include <vinecopulib/misc/tools_thread_stealing.hpp>
+
+namespace vinecopulib {
+
+namespace tools_thread {
+
+//! @brief Tells a parallel method which threads to run on.
+//!
+//! @details An executor is either a thread count or a reference to a
+//! caller-owned, long-lived `ThreadPool` or `WorkStealingPool`. It is
+//! implicitly constructible from all of these, so every method taking a
+//! `num_threads` argument accepts either:
+//!
+//! ```
+//! tools_thread::ThreadPool pool(8);
+//! for (const auto& u : batches)
+//!   vc.pdf(u, pool); // workers are reused across calls
+//! vc.pdf(u, 8);      // same, on the process-wide pool
+//! ```
+//!
+//! A thread count of 0 or 1 runs everything in the calling thread. A larger
+//! count runs on the process-wide pool returned by `get_global_pool()`, with at
+//! most `num_threads` tasks in flight at once; no threads are created or joined
+//! per call.
+//!
+//! `map()` waits only for the tasks it submitted, so one pool can be shared by
+//! concurrent callers and by nested parallel sections. The calling thread works
+//! on its own tasks while it waits, which keeps nested maps from deadlocking
+//! when all workers are busy. Copies of an executor share its thread budget:
+//! when a task calls `map()` on the same executor again, the inner tasks only
+//! run on workers that the outer level leaves idle, so nested parallel
+//! sections never have more than `num_threads` tasks in flight altogether.
+class Executor
+{
+public:
+  Executor(size_t num_threads = 1);
+  Executor(ThreadPool& pool,
+           size_t num_threads = std::thread::hardware_concurrency() + 1);
+  Executor(WorkStealingPool& pool,
+           size_t num_threads = std::thread::hardware_concurrency() + 1);
+
+  //! @return the maximal number of tasks that `map()` runs concurrently
+  //! (including the calling thread); 1 means serial.
+  size_t get_num_threads() const { return num_threads_; }
+
+  template<class F, class I>
+  void map(F&& f, I&& items) const;
+
+  static ThreadPool& get_global_pool();
+
+private:
+  // submits a job to the pool; empty if running serially
+  std::function<void(std::function<void()>)> push_;
+  size_t num_threads_{ 1 };
+  // number of pool workers currently running tasks for this executor
+  std::shared_ptr<std::atomic<size_t>> num_busy_{
+    std::make_shared<std::atomic<size_t>>(0)
+  };
+};
+
+//! @brief Creates an executor from a thread count.
+//! @param num_threads The number of threads; 0 and 1 both mean that all work
+//!   is done in the calling thread.
+inline Executor::Executor(size_t num_threads)
+  : num_threads_(std::max<size_t>(1, num_threads))
+{
+  if (num_threads_ > 1) {
+    ThreadPool* pool = &get_global_pool();
+    push_ = [pool](std::function<void()> job) { pool->push(std::move(job)); };
+  }
+}
+
+//! @brief Creates an executor running on a caller-owned pool.
+//! @param pool The pool; it must outlive every call using the executor.
+//! @param num_threads The maximal number of tasks in flight at once, including
+//!   the calling thread (default: all workers plus the caller).
+inline Executor::Executor(ThreadPool& pool, size_t num_threads)
+  : push_([&pool](std::function<void()> job) { pool.push(std::move(job)); })
+  , num_threads_(std::max<size_t>(1, num_threads))
+{
+}
+
+//! @brief Creates an executor running on a caller-owned work-stealing pool.
+//! @param pool The pool; it must outlive every call using the executor.
+//! @param num_threads The maximal number of tasks in flight at once, including
+//!   the calling thread (default: all workers plus the caller).
+inline Executor::Executor(WorkStealingPool& pool, size_t num_threads)
+  : push_([&pool](std::function<void()> job) { pool.push(std::move(job)); })
+  , num_threads_(std::max<size_t>(1, num_threads))
+{
+}
+
+//! @brief The process-wide pool used by executors created from a thread count.
+//!
+//! @details Created on first use, with one worker per core, and joined at
+//! program exit.
+inline ThreadPool&
+Executor::get_global_pool()
+{
+  static ThreadPool pool(std::thread::hardware_concurrency());
+  return pool;
+}
+
+//! @brief Maps a function on a list of items and waits for all of them.
+//!
+//! @details Items are claimed one at a time by the calling thread and by the
+//! pool workers left in the executor's thread budget. Exceptions thrown by `f` are
+//! rethrown in the calling thread once all running tasks have finished; the
+//! items not yet started when the first exception occurs are skipped.
+//!
+//! @param f Function to be mapped; called once per item.
+//! @param items An object containing the items on which `f` shall be mapped;
+//!   must allow for range-based `for` loops.
+template<class F, class I>
+void
+Executor::map(F&& f, I&& items) const
+{
+  using std::begin;
+  using Item = std::decay_t<decltype(*begin(items))>;
+  std::vector<Item> jobs;
+  for (auto&& item : items)
+    jobs.push_back(item);
+
+  const size_t n = jobs.size();
+  if (!push_ || (num_threads_ == 1) || (n < 2)) {
+    for (const auto& job : jobs)
+      f(job);
+    return;
+  }
+
+  // runners still queued in the pool when map() returns only touch `state`,
+  // which they co-own; `f` and `jobs` are dereferenced only after an item has
+  // been claimed, i.e., while the caller is still waiting.
+  struct State
+  {
+    std::atomic<size_t> next{ 0 };
+    size_t done{ 0 };
+    std::mutex m;
+    std::condition_variable cv;
+    std::exception_ptr error;
+    std::atomic<bool> errored{ false };
+  };
+  auto state = std::make_shared<State>();
+  auto run = [state, n, &f, &jobs] {
+    for (size_t i = state->next++; i < n; i = state->next++) {
+      if (!state->errored) {
+        try {
+          f(jobs[i]);
+        } catch (...) {
+          std::lock_guard<std::mutex> lk(state->m);
+          if (!state->error)
+            state->error = std::current_exception();
+          state->errored = true;
+        }
+      }
+      std::lock_guard<std::mutex> lk(state->m);
+      if (++state->done == n)
+        state->cv.notify_all();
+    }
+  };
+
+  // a queued runner that starts when the budget is used up (e.g., by an outer
+  // map) leaves the items to the other runners
+  auto run_if_idle = [run, busy = num_busy_, max_busy = num_threads_ - 1] {
+    if (busy->fetch_add(1) < max_busy)
+      run();
+    busy->fetch_sub(1);
+  };
+  size_t num_runners = std::min(num_threads_, n);
+  for (size_t k = 1; k < num_runners; ++k)
+    push_(run_if_idle);
+  run();
+
+  std::unique_lock<std::mutex> lk(state->m);
+  state->cv.wait(lk, [&] { return state->done == n; });
+  if (state->error)
+    std::rethrow_exception(state->error);
+}
+
+}
+}
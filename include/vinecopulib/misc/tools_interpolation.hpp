@@ -7,6 +7,7 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <functional>
 #include <vector>
 #include <vinecopulib/misc/tools_eigen.hpp>
 
@@ -88,6 +89,39 @@ private:
   // when a shared grid is evaluated from multiple threads)
   Eigen::MatrixXd row_cum_int_;
 };
+
+//! A table of a conditional quantile function
+//!
+//! Tabulates \f$ v = F^{-1}(p \mid w) \f$ on a grid that is regular on the
+//! standard normal scale in both \f$ w \f$ and \f$ p \f$, and interpolates
+//! the normal scores of \f$ v \f$ bilinearly. For fixed \f$ w \f$, the
+//! interpolant is a convex combination of increasing functions of \f$ p \f$
+//! and therefore increasing itself. The table replaces a numerical inversion
+//! of h-functions by a few arithmetic operations per point (used by the
+//! `HinvMethod::table` modes of `Bicop`).
+class ConditionalQuantileTable
+{
+public:
+  ConditionalQuantileTable() = default;
+
+  ConditionalQuantileTable(
+    const std::function<Eigen::VectorXd(const Eigen::MatrixXd&)>& quantile,
+    size_t grid_size = 65,
+    double z_max = 5.0);
+
+  Eigen::VectorXd interpolate(const Eigen::MatrixXd& x) const;
+
+  //! @return the grid spacing on the normal scale.
+  double get_step() const { return step_; }
+
+private:
+  size_t grid_size_{ 0 };
+  double z_max_{ 0.0 };
+  double step_{ 0.0 };
+  // normal scores of the quantiles; column i belongs to the i-th grid value
+  // of w, row j to the j-th grid value of p
+  Eigen::MatrixXd scores_;
+};
 }
 }
 
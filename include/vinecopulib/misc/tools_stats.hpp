@@ -7,10 +7,15 @@
 #pragma once
 
 #include <boost/math/distributions.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <cmath>
+#include <cstdint>
 #include <memory>
 #include <set>
 #include <unsupported/Eigen/SpecialFunctions>
+#include <vinecopulib/misc/tools_constants.hpp>
 #include <vinecopulib/misc/tools_eigen.hpp>
+#include <vinecopulib/misc/tools_executor.hpp>
 
 namespace vinecopulib {
 
@@ -40,13 +45,15 @@ pnorm(const Eigen::MatrixXd& x)
   return 0.5 * (1.0 + (x.array() / sqrt2).erf());
 }
 
-//! @brief Quantile function of the Standard normal distribution.
-//!
-//! @param x Evaluation points.
+//! @brief Quantile function of the Standard normal distribution, evaluated
+//! on a raw buffer.
 //!
-//! @return An \f$ n \times d \f$ matrix of evaluated quantiles.
-inline Eigen::MatrixXd
-qnorm(const Eigen::MatrixXd& x)
+//! @param x Pointer to `n` evaluation points.
+//! @param n Number of evaluation points.
+//! @param out Pointer to `n` doubles the quantiles are written to; may alias
+//!   `x`.
+inline void
+qnorm(const double* x, Eigen::Index n, double* out)
 {
   // Inverse normal CDF. Eigen ships a fully packetized generic_ndtri
   // (internal::pndtri) but leaves packet_traits<double>::HasNdtri == 0, so
@@ -56,21 +63,29 @@ qnorm(const Eigen::MatrixXd& x)
   // elliptical evaluation paths. The scalar epilogue reuses .ndtri().
   using Packet = Eigen::internal::packet_traits<double>::type;
   constexpr Eigen::Index ps = Eigen::internal::packet_traits<double>::size;
-  Eigen::MatrixXd out(x.rows(), x.cols());
-  const Eigen::Index n = x.size();
-  const double* src = x.data();
-  double* dst = out.data();
   Eigen::Index i = 0;
   for (; i + ps <= n; i += ps) {
-    Eigen::internal::pstoreu(dst + i,
-                             Eigen::internal::pndtri<Packet>(
-                               Eigen::internal::ploadu<Packet>(src + i)));
+    Eigen::internal::pstoreu(
+      out + i,
+      Eigen::internal::pndtri<Packet>(Eigen::internal::ploadu<Packet>(x + i)));
   }
   const Eigen::Index rem = n - i;
   if (rem > 0) {
-    Eigen::Map<Eigen::ArrayXd>(dst + i, rem) =
-      Eigen::Map<const Eigen::ArrayXd>(src + i, rem).ndtri();
+    Eigen::Map<Eigen::ArrayXd>(out + i, rem) =
+      Eigen::Map<const Eigen::ArrayXd>(x + i, rem).ndtri();
   }
+}
+
+//! @brief Quantile function of the Standard normal distribution.
+//!
+//! @param x Evaluation points.
+//!
+//! @return An \f$ n \times d \f$ matrix of evaluated quantiles.
+inline Eigen::MatrixXd
+qnorm(const Eigen::MatrixXd& x)
+{
+  Eigen::MatrixXd out(x.rows(), x.cols());
+  qnorm(x.data(), x.size(), out.data());
   return out;
 }
 
@@ -83,9 +98,13 @@ qnorm(const Eigen::MatrixXd& x)
 inline Eigen::MatrixXd
 dt(const Eigen::MatrixXd& x, double nu)
 {
-  boost::math::students_t dist(nu);
-  auto f = [&dist](double y) { return boost::math::pdf(dist, y); };
-  return tools_eigen::unaryExpr_or_nan(x, f);
+  // closed form on Eigen's array functions, which run on packets, instead of
+  // a boost call per element; NaNs propagate
+  const double log_const = std::lgamma((nu + 1.0) / 2.0) -
+                           std::lgamma(nu / 2.0) -
+                           0.5 * std::log(nu * constant::pi);
+  return (log_const - (nu + 1.0) / 2.0 * (x.array().square() / nu).log1p())
+    .exp();
 }
 
 //! @brief Distribution function of the Student t distribution.
@@ -116,12 +135,67 @@ qt(const Eigen::MatrixXd& x, double nu)
   return tools_eigen::unaryExpr_or_nan(x, f);
 }
 
+//! @brief Distribution function of the Student t distribution, with one
+//! degrees of freedom parameter per row.
+//!
+//! @param x Evaluation points.
+//! @param nu Degrees of freedom parameters; `nu(i)` applies to `x.row(i)`.
+//!
+//! @return An \f$ n \times d \f$ matrix of evaluated probabilities.
+inline Eigen::MatrixXd
+pt(const Eigen::MatrixXd& x, const Eigen::VectorXd& nu)
+{
+  Eigen::MatrixXd out(x.rows(), x.cols());
+  for (Eigen::Index j = 0; j < x.cols(); ++j) {
+    for (Eigen::Index i = 0; i < x.rows(); ++i) {
+      if ((std::isnan)(x(i, j))) {
+        out(i, j) = std::numeric_limits<double>::quiet_NaN();
+      } else {
+        out(i, j) = boost::math::cdf(boost::math::students_t(nu(i)), x(i, j));
+      }
+    }
+  }
+  return out;
+}
+
+//! @brief Quantile function of the Student t distribution, with one degrees
+//! of freedom parameter per row.
+//!
+//! @param x Evaluation points.
+//! @param nu Degrees of freedom parameters; `nu(i)` applies to `x.row(i)`.
+//!
+//! @return An \f$ n \times d \f$ matrix of evaluated quantiles.
+inline Eigen::MatrixXd
+qt(const Eigen::MatrixXd& x, const Eigen::VectorXd& nu)
+{
+  Eigen::MatrixXd out(x.rows(), x.cols());
+  for (Eigen::Index j = 0; j < x.cols(); ++j) {
+    for (Eigen::Index i = 0; i < x.rows(); ++i) {
+      if ((std::isnan)(x(i, j))) {
+        out(i, j) = std::numeric_limits<double>::quiet_NaN();
+      } else {
+        out(i, j) =
+          boost::math::quantile(boost::math::students_t(nu(i)), x(i, j));
+      }
+    }
+  }
+  return out;
+}
+
 Eigen::MatrixXd
 simulate_uniform(const size_t& n,
                  const size_t& d,
                  bool qrng = false,
                  std::vector<int> seeds = std::vector<int>());
 
+Eigen::MatrixXd
+simulate_uniform_rows(const size_t& n,
+                      const size_t& d,
+                      const size_t& begin,
+                      const size_t& size,
+                      bool qrng = false,
+                      std::vector<int> seeds = std::vector<int>());
+
 Eigen::MatrixXd
 simulate_normal(const size_t& n,
                 const size_t& d,
@@ -175,15 +249,135 @@ double
 pairwise_cxi(const Eigen::MatrixXd& x,
              const Eigen::VectorXd& weights = Eigen::VectorXd());
 
+Eigen::MatrixXd
+dependence_matrix(const Eigen::MatrixXd& x,
+                  const std::string& method,
+                  const Eigen::VectorXd& weights = Eigen::VectorXd(),
+                  const tools_thread::Executor& num_threads = 1);
+
 Eigen::MatrixXd
 ghalton(const size_t& n,
         const size_t& d,
-        const std::vector<int>& seeds = std::vector<int>());
+        const std::vector<int>& seeds = std::vector<int>(),
+        const size_t& begin = 0);
 
 Eigen::MatrixXd
 sobol(const size_t& n,
       const size_t& d,
-      const std::vector<int>& seeds = std::vector<int>());
+      const std::vector<int>& seeds = std::vector<int>(),
+      const size_t& begin = 0);
+
+//! @brief A scrambled Sobol sequence generated point by point.
+//!
+//! @details Keeps the direction numbers and the current point, and steps to
+//! the next point in Gray-code order with one XOR per dimension. A sample can
+//! so be extended without generating its first points again, and `skip()`
+//! jumps to any point in \f$ O(d) \f$ operations: `next(n)` after `skip(k)`
+//! returns the points of `sobol(n, d, seeds, k)`. The sequence has
+//! \f$ 2^{32} \f$ points.
+class SobolSequence
+{
+public:
+  SobolSequence() = default;
+
+  explicit SobolSequence(const size_t& d,
+                         const std::vector<int>& seeds = std::vector<int>());
+
+  Eigen::MatrixXd next(const size_t& n);
+
+  void skip(const size_t& k);
+
+  size_t dim() const;
+
+  size_t position() const;
+
+private:
+  void set_point();
+
+  size_t d_{ 0 };
+  size_t position_{ 0 };
+  std::vector<uint32_t> scrambling_;
+  // direction number k of dimension j at 33 * j + k, scaled by 2^32; the
+  // 33rd is zero, for the step after the last point
+  std::vector<uint32_t> directions_;
+  // the point at position_, scaled by 2^32
+  std::vector<uint32_t> point_;
+};
+
+//! @brief A generalized Halton sequence generated point by point.
+//!
+//! @details Keeps the digits of the current index in each prime base, and the
+//! radical inverses of their trailing parts. Stepping to the next point only
+//! recomputes the digits changed by the increment, which is one for all but a
+//! fraction \f$ 1 / b \f$ of the points in base \f$ b \f$. `next(n)` after
+//! `skip(k)` returns the points of `ghalton(n, d, seeds, k)`.
+class GhaltonSequence
+{
+public:
+  GhaltonSequence() = default;
+
+  explicit GhaltonSequence(const size_t& d,
+                           const std::vector<int>& seeds = std::vector<int>());
+
+  Eigen::MatrixXd next(const size_t& n);
+
+  void skip(const size_t& k);
+
+  size_t dim() const;
+
+  size_t position() const;
+
+private:
+  void set_digits();
+
+  void update(const size_t& j, const size_t& k);
+
+  //! number of digits per dimension
+  static constexpr size_t num_digits = 32;
+
+  size_t d_{ 0 };
+  size_t position_{ 0 };
+  std::vector<int> base_;
+  std::vector<int> perm_;
+  // digit k of dimension j at j * num_digits + k
+  std::vector<int> shift_;
+  std::vector<int> digits_;
+  // value of the digits k, ..., num_digits - 1 of dimension j at
+  // j * (num_digits + 1) + k
+  std::vector<double> partial_;
+};
+
+//! @brief Simulates from the multivariate uniform distribution block by block.
+//!
+//! @details Stacking the blocks returned by `next()` gives the matrix
+//! `simulate_uniform(n, d, qrng, seeds)`, but only one block is held in
+//! memory at a time. `simulate_uniform()` fills its matrix column by column
+//! from a single Mersenne twister; the stream keeps one generator per column,
+//! advanced to where that column starts. The quasi-random sequences continue
+//! at the first point not yet returned.
+class UniformStream
+{
+public:
+  UniformStream(const size_t& n,
+                const size_t& d,
+                bool qrng = false,
+                std::vector<int> seeds = std::vector<int>());
+
+  Eigen::MatrixXd next(const size_t& size);
+
+  size_t size() const;
+
+  size_t position() const;
+
+private:
+  size_t n_;
+  size_t d_;
+  bool qrng_;
+  size_t position_{ 0 };
+  std::vector<boost::random::mt19937> generators_;
+  SobolSequence sobol_;
+  GhaltonSequence ghalton_;
+};
 
 Eigen::VectorXd
 pbvt(const Eigen::MatrixXd& z, int nu, double rho);
@@ -0,0 +1,316 @@
+// Copyright © 2016-2026 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#pragma once
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace vinecopulib {
+
+namespace tools_stats {
+
+//! @brief A static index counting the points of a sample that are dominated by
+//! a query point.
+//!
+//! @details A point \f$ x \f$ is dominated by \f$ q \f$ if \f$ x_j \le q_j \f$
+//! for all \f$ j \f$; the number of such points is what the empirical
+//! distribution function of the sample needs at \f$ q \f$. A linear scan costs
+//! \f$ O(N d) \f$ per query, the index answers it in \f$ O(\log N) \f$ for
+//! \f$ d = 1 \f$ and \f$ O(\log^2 N) \f$ for \f$ d = 2 \f$, where it is a
+//! Fenwick tree over the points sorted by their first coordinate whose nodes
+//! hold their second coordinates in sorted order. For \f$ d \ge 3 \f$ it is a
+//! k-d tree whose nodes store their bounding box, so that subtrees lying
+//! entirely below the query are counted, and those with a point outside of
+//! its lower orthant skipped, without visiting their points; a query then
+//! visits \f$ O(N^{1 - 1/d}) \f$ nodes.
+//!
+//! The index does not change after construction; `count()` may be called
+//! from several threads at once.
+class DominanceIndex
+{
+public:
+  DominanceIndex() = default;
+
+  explicit DominanceIndex(const Eigen::MatrixXd& points);
+
+  size_t size() const;
+
+  size_t dim() const;
+
+  Eigen::VectorXd count(const Eigen::MatrixXd& queries) const;
+
+private:
+  struct Node
+  {
+    size_t begin;
+    size_t end;
+    size_t left;  // 0 for leaves; the root is never a child
+    size_t right;
+  };
+
+  //! maximal number of points in a leaf of the k-d tree
+  static constexpr size_t leaf_size = 16;
+
+  void build_sorted(const Eigen::MatrixXd& points);
+
+  void build_tree(const Eigen::MatrixXd& points);
+
+  size_t build_node(const Eigen::MatrixXd& points,
+                    std::vector<size_t>& order,
+                    size_t begin,
+                    size_t end);
+
+  size_t count_sorted(const double* q) const;
+
+  size_t count_tree(const double* q) const;
+
+  size_t n_{ 0 };
+  size_t d_{ 0 };
+
+  // d <= 2: first coordinates in ascending order; for d = 2, the Fenwick node
+  // i (1-based) holds the sorted second coordinates of the points at sorted
+  // positions [i - lowbit(i), i) in ys_[offsets_[i - 1], offsets_[i])
+  std::vector<double> xs_;
+  std::vector<size_t> offsets_;
+  std::vector<double> ys_;
+
+  // d >= 3: points in tree order (row-major), the nodes, and their bounding
+  // boxes (lower corner, then upper corner; 2d values per node)
+  std::vector<double> points_;
+  std::vector<Node> nodes_;
+  std::vector<double> boxes_;
+};
+
+//! @brief Builds the index.
+//!
+//! @param points An \f$ N \times d \f$ matrix, one point per row.
+inline DominanceIndex::DominanceIndex(const Eigen::MatrixXd& points)
+  : n_(static_cast<size_t>(points.rows()))
+  , d_(static_cast<size_t>(points.cols()))
+{
+  if (d_ >= 1 && d_ <= 2) {
+    build_sorted(points);
+  } else {
+    build_tree(points);
+  }
+}
+
+//! @brief The number of points in the index.
+inline size_t
+DominanceIndex::size() const
+{
+  return n_;
+}
+
+//! @brief The dimension of the points in the index.
+inline size_t
+DominanceIndex::dim() const
+{
+  return d_;
+}
+
+//! @brief Counts the points dominated by each query point.
+//!
+//! @param queries An \f$ n \times d \f$ matrix, one query point per row.
+//!
+//! @return A vector of length \f$ n \f$; the count is NaN for query points
+//! containing a NaN.
+inline Eigen::VectorXd
+DominanceIndex::count(const Eigen::MatrixXd& queries) const
+{
+  if (static_cast<size_t>(queries.cols()) != d_) {
+    throw std::runtime_error("query points must have as many columns as the "
+                             "points of the index.");
+  }
+  Eigen::VectorXd counts(queries.rows());
+  std::vector<double> q(d_);
+  for (Eigen::Index i = 0; i < queries.rows(); ++i) {
+    bool has_nan = false;
+    for (size_t j = 0; j < d_; ++j) {
+      q[j] = queries(i, static_cast<Eigen::Index>(j));
+      has_nan = has_nan || (std::isnan)(q[j]);
+    }
+    if (has_nan) {
+      counts(i) = std::numeric_limits<double>::quiet_NaN();
+    } else if (d_ >= 1 && d_ <= 2) {
+      counts(i) = static_cast<double>(count_sorted(q.data()));
+    } else {
+      counts(i) = static_cast<double>(count_tree(q.data()));
+    }
+  }
+  return counts;
+}
+
+inline void
+DominanceIndex::build_sorted(const Eigen::MatrixXd& points)
+{
+  std::vector<size_t> order(n_);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&points](size_t a, size_t b) {
+    return points(a, 0) < points(b, 0);
+  });
+  xs_.resize(n_);
+  for (size_t r = 0; r < n_; ++r) {
+    xs_[r] = points(order[r], 0);
+  }
+  if (d_ == 1) {
+    return;
+  }
+
+  offsets_.resize(n_ + 1);
+  offsets_[0] = 0;
+  for (size_t i = 1; i <= n_; ++i) {
+    offsets_[i] = offsets_[i - 1] + (i & (~i + 1));
+  }
+  ys_.resize(offsets_[n_]);
+  for (size_t i = 1; i <= n_; ++i) {
+    auto first = ys_.begin() + static_cast<std::ptrdiff_t>(offsets_[i - 1]);
+    auto last = ys_.begin() + static_cast<std::ptrdiff_t>(offsets_[i]);
+    size_t r = i - (i & (~i + 1));
+    for (auto it = first; it != last; ++it, ++r) {
+      *it = points(order[r], 1);
+    }
+    std::sort(first, last);
+  }
+}
+
+inline void
+DominanceIndex::build_tree(const Eigen::MatrixXd& points)
+{
+  std::vector<size_t> order(n_);
+  std::iota(order.begin(), order.end(), 0);
+  nodes_.reserve(2 * (n_ / leaf_size + 1));
+  boxes_.reserve(nodes_.capacity() * 2 * d_);
+  build_node(points, order, 0, n_);
+
+  points_.resize(n_ * d_);
+  for (size_t r = 0; r < n_; ++r) {
+    for (size_t j = 0; j < d_; ++j) {
+      points_[r * d_ + j] = points(order[r], static_cast<Eigen::Index>(j));
+    }
+  }
+}
+
+//! builds the subtree over `order[begin:end)` and returns its node index;
+//! splits at the median of the coordinate with the widest range.
+inline size_t
+DominanceIndex::build_node(const Eigen::MatrixXd& points,
+                           std::vector<size_t>& order,
+                           size_t begin,
+                           size_t end)
+{
+  const size_t k = nodes_.size();
+  nodes_.push_back(Node{ begin, end, 0, 0 });
+
+  std::vector<double> lo(d_, std::numeric_limits<double>::infinity());
+  std::vector<double> hi(d_, -std::numeric_limits<double>::infinity());
+  for (size_t r = begin; r < end; ++r) {
+    for (size_t j = 0; j < d_; ++j) {
+      const double x = points(order[r], static_cast<Eigen::Index>(j));
+      lo[j] = std::min(lo[j], x);
+      hi[j] = std::max(hi[j], x);
+    }
+  }
+  boxes_.insert(boxes_.end(), lo.begin(), lo.end());
+  boxes_.insert(boxes_.end(), hi.begin(), hi.end());
+
+  if (end - begin <= leaf_size || d_ == 0) {
+    return k;
+  }
+  size_t split = 0;
+  for (size_t j = 1; j < d_; ++j) {
+    if (hi[j] - lo[j] > hi[split] - lo[split]) {
+      split = j;
+    }
+  }
+  if (!(hi[split] > lo[split])) {
+    return k; // all points coincide
+  }
+
+  const size_t mid = begin + (end - begin) / 2;
+  const auto col = static_cast<Eigen::Index>(split);
+  std::nth_element(order.begin() + static_cast<std::ptrdiff_t>(begin),
+                   order.begin() + static_cast<std::ptrdiff_t>(mid),
+                   order.begin() + static_cast<std::ptrdiff_t>(end),
+                   [&points, col](size_t a, size_t b) {
+                     return points(a, col) < points(b, col);
+                   });
+  const size_t left = build_node(points, order, begin, mid);
+  const size_t right = build_node(points, order, mid, end);
+  nodes_[k].left = left;
+  nodes_[k].right = right;
+  return k;
+}
+
+inline size_t
+DominanceIndex::count_sorted(const double* q) const
+{
+  const size_t k = static_cast<size_t>(
+    std::upper_bound(xs_.begin(), xs_.end(), q[0]) - xs_.begin());
+  if (d_ == 1) {
+    return k;
+  }
+  size_t count = 0;
+  for (size_t i = k; i > 0; i -= (i & (~i + 1))) {
+    auto first = ys_.begin() + static_cast<std::ptrdiff_t>(offsets_[i - 1]);
+    auto last = ys_.begin() + static_cast<std::ptrdiff_t>(offsets_[i]);
+    count += static_cast<size_t>(std::upper_bound(first, last, q[1]) - first);
+  }
+  return count;
+}
+
+inline size_t
+DominanceIndex::count_tree(const double* q) const
+{
+  if (n_ == 0) {
+    return 0;
+  }
+  // the tree is balanced, so its depth stays far below the stack size
+  size_t stack[128];
+  size_t top = 0;
+  stack[top++] = 0;
+  size_t count = 0;
+  while (top > 0) {
+    const size_t k = stack[--top];
+    const Node& node = nodes_[k];
+    const double* lo = boxes_.data() + 2 * d_ * k;
+    const double* hi = lo + d_;
+    bool outside = false;
+    bool inside = true;
+    for (size_t j = 0; j < d_ && !outside; ++j) {
+      outside = lo[j] > q[j];
+      inside = inside && (hi[j] <= q[j]);
+    }
+    if (outside) {
+      continue;
+    }
+    if (inside) {
+      count += node.end - node.begin;
+    } else if (node.left == 0) {
+      for (size_t r = node.begin; r < node.end; ++r) {
+        const double* x = points_.data() + r * d_;
+        size_t j = 0;
+        while (j < d_ && x[j] <= q[j]) {
+          ++j;
+        }
+        count += (j == d_);
+      }
+    } else {
+      stack[top++] = node.left;
+      stack[top++] = node.right;
+    }
+  }
+  return count;
+}
+}
+}
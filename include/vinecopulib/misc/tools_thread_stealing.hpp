@@ -0,0 +1,455 @@
+// Copyright © 2016-2026 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace vinecopulib {
+
+namespace tools_thread {
+
+//! @brief A single-owner, multi-thief task deque (Chase-Lev).
+//!
+//! @details The owning worker pushes and pops at the bottom without taking a
+//! lock; other workers steal from the top with a single compare-and-swap. The
+//! ring buffer grows on demand; retired buffers are kept until destruction,
+//! since a thief may still be reading from one.
+class WorkStealingDeque
+{
+public:
+  using Task = std::function<void()>;
+
+  explicit WorkStealingDeque(size_t capacity = 64);
+  ~WorkStealingDeque();
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  void push(Task* task);
+  Task* pop();
+  Task* steal();
+  bool empty() const;
+
+private:
+  struct Buffer
+  {
+    explicit Buffer(size_t capacity)
+      : mask(capacity - 1)
+      , slots(new std::atomic<Task*>[capacity])
+    {
+    }
+    size_t capacity() const { return mask + 1; }
+    Task* get(int64_t i) const
+    {
+      return slots[static_cast<size_t>(i) & mask].load(
+        std::memory_order_relaxed);
+    }
+    void put(int64_t i, Task* task)
+    {
+      slots[static_cast<size_t>(i) & mask].store(task,
+                                                  std::memory_order_relaxed);
+    }
+
+    size_t mask;
+    std::unique_ptr<std::atomic<Task*>[]> slots;
+  };
+
+  Buffer* grow(Buffer* old, int64_t bottom, int64_t top);
+
+  std::atomic<int64_t> top_{ 0 };
+  std::atomic<int64_t> bottom_{ 0 };
+  std::atomic<Buffer*> buffer_{ nullptr };
+  std::vector<std::unique_ptr<Buffer>> buffers_; // owned by the pushing thread
+};
+
+//! @param capacity Initial capacity; rounded up to a power of two.
+inline WorkStealingDeque::WorkStealingDeque(size_t capacity)
+{
+  size_t cap = 1;
+  while (cap < capacity)
+    cap <<= 1;
+  buffers_.emplace_back(new Buffer(cap));
+  buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+}
+
+//! deletes all tasks that were never run.
+inline WorkStealingDeque::~WorkStealingDeque()
+{
+  while (Task* task = this->pop())
+    delete task;
+}
+
+//! pushes a task at the bottom; must only be called by the owner.
+inline void
+WorkStealingDeque::push(Task* task)
+{
+  int64_t b = bottom_.load(std::memory_order_relaxed);
+  int64_t t = top_.load(std::memory_order_acquire);
+  Buffer* a = buffer_.load(std::memory_order_relaxed);
+  if (b - t > static_cast<int64_t>(a->capacity()) - 1)
+    a = this->grow(a, b, t);
+  a->put(b, task);
+  // publishes the task (and the job it points to) to thieves
+  bottom_.store(b + 1, std::memory_order_release);
+}
+
+//! pops the most recently pushed task; must only be called by the owner.
+//! @return the task, or `nullptr` if the deque is empty.
+inline WorkStealingDeque::Task*
+WorkStealingDeque::pop()
+{
+  int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+  Buffer* a = buffer_.load(std::memory_order_relaxed);
+  bottom_.store(b, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t t = top_.load(std::memory_order_relaxed);
+
+  Task* task = nullptr;
+  if (t <= b) {
+    task = a->get(b);
+    if (t == b) {
+      // last element: race against thieves for it
+      if (!top_.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        task = nullptr;
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+  } else {
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+  return task;
+}
+
+//! steals the least recently pushed task; may be called by any thread.
+//! @return the task, or `nullptr` if the deque is empty or the race for the
+//!   task was lost.
+inline WorkStealingDeque::Task*
+WorkStealingDeque::steal()
+{
+  int64_t t = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t b = bottom_.load(std::memory_order_acquire);
+
+  Task* task = nullptr;
+  if (t < b) {
+    Buffer* a = buffer_.load(std::memory_order_acquire);
+    task = a->get(t);
+    if (!top_.compare_exchange_strong(
+          t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      return nullptr;
+  }
+  return task;
+}
+
+//! checks whether the deque looks empty (racy; a hint for idle workers).
+inline bool
+WorkStealingDeque::empty() const
+{
+  return bottom_.load(std::memory_order_relaxed) <=
+         top_.load(std::memory_order_relaxed);
+}
+
+//! doubles the capacity of the ring buffer.
+inline WorkStealingDeque::Buffer*
+WorkStealingDeque::grow(Buffer* old, int64_t bottom, int64_t top)
+{
+  buffers_.emplace_back(new Buffer(2 * old->capacity()));
+  Buffer* a = buffers_.back().get();
+  for (int64_t i = top; i < bottom; ++i)
+    a->put(i, old->get(i));
+  buffer_.store(a, std::memory_order_release);
+  return a;
+}
+
+//! @brief A thread pool whose workers each own a task deque and steal from
+//! each other when they run dry.
+//!
+//! @details Drop-in for `ThreadPool` (`push()`, `map()`, `wait()`, `join()`).
+//! Jobs pushed from a worker (e.g., from a nested parallel section) go to that
+//! worker's own deque without taking a lock; jobs pushed from outside the pool
+//! go to a shared injection queue. Idle workers first drain their own deque,
+//! then the injection queue, then steal from the others; they only sleep when
+//! all of these are empty. Compared to `ThreadPool`, which serializes every
+//! push and pop on one mutex, this removes the contention between many
+//! workers processing many small jobs.
+class WorkStealingPool
+{
+public:
+  WorkStealingPool(WorkStealingPool&&) = delete;
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool();
+  explicit WorkStealingPool(size_t nWorkers);
+
+  ~WorkStealingPool() noexcept;
+
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(WorkStealingPool&& other) = delete;
+
+  template<class F, class... Args>
+  void push(F&& f, Args&&... args);
+
+  template<class F, class I>
+  void map(F&& f, I&& items);
+
+  void wait();
+  void join();
+
+  size_t get_num_workers() const { return workers_.size(); }
+
+private:
+  using Task = WorkStealingDeque::Task;
+
+  void start_worker(size_t w);
+  Task* find_task(size_t w);
+  void do_job(Task* task);
+  void notify_workers();
+  void register_worker(size_t w);
+  int current_worker() const;
+
+  struct WorkerId
+  {
+    const WorkStealingPool* pool{ nullptr };
+    int index{ -1 };
+  };
+  static WorkerId& worker_id();
+
+  std::vector<std::thread> workers_;
+  std::vector<std::unique_ptr<WorkStealingDeque>> deques_;
+
+  // jobs pushed from outside the pool
+  std::mutex m_injected_;
+  std::queue<Task*> injected_;
+
+  // sleeping workers and the queued/unfinished job counters they watch
+  std::mutex m_sleep_;
+  std::condition_variable cv_tasks_;
+  std::condition_variable cv_done_;
+  std::atomic<size_t> num_queued_{ 0 };
+  std::atomic<size_t> num_pending_{ 0 };
+  std::atomic<size_t> num_sleeping_{ 0 };
+  std::atomic<bool> stopped_{ false };
+
+  std::mutex m_error_;
+  std::exception_ptr error_ptr_;
+};
+
+//! constructs a pool with as many workers as there are cores.
+inline WorkStealingPool::WorkStealingPool()
+  : WorkStealingPool(std::thread::hardware_concurrency())
+{
+}
+
+//! constructs a pool with `nWorkers` workers.
+//! @param nWorkers Number of worker threads to create; if `nWorkers = 0`, all
+//!    work pushed to the pool will be done in the calling thread.
+inline WorkStealingPool::WorkStealingPool(size_t nWorkers)
+{
+  for (size_t w = 0; w < nWorkers; ++w)
+    deques_.emplace_back(new WorkStealingDeque());
+  for (size_t w = 0; w < nWorkers; ++w)
+    this->start_worker(w);
+}
+
+//! destructor runs the remaining jobs and joins all threads.
+inline WorkStealingPool::~WorkStealingPool() noexcept
+{
+  try {
+    this->join();
+  } catch (...) {
+  }
+  while (!injected_.empty()) {
+    delete injected_.front();
+    injected_.pop();
+  }
+}
+
+//! pushes jobs to the pool.
+//! @param f A function taking an arbitrary number of arguments.
+//! @param args A comma-seperated list of the other arguments that shall
+//!   be passed to `f`.
+template<class F, class... Args>
+void
+WorkStealingPool::push(F&& f, Args&&... args)
+{
+  if (workers_.empty()) {
+    f(args...); // if there are no workers, do the job in the calling thread
+    return;
+  }
+  if (stopped_)
+    throw std::runtime_error("cannot push to joined thread pool");
+
+  auto task =
+    new Task(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+  ++num_pending_;
+  ++num_queued_;
+  int w = this->current_worker();
+  if (w >= 0) {
+    deques_[static_cast<size_t>(w)]->push(task);
+  } else {
+    std::lock_guard<std::mutex> lk(m_injected_);
+    injected_.push(task);
+  }
+  this->notify_workers();
+}
+
+//! maps a function on a list of items, possibly running tasks in parallel.
+//! @param f Function to be mapped.
+//! @param items An objects containing the items on which `f` shall be
+//!   mapped; must allow for `auto` loops.
+template<class F, class I>
+void
+WorkStealingPool::map(F&& f, I&& items)
+{
+  for (auto&& item : items)
+    this->push(f, item);
+}
+
+//! waits for all jobs to finish, but does not join the threads; rethrows the
+//! first exception thrown by a job since the last call.
+inline void
+WorkStealingPool::wait()
+{
+  {
+    std::unique_lock<std::mutex> lk(m_sleep_);
+    cv_done_.wait(lk, [this] { return num_pending_ == 0; });
+  }
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lk(m_error_);
+    std::swap(error, error_ptr_);
+  }
+  if (error)
+    std::rethrow_exception(error);
+}
+
+//! waits for all jobs to finish and joins all threads.
+inline void
+WorkStealingPool::join()
+{
+  if (stopped_)
+    return;
+  this->wait();
+  {
+    std::lock_guard<std::mutex> lk(m_sleep_);
+    stopped_ = true;
+  }
+  cv_tasks_.notify_all();
+  for (auto& worker : workers_) {
+    if (worker.joinable())
+      worker.join();
+  }
+}
+
+//! marks the calling thread as the worker owning deque `w`.
+inline void
+WorkStealingPool::register_worker(size_t w)
+{
+  worker_id() = WorkerId{ this, static_cast<int>(w) };
+}
+
+//! the index of the calling worker, or -1 if called from outside the pool.
+inline int
+WorkStealingPool::current_worker() const
+{
+  // a worker of another pool pushing here uses the injection queue
+  const WorkerId& id = worker_id();
+  return (id.pool == this) ? id.index : -1;
+}
+
+//! the pool and deque owned by the calling thread, if any.
+inline WorkStealingPool::WorkerId&
+WorkStealingPool::worker_id()
+{
+  static thread_local WorkerId id;
+  return id;
+}
+
+//! spawns a worker thread owning the deque `w`.
+inline void
+WorkStealingPool::start_worker(size_t w)
+{
+  workers_.emplace_back([this, w] {
+    this->register_worker(w);
+    while (true) {
+      if (Task* task = this->find_task(w)) {
+        this->do_job(task);
+        continue;
+      }
+      std::unique_lock<std::mutex> lk(m_sleep_);
+      ++num_sleeping_;
+      cv_tasks_.wait_for(lk, std::chrono::milliseconds(100), [this] {
+        return stopped_ || (num_queued_ > 0);
+      });
+      --num_sleeping_;
+      if (stopped_ && (num_queued_ == 0))
+        break;
+    }
+  });
+}
+
+//! looks for a job: own deque first, then the injection queue, then steals.
+inline WorkStealingPool::Task*
+WorkStealingPool::find_task(size_t w)
+{
+  Task* task = deques_[w]->pop();
+  if (!task && (num_queued_ > 0)) {
+    std::lock_guard<std::mutex> lk(m_injected_);
+    if (!injected_.empty()) {
+      task = injected_.front();
+      injected_.pop();
+    }
+  }
+  for (size_t k = 1; !task && (k < deques_.size()) && (num_queued_ > 0); ++k)
+    task = deques_[(w + k) % deques_.size()]->steal();
+  if (task)
+    --num_queued_;
+  return task;
+}
+
+//! executes a job safely and signals when the pool runs out of work.
+inline void
+WorkStealingPool::do_job(Task* task)
+{
+  try {
+    (*task)();
+  } catch (...) {
+    std::lock_guard<std::mutex> lk(m_error_);
+    if (!error_ptr_)
+      error_ptr_ = std::current_exception();
+  }
+  delete task;
+  if (--num_pending_ == 0) {
+    std::lock_guard<std::mutex> lk(m_sleep_);
+    cv_done_.notify_all();
+  }
+}
+
+//! wakes up a sleeping worker, if there is one.
+inline void
+WorkStealingPool::notify_workers()
+{
+  // num_queued_ was incremented before; a worker increments num_sleeping_
+  // before checking num_queued_, so one of the two sees the other
+  if (num_sleeping_ > 0) {
+    std::lock_guard<std::mutex> lk(m_sleep_);
+    cv_tasks_.notify_one();
+  }
+}
+
+}
+}
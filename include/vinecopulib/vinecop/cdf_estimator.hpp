@@ -0,0 +1,91 @@
+// Copyright © 2016-2026 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#pragma once
+
+#include <Eigen/Dense>
+#include <vector>
+#include <vinecopulib/misc/tools_executor.hpp>
+#include <vinecopulib/misc/tools_stats_dominance.hpp>
+#include <vinecopulib/vinecop/class.hpp>
+
+namespace vinecopulib {
+
+//! @brief Estimated values of a distribution function and their standard
+//! errors, as returned by `VinecopCdfEstimator::estimate()`.
+struct CdfEstimate
+{
+  //! estimated distribution function values
+  Eigen::VectorXd value;
+  //! standard errors of the estimates; NaN if there is only one replicate
+  Eigen::VectorXd std_error;
+};
+
+//! @brief A reusable quasi Monte Carlo estimator of the distribution function
+//! of a vine copula model.
+//!
+//! @details `Vinecop::cdf()` simulates a new quasi-random sample on every call.
+//! The estimator simulates once and answers any number of queries from the
+//! stored sample, which it keeps in `tools_stats::DominanceIndex`es.
+//!
+//! The sample consists of replicates of `N` points each, from independently
+//! scrambled quasi-random sequences. The estimate is the average of the
+//! replicates' empirical distribution functions, and their spread gives its
+//! standard error (randomized quasi Monte Carlo). `refine()` adds replicates,
+//! so the accuracy can be increased without discarding the points simulated
+//! so far.
+//!
+//! The first replicate is scrambled with the seeds as given, so with one
+//! replicate the estimates are those of `Vinecop::cdf()` with the same `N` and
+//! seeds. The estimator is a snapshot of the model: later changes to the
+//! `Vinecop` it was created from do not affect it.
+//!
+//! ```
+//! VinecopCdfEstimator estimator(vc, 10000, 4, 1, { 1 });
+//! auto p = estimator.cdf(u);
+//! auto res = estimator.estimate(u); // res.value, res.std_error
+//! estimator.refine(4);              // now eight replicates
+//! ```
+class VinecopCdfEstimator
+{
+public:
+  explicit VinecopCdfEstimator(
+    const Vinecop& vinecop,
+    const size_t N = 10000,
+    const size_t num_replicates = 4,
+    const tools_thread::Executor& num_threads = 1,
+    const std::vector<int>& seeds = std::vector<int>());
+
+  void refine(const size_t num_replicates = 1,
+              const tools_thread::Executor& num_threads = 1);
+
+  Eigen::VectorXd cdf(const Eigen::MatrixXd& u,
+                      const tools_thread::Executor& num_threads = 1) const;
+
+  CdfEstimate estimate(const Eigen::MatrixXd& u,
+                       const tools_thread::Executor& num_threads = 1) const;
+
+  //! @return the dimension of the model.
+  size_t get_dim() const { return vinecop_.get_dim(); }
+
+  //! @return the number of points per replicate.
+  size_t get_num_points() const { return N_; }
+
+  //! @return the number of replicates.
+  size_t get_num_replicates() const { return replicates_.size(); }
+
+private:
+  Eigen::MatrixXd count(const Eigen::MatrixXd& u,
+                        const tools_thread::Executor& num_threads) const;
+
+  Vinecop vinecop_;
+  size_t N_;
+  std::vector<int> seeds_;
+  std::vector<tools_stats::DominanceIndex> replicates_;
+};
+}
+
+#include <vinecopulib/vinecop/implementation/cdf_estimator.ipp>
@@ -7,7 +7,10 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <functional>
 #include <utility>
+#include <vinecopulib/misc/tools_batch.hpp>
+#include <vinecopulib/misc/tools_executor.hpp>
 #include <vinecopulib/vinecop/fit_controls.hpp>
 #include <vinecopulib/vinecop/rvine_structure.hpp>
 
@@ -15,6 +18,8 @@ namespace vinecopulib {
 
 // forward declarations
 class Bicop;
+class CompiledVinecop;
+class VinecopCdfEstimator;
 namespace tools_select {
 class VinecopSelector;
 }
@@ -25,6 +30,10 @@ class VinecopSelector;
 //! `RVineStructure` objects) and the pair-copulas (see `Bicop` objects).
 class Vinecop
 {
+  friend class CompiledVinecop;
+  friend class VinecopCdfEstimator;
+  friend class VinecopEnsemble;
+
 public:
   // default constructors
   Vinecop() = default;
@@ -69,7 +78,7 @@ public:
 
   void fit(const Eigen::MatrixXd& data,
            const FitControlsBicop& controls = FitControlsBicop(),
-           const size_t num_threads = 1);
+           const tools_thread::Executor& num_threads = 1);
 
   // Getters for a single pair copula
 
@@ -156,7 +165,10 @@ public:
   double get_mbicv(const double psi0 = 0.9) const;
 
   // Stats methods
-  Eigen::VectorXd pdf(Eigen::MatrixXd u, const size_t num_threads = 1) const;
+  Eigen::VectorXd pdf(Eigen::MatrixXd u,
+                      const tools_thread::Executor& num_threads = 1) const;
+  Eigen::VectorXd logpdf(Eigen::MatrixXd u,
+                         const tools_thread::Executor& num_threads = 1) const;
 
   //! @brief The density together with the per-edge quantities computed on the
   //! way, as returned by `pdf_full()`.
@@ -176,62 +188,82 @@ public:
   };
 
   PdfWithHfuncsResult pdf_full(Eigen::MatrixXd u,
-                               const size_t num_threads = 1,
+                               const tools_thread::Executor& num_threads = 1,
                                const bool keep_all = true) const;
 
+  void pdf_full_blocks(
+    const Eigen::MatrixXd& u,
+    const size_t block_size,
+    const std::function<void(const PdfWithHfuncsResult&, size_t)>& sink,
+    const tools_thread::Executor& num_threads = 1) const;
+
   // Stats methods with per-observation parameters. `parameters` is an
   // n x npars matrix, one full-vine parameter vector per observation, with
   // columns in the (tree, edge, parameter) order of scores(). Continuous,
   // all-parametric models only.
   Eigen::VectorXd pdf(Eigen::MatrixXd u,
                       const Eigen::MatrixXd& parameters,
-                      const size_t num_threads = 1) const;
+                      const tools_thread::Executor& num_threads = 1) const;
+  Eigen::VectorXd logpdf(Eigen::MatrixXd u,
+                         const Eigen::MatrixXd& parameters,
+                         const tools_thread::Executor& num_threads = 1) const;
 
   PdfWithHfuncsResult pdf_full(Eigen::MatrixXd u,
                                const Eigen::MatrixXd& parameters,
-                               const size_t num_threads = 1,
+                               const tools_thread::Executor& num_threads = 1,
                                const bool keep_all = true) const;
 
   Eigen::VectorXd cdf(const Eigen::MatrixXd& u,
                       const size_t N = 10000,
-                      const size_t num_threads = 1,
+                      const tools_thread::Executor& num_threads = 1,
                       const std::vector<int>& seeds = std::vector<int>()) const;
 
   Eigen::MatrixXd simulate(
     const size_t n,
     const bool qrng = false,
-    const size_t num_threads = 1,
+    const tools_thread::Executor& num_threads = 1,
+    const std::vector<int>& seeds = std::vector<int>()) const;
+
+  void simulate_blocks(
+    const size_t n,
+    const size_t block_size,
+    const std::function<void(const Eigen::MatrixXd&, size_t)>& sink,
+    const bool qrng = false,
+    const tools_thread::Executor& num_threads = 1,
     const std::vector<int>& seeds = std::vector<int>()) const;
 
   Eigen::MatrixXd simulate_conditional(
     const Eigen::MatrixXd& u_cond,
     const bool qrng = false,
-    const size_t num_threads = 1,
+    const tools_thread::Executor& num_threads = 1,
     const std::vector<int>& seeds = std::vector<int>()) const;
   Eigen::MatrixXd simulate_conditional(
     const Eigen::MatrixXd& u_cond,
     const std::vector<size_t>& conditioning_set,
     const bool qrng = false,
-    const size_t num_threads = 1,
+    const tools_thread::Executor& num_threads = 1,
     const std::vector<int>& seeds = std::vector<int>()) const;
 
   void reorient(const std::vector<size_t>& conditioning_set);
 
   Eigen::MatrixXd rosenblatt(Eigen::MatrixXd u,
-                             const size_t num_threads = 1,
+                             const tools_thread::Executor& num_threads = 1,
                              bool randomize_discrete = true,
                              std::vector<int> seeds = {}) const;
   Eigen::MatrixXd rosenblatt(Eigen::MatrixXd u,
                              const std::vector<size_t>& conditioning_set,
-                             const size_t num_threads = 1,
+                             const tools_thread::Executor& num_threads = 1,
                              bool randomize_discrete = true,
                              std::vector<int> seeds = {}) const;
-  Eigen::MatrixXd inverse_rosenblatt(const Eigen::MatrixXd& u,
-                                     const size_t num_threads = 1) const;
+  Eigen::MatrixXd inverse_rosenblatt(
+    const Eigen::MatrixXd& u,
+    const tools_thread::Executor& num_threads = 1) const;
   Eigen::MatrixXd inverse_rosenblatt(
     const Eigen::MatrixXd& u,
     const std::vector<size_t>& conditioning_set,
-    const size_t num_threads = 1) const;
+    const tools_thread::Executor& num_threads = 1) const;
+
+  CompiledVinecop compile() const;
 
   //! Sets every pair copula in one shot.
   //! @param pair_copulas nested list of `Bicop` instances, shaped like
@@ -247,6 +279,12 @@ public:
   //! continuous or `"d"` for discrete).
   std::vector<std::string> get_var_types() const;
 
+  //! Sets the method for inverting h-functions that have no closed form in
+  //! all pair copulas; see `HinvMethod`. Speeds up `simulate()` and
+  //! `inverse_rosenblatt()` for models with Frank, BB or Tawn pair copulas.
+  //! @param method the method.
+  void set_hinv_method(const HinvMethod method);
+
   // Fit statistics
   //! @return the total number of parameters across all pair copulas.
   //! For nonparametric families, this is a conceptually similar
@@ -254,23 +292,23 @@ public:
   double get_npars() const;
 
   double loglik(const Eigen::MatrixXd& u = Eigen::MatrixXd(),
-                const size_t num_threads = 1) const;
+                const tools_thread::Executor& num_threads = 1) const;
 
   //! Log-likelihood with per-observation parameters (see the per-observation
   //! `pdf()` overload for the `parameters` layout and restrictions).
   double loglik(const Eigen::MatrixXd& u,
                 const Eigen::MatrixXd& parameters,
-                const size_t num_threads = 1) const;
+                const tools_thread::Executor& num_threads = 1) const;
 
   double aic(const Eigen::MatrixXd& u = Eigen::MatrixXd(),
-             const size_t num_threads = 1) const;
+             const tools_thread::Executor& num_threads = 1) const;
 
   double bic(const Eigen::MatrixXd& u = Eigen::MatrixXd(),
-             const size_t num_threads = 1) const;
+             const tools_thread::Executor& num_threads = 1) const;
 
   double mbicv(const Eigen::MatrixXd& u = Eigen::MatrixXd(),
                const double psi0 = 0.9,
-               const size_t num_threads = 1) const;
+               const tools_thread::Executor& num_threads = 1) const;
 
   // Misc methods
   static std::vector<std::vector<Bicop>> make_pair_copula_store(
@@ -302,24 +340,24 @@ public:
 
   ScoresResult scores_full(Eigen::MatrixXd u,
                            bool step_wise = true,
-                           const size_t num_threads = 1,
+                           const tools_thread::Executor& num_threads = 1,
                            const bool keep_all = true);
   Eigen::MatrixXd scores(Eigen::MatrixXd u,
                          bool step_wise = true,
-                         const size_t num_threads = 1);
+                         const tools_thread::Executor& num_threads = 1);
   Eigen::VectorXd gradient(Eigen::MatrixXd u,
                            bool step_wise = true,
-                           const size_t num_threads = 1);
+                           const tools_thread::Executor& num_threads = 1);
   Eigen::MatrixXd hessian(Eigen::MatrixXd u,
                           bool step_wise = true,
-                          const size_t num_threads = 1);
+                          const tools_thread::Executor& num_threads = 1);
   TriangularArray<std::vector<Eigen::MatrixXd>> hessian_full(
     Eigen::MatrixXd u,
     bool step_wise = true,
-    const size_t num_threads = 1);
+    const tools_thread::Executor& num_threads = 1);
   Eigen::MatrixXd scores_cov(Eigen::MatrixXd u,
                              bool step_wise = true,
-                             const size_t num_threads = 1);
+                             const tools_thread::Executor& num_threads = 1);
 
   // Scores, gradient, and Hessian with per-observation parameters. `parameters`
   // is an n x npars matrix, one full-vine parameter vector per observation,
@@ -328,29 +366,29 @@ public:
   ScoresResult scores_full(Eigen::MatrixXd u,
                            const Eigen::MatrixXd& parameters,
                            bool step_wise = true,
-                           const size_t num_threads = 1,
+                           const tools_thread::Executor& num_threads = 1,
                            const bool keep_all = true);
   Eigen::MatrixXd scores(Eigen::MatrixXd u,
                          const Eigen::MatrixXd& parameters,
                          bool step_wise = true,
-                         const size_t num_threads = 1);
+                         const tools_thread::Executor& num_threads = 1);
   Eigen::VectorXd gradient(Eigen::MatrixXd u,
                            const Eigen::MatrixXd& parameters,
                            bool step_wise = true,
-                           const size_t num_threads = 1);
+                           const tools_thread::Executor& num_threads = 1);
   Eigen::MatrixXd hessian(Eigen::MatrixXd u,
                           const Eigen::MatrixXd& parameters,
                           bool step_wise = true,
-                          const size_t num_threads = 1);
+                          const tools_thread::Executor& num_threads = 1);
   TriangularArray<std::vector<Eigen::MatrixXd>> hessian_full(
     Eigen::MatrixXd u,
     const Eigen::MatrixXd& parameters,
     bool step_wise = true,
-    const size_t num_threads = 1);
+    const tools_thread::Executor& num_threads = 1);
   Eigen::MatrixXd scores_cov(Eigen::MatrixXd u,
                              const Eigen::MatrixXd& parameters,
                              bool step_wise = true,
-                             const size_t num_threads = 1);
+                             const tools_thread::Executor& num_threads = 1);
 
 private:
   struct ReorientationMap
@@ -382,16 +420,17 @@ private:
     const std::vector<size_t>& conditioning_set,
     const VinecopView& view,
     bool qrng,
-    size_t num_threads,
+    const tools_thread::Executor& num_threads,
     const std::vector<int>& seeds) const;
   Eigen::MatrixXd rosenblatt_impl(Eigen::MatrixXd u,
                                   const VinecopView& view,
-                                  size_t num_threads,
+                                  const tools_thread::Executor& num_threads,
                                   bool randomize_discrete,
                                   std::vector<int> seeds) const;
-  Eigen::MatrixXd inverse_rosenblatt_impl(const Eigen::MatrixXd& u,
-                                          const VinecopView& view,
-                                          size_t num_threads) const;
+  Eigen::MatrixXd inverse_rosenblatt_impl(
+    const Eigen::MatrixXd& u,
+    const VinecopView& view,
+    const tools_thread::Executor& num_threads) const;
 
   // Per-edge derivative caches shared by the analytic score/gradient/Hessian
   // cascades. One forward walk over the vine (build_deriv_cache) fills them;
@@ -495,7 +534,19 @@ protected:
   bool is_discrete() const;
   Eigen::MatrixXd collapse_data(const Eigen::MatrixXd& u) const;
   void collapse_data_inplace(Eigen::MatrixXd& u) const;
+  tools_batch::BatchCost get_batch_cost(size_t trunc_lvl,
+                                        size_t scratch_cols) const;
+  // `pdf_full()` on the log scale if `log_scale`: `pdf` (and `pdf_edges`) then
+  // hold log-densities, accumulated as sums
+  PdfWithHfuncsResult pdf_full_impl(Eigen::MatrixXd u,
+                                    const Eigen::MatrixXd& parameters,
+                                    const tools_thread::Executor& num_threads,
+                                    const bool keep_all,
+                                    const bool log_scale) const;
 };
 }
 
 #include <vinecopulib/vinecop/implementation/class.ipp>
+#include <vinecopulib/vinecop/compiled.hpp>
+#include <vinecopulib/vinecop/cdf_estimator.hpp>
+#include <vinecopulib/vinecop/ensemble.hpp>
@@ -0,0 +1,193 @@
+// Copyright © 2016-2026 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#pragma once
+
+#include <Eigen/Dense>
+#include <vector>
+#include <vinecopulib/bicop/class.hpp>
+#include <vinecopulib/misc/tools_executor.hpp>
+#include <vinecopulib/vinecop/class.hpp>
+
+namespace vinecopulib {
+
+//! @brief Scratch memory for the allocation-free overloads of
+//! `CompiledVinecop`.
+//!
+//! @details Holds the intermediate h-functions of an evaluation. The buffers
+//! are sized on first use and kept afterwards, so a loop evaluating batches of
+//! the same shape does not allocate after its first iteration. A workspace can
+//! be used with any plan, but not by several threads at once.
+class VinecopWorkspace
+{
+public:
+  VinecopWorkspace() = default;
+
+private:
+  friend class CompiledVinecop;
+
+  void resize(Eigen::Index n, size_t d);
+
+  Eigen::MatrixXd hfunc1_;
+  Eigen::MatrixXd hfunc2_;
+  Eigen::MatrixXd hfunc1_next_;
+  Eigen::MatrixXd hfunc2_next_;
+  Eigen::MatrixXd result_;
+  Eigen::MatrixXd u_e_;
+  Eigen::VectorXd edge_;
+};
+
+//! @brief An immutable evaluation plan for a continuous vine copula model.
+//!
+//! @details Created by `Vinecop::compile()`. The plan resolves everything
+//! `Vinecop::pdf()` and friends look up on every call once: which h-functions
+//! feed each edge and which of them are needed later, the rotation of each
+//! pair copula (as argument swap and flip flags), which h-function leaf it
+//! maps to, and the parameters in the layout the families' kernels take. The
+//! edges of each tree are grouped by family and evaluated directly on the
+//! family kernels, without the per-call checks and dispatch of `Bicop`.
+//!
+//! The plan is a snapshot: later changes to the `Vinecop` it was compiled from
+//! do not affect it. It can be shared by concurrent callers. Results agree
+//! with the corresponding `Vinecop` methods up to rounding.
+//!
+//! ```
+//! auto plan = vc.compile();
+//! for (const auto& u : batches)
+//!   ll += plan.loglik(u);
+//! ```
+//!
+//! The overloads taking a `VinecopWorkspace` write into caller-provided
+//! buffers and run in the calling thread. Once the workspace has seen a batch
+//! of the same shape, they do not allocate for the Gaussian, Clayton, Gumbel,
+//! Frank, Joe, and independence families; other families fall back to
+//! temporary vectors.
+//!
+//! ```
+//! VinecopWorkspace ws;
+//! Eigen::VectorXd out(n);
+//! for (const auto& u : batches)
+//!   plan.logpdf(u, out, ws);
+//! ```
+class CompiledVinecop
+{
+public:
+  explicit CompiledVinecop(const Vinecop& vinecop);
+
+  //! @return the dimension of the model.
+  size_t get_dim() const { return d_; }
+
+  Eigen::VectorXd pdf(const Eigen::MatrixXd& u,
+                      const tools_thread::Executor& num_threads = 1) const;
+
+  Eigen::VectorXd logpdf(const Eigen::MatrixXd& u,
+                         const tools_thread::Executor& num_threads = 1) const;
+
+  void pdf(const Eigen::Ref<const Eigen::MatrixXd>& u,
+           Eigen::Ref<Eigen::VectorXd> out,
+           VinecopWorkspace& workspace) const;
+
+  void logpdf(const Eigen::Ref<const Eigen::MatrixXd>& u,
+              Eigen::Ref<Eigen::VectorXd> out,
+              VinecopWorkspace& workspace) const;
+
+  double loglik(const Eigen::MatrixXd& u,
+                const tools_thread::Executor& num_threads = 1) const;
+
+  Eigen::MatrixXd rosenblatt(
+    const Eigen::MatrixXd& u,
+    const tools_thread::Executor& num_threads = 1) const;
+
+  void rosenblatt(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                  Eigen::Ref<Eigen::MatrixXd> out,
+                  VinecopWorkspace& workspace) const;
+
+  Eigen::MatrixXd inverse_rosenblatt(
+    const Eigen::MatrixXd& u,
+    const tools_thread::Executor& num_threads = 1) const;
+
+private:
+  void check_data(const Eigen::Ref<const Eigen::MatrixXd>& u) const;
+
+  void check_output(Eigen::Index rows,
+                    Eigen::Index cols,
+                    Eigen::Index expected_rows,
+                    Eigen::Index expected_cols) const;
+
+  Eigen::VectorXd density(const Eigen::MatrixXd& u,
+                          const tools_thread::Executor& num_threads,
+                          bool log_scale) const;
+
+  void density_block(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                     Eigen::Ref<Eigen::VectorXd> out,
+                     VinecopWorkspace& workspace,
+                     bool log_scale) const;
+
+  void rosenblatt_block(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                        Eigen::Ref<Eigen::MatrixXd> out,
+                        VinecopWorkspace& workspace) const;
+
+  void load_arguments(size_t k,
+                      const Eigen::MatrixXd& hfunc1,
+                      const Eigen::MatrixXd& hfunc2,
+                      Eigen::MatrixXd& u_e) const;
+
+  void prepare_arguments(size_t k, Eigen::MatrixXd& u_e) const;
+
+  void eval_pdf(size_t k,
+                const Eigen::MatrixXd& u_e,
+                Eigen::Ref<Eigen::VectorXd> out) const;
+
+  void eval_logpdf(size_t k,
+                   const Eigen::MatrixXd& u_e,
+                   Eigen::Ref<Eigen::VectorXd> out) const;
+
+  void eval_hfunc(size_t k,
+                  bool first,
+                  const Eigen::MatrixXd& u_e,
+                  Eigen::Ref<Eigen::VectorXd> out) const;
+
+  Eigen::VectorXd eval_hinv2(size_t k, const Eigen::MatrixXd& u_e) const;
+
+  size_t d_;
+  size_t trunc_lvl_;
+  // variable (0-based column of the data) at each position of the natural
+  // order
+  std::vector<size_t> order_;
+  std::vector<size_t> inverse_order_;
+  tools_batch::BatchCost pdf_cost_;
+  tools_batch::BatchCost inverse_rosenblatt_cost_;
+
+  // Edges, flattened tree by tree and grouped by family within each tree.
+  // Edges of tree t occupy [tree_begin_[t], tree_begin_[t + 1]).
+  std::vector<size_t> tree_begin_;
+  // position of edge (t, e) in the flat arrays
+  std::vector<std::vector<size_t>> position_;
+  std::vector<size_t> edge_;
+  // column of the second argument, read from hfunc2 if `arg2_from_hfunc2_`
+  // and from hfunc1 otherwise; the first argument is hfunc2's column `edge_`
+  std::vector<size_t> arg2_col_;
+  std::vector<char> arg2_from_hfunc2_;
+  std::vector<char> needs_hfunc1_;
+  std::vector<char> needs_hfunc2_;
+  std::vector<char> is_indep_;
+  // rotation as: swap the arguments, then flip (u -> 1 - u) either of them
+  std::vector<char> swap_;
+  std::vector<char> flip1_;
+  std::vector<char> flip2_;
+  // whether h1 (h2, hinv2) maps to the kernel's first function, and whether
+  // the result is complemented (1 - h)
+  std::vector<char> h1_use_first_;
+  std::vector<char> h1_complement_;
+  std::vector<char> h2_use_first_;
+  std::vector<char> h2_complement_;
+  std::vector<BicopPtr> kernels_;
+  // 1 x p parameter rows, as taken by the kernels
+  std::vector<Eigen::MatrixXd> parameters_;
+};
+}
+
+#include <vinecopulib/vinecop/implementation/compiled.ipp>
@@ -0,0 +1,115 @@
+// Copyright © 2016-2026 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#pragma once
+
+#include <Eigen/Dense>
+#include <vector>
+#include <vinecopulib/misc/tools_batch.hpp>
+#include <vinecopulib/misc/tools_executor.hpp>
+#include <vinecopulib/vinecop/class.hpp>
+
+namespace vinecopulib {
+
+//! @brief Evaluates several vine copula models on the same data in one pass.
+//!
+//! @details Comparing or averaging many fitted models calls `Vinecop::pdf()`
+//! once per model, and every call prepares the data and computes each tree's
+//! h-functions anew. The ensemble plans the evaluation of all models at once.
+//! Models with the same variable order and types start from the same inputs,
+//! and models that also agree on their first trees (same edges and pair
+//! copulas) share the h-functions of these trees, which are then computed
+//! once. The shared trees form a prefix tree: a model's density is the product
+//! along the path from the root to its last tree.
+//!
+//! The work is split into batches of rows and, within each batch, into the
+//! subtrees of distinct first trees, which run concurrently. The densities
+//! are those of `Vinecop::pdf()` and `Vinecop::logpdf()` for each model. The
+//! ensemble is a snapshot: later changes to the models it was created from do
+//! not affect it.
+//!
+//! ```
+//! VinecopEnsemble ensemble(models);
+//! Eigen::MatrixXd p = ensemble.pdf(u, 4);    // one column per model
+//! Eigen::VectorXd ll = ensemble.loglik(u, 4);
+//! ```
+class VinecopEnsemble
+{
+public:
+  explicit VinecopEnsemble(const std::vector<Vinecop>& vinecops);
+
+  Eigen::MatrixXd pdf(const Eigen::MatrixXd& u,
+                      const tools_thread::Executor& num_threads = 1) const;
+
+  Eigen::MatrixXd logpdf(const Eigen::MatrixXd& u,
+                         const tools_thread::Executor& num_threads = 1) const;
+
+  Eigen::VectorXd loglik(const Eigen::MatrixXd& u,
+                         const tools_thread::Executor& num_threads = 1) const;
+
+  //! @return the dimension of the models.
+  size_t get_dim() const { return d_; }
+
+  //! @return the number of models.
+  size_t size() const { return vinecops_.size(); }
+
+  //! @return the number of trees evaluated per row; without sharing, this
+  //! would be the sum of the models' truncation levels.
+  size_t get_num_tree_evaluations() const
+  {
+    return nodes_.size() - roots_.size();
+  }
+
+private:
+  // A node of the plan. Roots stand for a variable order and variable types
+  // and evaluate nothing; a node at depth t > 0 evaluates tree t - 1 of
+  // `model`, which all models below it share.
+  struct Node
+  {
+    size_t model;
+    size_t depth;
+    // whether some model below the node needs the h-functions of an edge
+    std::vector<char> needs_hfunc1;
+    std::vector<char> needs_hfunc2;
+    // models whose last tree is the node's
+    std::vector<size_t> done;
+    std::vector<size_t> children;
+  };
+
+  // h-functions of the trees evaluated so far for a batch of rows, and the
+  // density accumulated along the path
+  struct State
+  {
+    Eigen::MatrixXd hfunc1;
+    Eigen::MatrixXd hfunc2;
+    Eigen::MatrixXd hfunc1_sub;
+    Eigen::MatrixXd hfunc2_sub;
+    Eigen::VectorXd pdf;
+  };
+
+  void build_node(size_t k, const std::vector<size_t>& models);
+
+  bool same_tree(size_t a, size_t b, size_t tree) const;
+
+  Eigen::MatrixXd density(const Eigen::MatrixXd& u,
+                          const tools_thread::Executor& num_threads,
+                          bool log_scale) const;
+
+  void evaluate_node(size_t k,
+                     State& state,
+                     const tools_batch::Batch& b,
+                     Eigen::MatrixXd& out,
+                     bool log_scale) const;
+
+  size_t d_;
+  std::vector<Vinecop> vinecops_;
+  std::vector<Node> nodes_;
+  std::vector<size_t> roots_;
+  size_t max_depth_{ 0 };
+};
+}
+
+#include <vinecopulib/vinecop/implementation/ensemble.ipp>
@@ -110,6 +110,10 @@ public:
   //! unconditional selection.
   std::vector<size_t> get_conditioning_set() const;
 
+  //! @return the number of observations on which the tree criteria are
+  //! screened before computing them exactly (`0` disables screening).
+  size_t get_screening_size() const;
+
   boost::random::mt19937 get_rng() const;
 
   // Setters
@@ -149,6 +153,16 @@ public:
   //! `Vinecop::simulate_conditional()`); empty for unconditional selection.
   void set_conditioning_set(std::vector<size_t> conditioning_set);
 
+  //! Sets the number of observations used to screen the candidate edges of
+  //! the structure selection. When the data has more observations, the tree
+  //! criteria are first estimated on a subsample of this size, and computed
+  //! on all observations only for edges that may still enter the spanning
+  //! tree. Applies to `"mst_prim"` and `"mst_kruskal"` with a built-in
+  //! `tree_criterion`.
+  //! @param screening_size the subsample size; `0` (default) disables
+  //! screening.
+  void set_screening_size(size_t screening_size);
+
   // Misc
   std::string str() const;
 
@@ -167,6 +181,7 @@ private:
   std::string tree_algorithm_ = "mst_prim";
   std::vector<int> seeds_;
   std::vector<size_t> conditioning_set_ = {};
+  size_t screening_size_ = 0;
   boost::random::mt19937 rng_;
 
   void check_tree_criterion(std::string tree_criterion);
@@ -174,6 +189,8 @@ private:
   void check_threshold(double threshold);
 
   void check_conditioning_set(const std::vector<size_t>& conditioning_set);
+
+  void check_screening_size(size_t screening_size);
 };
 }
 
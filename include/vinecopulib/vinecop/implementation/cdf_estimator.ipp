@@ -0,0 +1,132 @@
+// Copyright © 2016-2026 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vinecopulib/misc/tools_batch.hpp>
+#include <vinecopulib/misc/tools_interface.hpp>
+
+namespace vinecopulib {
+
+//! @brief Simulates the replicates of the estimator.
+//!
+//! @param vinecop The vine copula model.
+//! @param N Number of quasi-random points per replicate.
+//! @param num_replicates Number of independently scrambled replicates; at
+//!   least two are needed for standard errors.
+//! @param num_threads The number of threads to use for simulating.
+//! @param seeds Seeds to scramble the quasi-random numbers; if empty (default),
+//!   each replicate is scrambled randomly.
+inline VinecopCdfEstimator::VinecopCdfEstimator(
+  const Vinecop& vinecop,
+  const size_t N,
+  const size_t num_replicates,
+  const tools_thread::Executor& num_threads,
+  const std::vector<int>& seeds)
+  : vinecop_(vinecop)
+  , N_(N)
+  , seeds_(seeds)
+{
+  if (vinecop_.get_dim() > 21201) {
+    std::stringstream message;
+    message << "cumulative distribution available for models of "
+            << "dimension 21201 or less. This model's dimension: "
+            << vinecop_.get_dim() << std::endl;
+    throw std::runtime_error(message.str().c_str());
+  }
+  if (N_ == 0 || num_replicates == 0) {
+    throw std::runtime_error("N and num_replicates must be positive.");
+  }
+  this->refine(num_replicates, num_threads);
+}
+
+//! @brief Adds replicates to the estimator.
+//!
+//! @details Replicate \f$ r > 0 \f$ is scrambled with the seeds followed by
+//! \f$ r \f$, so refining an estimator is reproducible and gives the same
+//! replicates as asking for all of them up front.
+//!
+//! @param num_replicates Number of replicates to add.
+//! @param num_threads The number of threads to use for simulating.
+inline void
+VinecopCdfEstimator::refine(const size_t num_replicates,
+                            const tools_thread::Executor& num_threads)
+{
+  for (size_t k = 0; k < num_replicates; ++k) {
+    std::vector<int> seeds = seeds_;
+    if (!replicates_.empty() && !seeds.empty()) {
+      seeds.push_back(static_cast<int>(replicates_.size()));
+    }
+    replicates_.emplace_back(vinecop_.simulate(N_, true, num_threads, seeds));
+  }
+}
+
+//! @brief Estimates the copula distribution function.
+//!
+//! @param u An \f$ n \times d \f$ matrix of evaluation points, in the layouts
+//!   taken by `Vinecop::cdf()`.
+//! @param num_threads The number of threads to use for computations.
+//! @return A vector of length `n` containing the estimates.
+inline Eigen::VectorXd
+VinecopCdfEstimator::cdf(const Eigen::MatrixXd& u,
+                         const tools_thread::Executor& num_threads) const
+{
+  return this->count(u, num_threads).rowwise().mean() /
+         static_cast<double>(N_);
+}
+
+//! @brief Estimates the copula distribution function and the standard errors
+//! of the estimates.
+//!
+//! @details The standard error is the standard deviation of the replicates'
+//! estimates divided by the square root of their number.
+//!
+//! @param u An \f$ n \times d \f$ matrix of evaluation points, in the layouts
+//!   taken by `Vinecop::cdf()`.
+//! @param num_threads The number of threads to use for computations.
+inline CdfEstimate
+VinecopCdfEstimator::estimate(const Eigen::MatrixXd& u,
+                              const tools_thread::Executor& num_threads) const
+{
+  Eigen::MatrixXd p = this->count(u, num_threads) / static_cast<double>(N_);
+  const auto r = static_cast<double>(p.cols());
+  CdfEstimate res;
+  res.value = p.rowwise().mean();
+  if (p.cols() < 2) {
+    res.std_error = Eigen::VectorXd::Constant(
+      p.rows(), std::numeric_limits<double>::quiet_NaN());
+  } else {
+    Eigen::MatrixXd centered = p.colwise() - res.value;
+    res.std_error =
+      (centered.rowwise().squaredNorm() / (r - 1.0) / r).array().sqrt();
+  }
+  return res;
+}
+
+//! counts the points of each replicate (columns) below each evaluation point
+//! (rows).
+inline Eigen::MatrixXd
+VinecopCdfEstimator::count(const Eigen::MatrixXd& u,
+                           const tools_thread::Executor& num_threads) const
+{
+  vinecop_.check_data(u);
+  const size_t d = vinecop_.get_dim();
+  const size_t n = static_cast<size_t>(u.rows());
+  Eigen::MatrixXd counts(n, replicates_.size());
+  auto do_batch = [&](const tools_batch::Batch& b) {
+    tools_interface::check_user_interrupt();
+    const Eigen::MatrixXd ub = u.block(b.begin, 0, b.size, d);
+    for (size_t r = 0; r < replicates_.size(); ++r) {
+      counts.block(b.begin, r, b.size, 1) = replicates_[r].count(ub);
+    }
+  };
+  num_threads.map(
+    do_batch, tools_batch::create_batches(n, num_threads.get_num_threads()));
+  return counts;
+}
+}
@@ -9,6 +9,7 @@
 #include <vinecopulib/misc/tools_interface.hpp>
 #include <vinecopulib/misc/tools_serialization.hpp>
 #include <vinecopulib/misc/tools_stats.hpp>
+#include <vinecopulib/misc/tools_stats_dominance.hpp>
 #include <vinecopulib/misc/tools_stl.hpp>
 #include <vinecopulib/vinecop/tools_select.hpp>
 
@@ -621,7 +622,7 @@ Vinecop::reorient(const std::vector<size_t>& conditioning_set)
 inline void
 Vinecop::fit(const Eigen::MatrixXd& data,
              const FitControlsBicop& controls,
-             const size_t num_threads)
+             const tools_thread::Executor& num_threads)
 {
   check_data(data);
   auto u = collapse_data(data);
@@ -656,9 +657,6 @@ Vinecop::fit(const Eigen::MatrixXd& data,
     hfunc2_sub = hfunc2;
   }
 
-  // set up thread pool
-  tools_thread::ThreadPool pool((num_threads == 1) ? 0 : num_threads);
-
   // fill first row of hfunc2 matrix with observed data;
   // points have to be reordered to correspond to natural order
   for (size_t j = 0; j < d_; ++j) {
@@ -670,13 +668,6 @@ Vinecop::fit(const Eigen::MatrixXd& data,
 
   for (size_t tree = 0; tree < trunc_lvl; ++tree) {
     tools_interface::check_user_interrupt();
-    // scale down the per-fit thread budget: the edges of this tree already
-    // run concurrently on the pool, so nested threading would oversubscribe
-    FitControlsBicop tree_controls = controls;
-    if (num_threads > 1) {
-      tree_controls.set_num_threads(
-        std::max<size_t>(1, num_threads / std::max<size_t>(1, d_ - tree - 1)));
-    }
     auto fit_edge = [&](size_t edge) {
       tools_interface::check_user_interrupt(edge % 5 == 0);
       // extract evaluation point from hfunction matrices (have been
@@ -703,7 +694,7 @@ Vinecop::fit(const Eigen::MatrixXd& data,
         }
       }
 
-      edge_copula->fit(u_e, tree_controls);
+      edge_copula->fit(u_e, controls);
 
       // h-functions are only evaluated if needed in next tree
       if (rvine_structure_.needed_hfunc1(tree, edge)) {
@@ -724,10 +715,8 @@ Vinecop::fit(const Eigen::MatrixXd& data,
       }
     };
 
-    pool.map(fit_edge, tools_stl::seq_int(0, d_ - tree - 1));
-    pool.wait();
+    num_threads.map(fit_edge, tools_stl::seq_int(0, d_ - tree - 1));
   }
-  pool.join();
 
   loglik_ = 0, nobs_ = n;
   for (size_t tree = 0; tree < trunc_lvl; ++tree) {
@@ -1055,6 +1044,16 @@ Vinecop::set_var_types(const std::vector<std::string>& var_types)
   set_var_types_internal(var_types);
 }
 
+inline void
+Vinecop::set_hinv_method(const HinvMethod method)
+{
+  for (auto& tree : pair_copulas_) {
+    for (auto& pc : tree) {
+      pc.set_hinv_method(method);
+    }
+  }
+}
+
 //! @brief Sets all pair-copulas.
 inline void
 Vinecop::set_all_pair_copulas(
@@ -1156,9 +1155,14 @@ Vinecop::get_var_types() const
 //!   left-limit columns for continuous variables may be omitted to obtain the
 //!   compact \f$ n \times (d + k) \f$ layout (see @ref discrete).
 //! @param num_threads The number of threads to use for computations; if greater
-//!   than 1, the function will be applied concurrently to `num_threads` batches
-//!   of `u`.
+//!   than 1, the function will be applied concurrently to batches of `u`. When
+//!   `u` has too few rows to give every thread a batch, the edges of each tree
+//!   are evaluated concurrently as well.
+//!   Also accepts a `tools_thread::ThreadPool` to run on (see
+//!   `tools_thread::Executor`), so that workers are reused across calls.
 //! @param keep_all Whether to keep and return per-edge pdfs and h-functions.
+//!   These take \f$ O(n d^2) \f$ memory; `pdf_full_blocks()` produces them
+//!   in blocks of rows instead.
 //! @return A struct containing:
 //!   - `pdf`: the copula density evaluated at `u`.
 //! If `keep_all = true`, the struct also contains the following fields:
@@ -1176,12 +1180,56 @@ Vinecop::get_var_types() const
 //!   left-sided limits), if at least one variable is discrete.
 inline Vinecop::PdfWithHfuncsResult
 Vinecop::pdf_full(Eigen::MatrixXd u,
-                  const size_t num_threads,
+                  const tools_thread::Executor& num_threads,
                   const bool keep_all) const
 {
   return pdf_full(std::move(u), Eigen::MatrixXd(), num_threads, keep_all);
 }
 
+//! @brief Evaluates the copula density and the per-edge quantities in blocks
+//! of bounded size.
+//!
+//! @details Computes `pdf_full(u, num_threads, true)` block by block of rows
+//! and passes each block's result to `sink`, so that the per-edge densities
+//! and h-functions are held in memory for one block at a time. The sink can
+//! keep the trees or edges it needs, aggregate them, or store them in a
+//! smaller type, e.g., to accumulate the log-likelihood of each tree:
+//!
+//! ```
+//! std::vector<double> tree_loglik(vc.get_trunc_lvl(), 0.0);
+//! vc.pdf_full_blocks(u, 10000, [&](const auto& block, size_t) {
+//!   for (size_t t = 0; t < tree_loglik.size(); ++t) {
+//!     for (size_t e = 0; e < vc.get_dim() - t - 1; ++e) {
+//!       tree_loglik[t] += block.pdf_edges(t, e).array().log().sum();
+//!     }
+//!   }
+//! }, 4);
+//! ```
+//!
+//! @param u Evaluation points, see `pdf_full()`.
+//! @param block_size Number of rows per block; the last block may be smaller.
+//! @param sink A function called with each block's result (see `pdf_full()`)
+//!   and the index of its first row in `u`, in order.
+//! @param num_threads The number of threads to use for computations within
+//!   each block, see `pdf_full()`.
+inline void
+Vinecop::pdf_full_blocks(
+  const Eigen::MatrixXd& u,
+  const size_t block_size,
+  const std::function<void(const PdfWithHfuncsResult&, size_t)>& sink,
+  const tools_thread::Executor& num_threads) const
+{
+  if (block_size == 0) {
+    throw std::runtime_error("block_size must be positive.");
+  }
+  check_data(u);
+  const size_t n = static_cast<size_t>(u.rows());
+  for (size_t begin = 0; begin < n; begin += block_size) {
+    const size_t size = std::min(block_size, n - begin);
+    sink(pdf_full(u.middleRows(begin, size), num_threads, true), begin);
+  }
+}
+
 //! @brief Evaluates the copula density (and per-edge quantities) with
 //! per-observation parameters.
 //!
@@ -1193,8 +1241,18 @@ Vinecop::pdf_full(Eigen::MatrixXd u,
 inline Vinecop::PdfWithHfuncsResult
 Vinecop::pdf_full(Eigen::MatrixXd u,
                   const Eigen::MatrixXd& parameters,
-                  const size_t num_threads,
+                  const tools_thread::Executor& num_threads,
                   const bool keep_all) const
+{
+  return pdf_full_impl(std::move(u), parameters, num_threads, keep_all, false);
+}
+
+inline Vinecop::PdfWithHfuncsResult
+Vinecop::pdf_full_impl(Eigen::MatrixXd u,
+                       const Eigen::MatrixXd& parameters,
+                       const tools_thread::Executor& num_threads,
+                       const bool keep_all,
+                       const bool log_scale) const
 {
   check_data(u);
   collapse_data_inplace(u);
@@ -1240,12 +1298,44 @@ Vinecop::pdf_full(Eigen::MatrixXd u,
     }
   }
 
-  // initial value must be 1.0 for multiplication
-  result.pdf = Eigen::VectorXd::Constant(u.rows(), 1.0);
+  // initial value must be 1.0 for multiplication (0.0 for summation on the
+  // log scale)
+  result.pdf = Eigen::VectorXd::Constant(u.rows(), log_scale ? 0.0 : 1.0);
+
+  if (trunc_lvl == 0) {
+    return result;
+  }
+
+  // scratch per row: the h-function matrices (and their discrete
+  // counterparts) plus the edge's arguments and results
+  auto cost = get_batch_cost(trunc_lvl, (discrete ? 4 : 2) * d_ + 8);
+  auto batches =
+    tools_batch::create_batches(u.rows(), num_threads.get_num_threads(), cost);
+
+  // When there are fewer row batches than threads (few rows, many variables),
+  // the edges within each tree are evaluated concurrently as well. They only
+  // depend on the previous tree's h-functions, so a tree is one wavefront: its
+  // edges read from one copy of the h-function matrices, write to another, and
+  // the copies are swapped once all edges are done.
+  const bool edge_parallel = (batches.size() < num_threads.get_num_threads()) &&
+                             (d_ - 1 > batches.size());
+
+  // column offset of each edge's parameters within the flat (tree, edge,
+  // parameter) order of `parameters` (per-observation path only)
+  std::vector<std::vector<size_t>> par_offsets(trunc_lvl);
+  if (per_obs) {
+    size_t par_offset = 0;
+    for (size_t tree = 0; tree < trunc_lvl; ++tree) {
+      for (const auto& pc : pair_copulas_[tree]) {
+        par_offsets[tree].push_back(par_offset);
+        par_offset += static_cast<size_t>(pc.get_parameters().size());
+      }
+    }
+  }
 
   auto do_batch = [&](const tools_batch::Batch& b) {
     // temporary storage objects (all data must be in (0, 1))
-    Eigen::MatrixXd hfunc1, hfunc2, u_e, hfunc1_sub, hfunc2_sub, u_e_sub;
+    Eigen::MatrixXd hfunc1, hfunc2, hfunc1_sub, hfunc2_sub;
     hfunc1 = Eigen::MatrixXd::Zero(b.size, d_);
     hfunc2 = Eigen::MatrixXd::Zero(b.size, d_);
     if (discrete) {
@@ -1263,14 +1353,27 @@ Vinecop::pdf_full(Eigen::MatrixXd u,
       }
     }
 
-    // running column offset of the current edge's parameters within the flat
-    // (tree, edge, parameter) order of `parameters` (per-observation path only)
-    size_t par_offset = 0;
+    // h-functions of the current tree in wavefront mode; otherwise, the edges
+    // run in order and overwrite columns no later edge of the tree reads
+    Eigen::MatrixXd hfunc1_next, hfunc2_next, hfunc1_sub_next, hfunc2_sub_next;
+    Eigen::MatrixXd tree_pdfs;
+    if (edge_parallel) {
+      hfunc1_next = hfunc1;
+      hfunc2_next = hfunc2;
+      hfunc1_sub_next = hfunc1_sub;
+      hfunc2_sub_next = hfunc2_sub;
+    }
+    Eigen::MatrixXd& hfunc1_out = edge_parallel ? hfunc1_next : hfunc1;
+    Eigen::MatrixXd& hfunc2_out = edge_parallel ? hfunc2_next : hfunc2;
+    Eigen::MatrixXd& hfunc1_sub_out =
+      edge_parallel ? hfunc1_sub_next : hfunc1_sub;
+    Eigen::MatrixXd& hfunc2_sub_out =
+      edge_parallel ? hfunc2_sub_next : hfunc2_sub;
 
     for (size_t tree = 0; tree < trunc_lvl; ++tree) {
       tools_interface::check_user_interrupt(
         static_cast<double>(u.rows()) * static_cast<double>(d_) > 1e5);
-      for (size_t edge = 0; edge < d_ - tree - 1; ++edge) {
+      auto do_edge = [&](size_t edge) {
         tools_interface::check_user_interrupt(edge % 100 == 0);
         // extract evaluation point from hfunction matrices (have been
         // computed in previous tree level)
@@ -1278,7 +1381,7 @@ Vinecop::pdf_full(Eigen::MatrixXd u,
         auto var_types = edge_copula->get_var_types();
         size_t m = rvine_structure_.min_array(tree, edge);
 
-        u_e.resize(b.size, 2);
+        Eigen::MatrixXd u_e(b.size, 2), u_e_sub;
         u_e.col(0) = hfunc2.col(edge);
         if (m == rvine_structure_.struct_array(tree, edge, true)) {
           u_e.col(1) = hfunc2.col(m - 1);
@@ -1304,10 +1407,14 @@ Vinecop::pdf_full(Eigen::MatrixXd u,
         Eigen::MatrixXd pars_e;
         if (per_obs) {
           size_t np = static_cast<size_t>(edge_copula->get_parameters().size());
-          pars_e = parameters.block(b.begin, par_offset, b.size, np);
-          par_offset += np;
+          pars_e =
+            parameters.block(b.begin, par_offsets[tree][edge], b.size, np);
         }
         auto ec_pdf = [&]() {
+          if (log_scale) {
+            return per_obs ? edge_copula->logpdf(u_e, pars_e)
+                           : edge_copula->logpdf(u_e);
+          }
           return per_obs ? edge_copula->pdf(u_e, pars_e)
                          : edge_copula->pdf(u_e);
         };
@@ -1321,24 +1428,30 @@ Vinecop::pdf_full(Eigen::MatrixXd u,
         };
 
         Eigen::VectorXd edge_pdf = ec_pdf();
-        result.pdf.segment(b.begin, b.size) =
-          result.pdf.segment(b.begin, b.size).cwiseProduct(edge_pdf);
+        if (edge_parallel) {
+          tree_pdfs.col(edge) = edge_pdf;
+        } else if (log_scale) {
+          result.pdf.segment(b.begin, b.size) += edge_pdf;
+        } else {
+          result.pdf.segment(b.begin, b.size) =
+            result.pdf.segment(b.begin, b.size).cwiseProduct(edge_pdf);
+        }
 
         // h-functions are only evaluated if needed in next step
         if (rvine_structure_.needed_hfunc1(tree, edge)) {
-          hfunc1.col(edge) = ec_hfunc1();
+          hfunc1_out.col(edge) = ec_hfunc1();
           if (var_types[1] == "d") {
             u_e_sub = u_e;
             u_e_sub.col(1) = u_e.col(3);
-            hfunc1_sub.col(edge) = edge_copula->hfunc1(u_e_sub);
+            hfunc1_sub_out.col(edge) = edge_copula->hfunc1(u_e_sub);
           }
         }
         if (rvine_structure_.needed_hfunc2(tree, edge)) {
-          hfunc2.col(edge) = ec_hfunc2();
+          hfunc2_out.col(edge) = ec_hfunc2();
           if (var_types[0] == "d") {
             u_e_sub = u_e;
             u_e_sub.col(0) = u_e.col(2);
-            hfunc2_sub.col(edge) = edge_copula->hfunc2(u_e_sub);
+            hfunc2_sub_out.col(edge) = edge_copula->hfunc2(u_e_sub);
           }
         }
 
@@ -1346,30 +1459,46 @@ Vinecop::pdf_full(Eigen::MatrixXd u,
           result.pdf_edges(tree, edge).segment(b.begin, b.size) = edge_pdf;
           if (rvine_structure_.needed_hfunc1(tree, edge)) {
             result.hfunc1(tree, edge).segment(b.begin, b.size) =
-              hfunc1.col(edge);
+              hfunc1_out.col(edge);
             if (discrete) {
               result.hfunc1_sub(tree, edge).segment(b.begin, b.size) =
-                hfunc1_sub.col(edge);
+                hfunc1_sub_out.col(edge);
             }
           }
           if (rvine_structure_.needed_hfunc2(tree, edge)) {
             result.hfunc2(tree, edge).segment(b.begin, b.size) =
-              hfunc2.col(edge);
+              hfunc2_out.col(edge);
             if (discrete) {
               result.hfunc2_sub(tree, edge).segment(b.begin, b.size) =
-                hfunc2_sub.col(edge);
+                hfunc2_sub_out.col(edge);
             }
           }
         }
+      };
+
+      if (edge_parallel) {
+        tree_pdfs.resize(b.size, d_ - tree - 1);
+        num_threads.map(do_edge, tools_stl::seq_int(0, d_ - tree - 1));
+        if (log_scale) {
+          result.pdf.segment(b.begin, b.size) += tree_pdfs.rowwise().sum();
+        } else {
+          result.pdf.segment(b.begin, b.size) =
+            result.pdf.segment(b.begin, b.size).cwiseProduct(
+              tree_pdfs.rowwise().prod());
+        }
+        hfunc1.swap(hfunc1_next);
+        hfunc2.swap(hfunc2_next);
+        hfunc1_sub.swap(hfunc1_sub_next);
+        hfunc2_sub.swap(hfunc2_sub_next);
+      } else {
+        for (size_t edge = 0; edge < d_ - tree - 1; ++edge) {
+          do_edge(edge);
+        }
       }
     }
   };
 
-  if (trunc_lvl > 0) {
-    tools_thread::ThreadPool pool((num_threads == 1) ? 0 : num_threads);
-    pool.map(do_batch, tools_batch::create_batches(u.rows(), num_threads));
-    pool.join();
-  }
+  num_threads.map(do_batch, batches);
 
   return result;
 }
@@ -1397,9 +1526,11 @@ Vinecop::pdf_full(Eigen::MatrixXd u,
 //! @param num_threads The number of threads to use for computations; if greater
 //!   than 1, the function will be applied concurrently to `num_threads` batches
 //!   of `u`.
+//!   Also accepts a `tools_thread::ThreadPool` to run on (see
+//!   `tools_thread::Executor`), so that workers are reused across calls.
 //! @return A vector of length `n` containing the copula density values.
 inline Eigen::VectorXd
-Vinecop::pdf(Eigen::MatrixXd u, const size_t num_threads) const
+Vinecop::pdf(Eigen::MatrixXd u, const tools_thread::Executor& num_threads) const
 {
   return pdf_full(std::move(u), num_threads, false).pdf;
 }
@@ -1411,11 +1542,45 @@ Vinecop::pdf(Eigen::MatrixXd u, const size_t num_threads) const
 inline Eigen::VectorXd
 Vinecop::pdf(Eigen::MatrixXd u,
              const Eigen::MatrixXd& parameters,
-             const size_t num_threads) const
+             const tools_thread::Executor& num_threads) const
 {
   return pdf_full(std::move(u), parameters, num_threads, false).pdf;
 }
 
+//! @brief Evaluates the logarithm of the copula density.
+//!
+//! @details Equivalent to `pdf(u).array().log()`, but sums the log-densities
+//! of the pair copulas instead of multiplying their densities, so it does not
+//! underflow (or overflow) in high dimensions. Pair copulas with a closed-form
+//! log-density (e.g., Gaussian, Student, Clayton, Gumbel, Frank, Joe) skip the
+//! round trip through `exp()` and `log()`.
+//!
+//! @param u Evaluation points, see `pdf()`.
+//! @param num_threads The number of threads to use for computations, see
+//!   `pdf()`.
+//! @return A vector of length `n` containing the copula log-density values.
+inline Eigen::VectorXd
+Vinecop::logpdf(Eigen::MatrixXd u,
+                const tools_thread::Executor& num_threads) const
+{
+  auto result =
+    pdf_full_impl(std::move(u), Eigen::MatrixXd(), num_threads, false, true);
+  return result.pdf;
+}
+
+//! @brief Evaluates the logarithm of the copula density with per-observation
+//! parameters.
+//!
+//! @details See `logpdf()` and the per-observation `pdf_full()` overload for
+//! the `parameters` layout and restrictions.
+inline Eigen::VectorXd
+Vinecop::logpdf(Eigen::MatrixXd u,
+                const Eigen::MatrixXd& parameters,
+                const tools_thread::Executor& num_threads) const
+{
+  return pdf_full_impl(std::move(u), parameters, num_threads, false, true).pdf;
+}
+
 //! throws if the model has a nonparametric pair copula (see scores()).
 inline void
 Vinecop::check_parametric(const char* fn) const
@@ -1723,7 +1888,7 @@ Vinecop::build_deriv_cache(const Eigen::MatrixXd& u,
 inline Vinecop::ScoresResult
 Vinecop::scores_full(Eigen::MatrixXd u,
                      bool step_wise,
-                     const size_t num_threads,
+                     const tools_thread::Executor& num_threads,
                      const bool keep_all)
 {
   return scores_full(
@@ -1742,7 +1907,7 @@ inline Vinecop::ScoresResult
 Vinecop::scores_full(Eigen::MatrixXd u,
                      const Eigen::MatrixXd& per_obs_params,
                      bool step_wise,
-                     const size_t num_threads,
+                     const tools_thread::Executor& num_threads,
                      const bool keep_all)
 {
   check_data(u);
@@ -1789,14 +1954,12 @@ Vinecop::scores_full(Eigen::MatrixXd u,
             pars_tmp(p) = std::min(pars(p) + 1e-3, ub(p));
             eps += pars_tmp(p) - pars(p);
             pair_copulas_[t][e].set_parameters(pars_tmp);
-            Eigen::VectorXd f1 =
-              this->pdf(u, num_threads).array().max(1e-20).log();
+            Eigen::VectorXd f1 = this->logpdf(u, num_threads);
 
             pars_tmp(p) = std::max(pars(p) - 1e-3, lb(p));
             eps -= pars_tmp(p) - pars(p);
             pair_copulas_[t][e].set_parameters(pars_tmp);
-            Eigen::VectorXd f2 =
-              this->pdf(u, num_threads).array().max(1e-20).log();
+            Eigen::VectorXd f2 = this->logpdf(u, num_threads);
 
             result.scores.col(ipar++) = (f1 - f2) / eps;
             pair_copulas_[t][e].set_parameters(pars);
@@ -1994,9 +2157,8 @@ Vinecop::scores_full(Eigen::MatrixXd u,
       }
     };
 
-    tools_thread::ThreadPool pool((num_threads == 1) ? 0 : num_threads);
-    pool.map(do_batch, tools_batch::create_batches(n, num_threads));
-    pool.join();
+    num_threads.map(
+      do_batch, tools_batch::create_batches(n, num_threads.get_num_threads()));
 
     return result;
   }
@@ -2145,9 +2307,8 @@ Vinecop::scores_full(Eigen::MatrixXd u,
     }
   };
 
-  tools_thread::ThreadPool pool((num_threads == 1) ? 0 : num_threads);
-  pool.map(do_batch, tools_batch::create_batches(n, num_threads));
-  pool.join();
+  num_threads.map(
+    do_batch, tools_batch::create_batches(n, num_threads.get_num_threads()));
 
   return result;
 }
@@ -2170,7 +2331,9 @@ Vinecop::scores_full(Eigen::MatrixXd u,
 //!   than 1, the function will be applied concurrently to `num_threads` batches
 //!   of `u`.
 inline Eigen::MatrixXd
-Vinecop::scores(Eigen::MatrixXd u, bool step_wise, const size_t num_threads)
+Vinecop::scores(Eigen::MatrixXd u,
+                bool step_wise,
+                const tools_thread::Executor& num_threads)
 {
   return scores_full(std::move(u), step_wise, num_threads, false).scores;
 }
@@ -2183,7 +2346,7 @@ inline Eigen::MatrixXd
 Vinecop::scores(Eigen::MatrixXd u,
                 const Eigen::MatrixXd& parameters,
                 bool step_wise,
-                const size_t num_threads)
+                const tools_thread::Executor& num_threads)
 {
   return scores_full(std::move(u), parameters, step_wise, num_threads, false)
     .scores;
@@ -2206,7 +2369,9 @@ Vinecop::scores(Eigen::MatrixXd u,
 //!   than 1, the function will be applied concurrently to `num_threads` batches
 //!   of `u`.
 inline Eigen::VectorXd
-Vinecop::gradient(Eigen::MatrixXd u, bool step_wise, const size_t num_threads)
+Vinecop::gradient(Eigen::MatrixXd u,
+                  bool step_wise,
+                  const tools_thread::Executor& num_threads)
 {
   return this->scores(std::move(u), step_wise, num_threads)
     .colwise()
@@ -2223,7 +2388,7 @@ inline Eigen::VectorXd
 Vinecop::gradient(Eigen::MatrixXd u,
                   const Eigen::MatrixXd& parameters,
                   bool step_wise,
-                  const size_t num_threads)
+                  const tools_thread::Executor& num_threads)
 {
   return this->scores(std::move(u), parameters, step_wise, num_threads)
     .colwise()
@@ -2260,7 +2425,7 @@ Vinecop::gradient(Eigen::MatrixXd u,
 inline TriangularArray<std::vector<Eigen::MatrixXd>>
 Vinecop::hessian_full(Eigen::MatrixXd u,
                       bool step_wise,
-                      const size_t num_threads)
+                      const tools_thread::Executor& num_threads)
 {
   return hessian_full(std::move(u), Eigen::MatrixXd(), step_wise, num_threads);
 }
@@ -2274,7 +2439,7 @@ inline TriangularArray<std::vector<Eigen::MatrixXd>>
 Vinecop::hessian_full(Eigen::MatrixXd u,
                       const Eigen::MatrixXd& per_obs_params,
                       bool step_wise,
-                      const size_t num_threads)
+                      const tools_thread::Executor& num_threads)
 {
   check_data(u);
   u = collapse_data(u);
@@ -2430,9 +2595,9 @@ Vinecop::hessian_full(Eigen::MatrixXd u,
     };
 
     if (trunc_lvl > 0) {
-      tools_thread::ThreadPool pool((num_threads == 1) ? 0 : num_threads);
-      pool.map(do_batch, tools_batch::create_batches(u.rows(), num_threads));
-      pool.join();
+      num_threads.map(do_batch,
+                      tools_batch::create_batches(
+                        u.rows(), num_threads.get_num_threads()));
     }
     return hess;
   }
@@ -2565,9 +2730,9 @@ Vinecop::hessian_full(Eigen::MatrixXd u,
   };
 
   if (trunc_lvl > 0) {
-    tools_thread::ThreadPool pool((num_threads == 1) ? 0 : num_threads);
-    pool.map(do_batch, tools_batch::create_batches(u.rows(), num_threads));
-    pool.join();
+    num_threads.map(do_batch,
+                    tools_batch::create_batches(
+                      u.rows(), num_threads.get_num_threads()));
   }
 
   return hess;
@@ -2591,7 +2756,9 @@ Vinecop::hessian_full(Eigen::MatrixXd u,
 //!   than 1, the function will be applied concurrently to `num_threads` batches
 //!   of `u`.
 inline Eigen::MatrixXd
-Vinecop::hessian(Eigen::MatrixXd u, bool step_wise, const size_t num_threads)
+Vinecop::hessian(Eigen::MatrixXd u,
+                 bool step_wise,
+                 const tools_thread::Executor& num_threads)
 {
   return hessian(std::move(u), Eigen::MatrixXd(), step_wise, num_threads);
 }
@@ -2604,7 +2771,7 @@ inline Eigen::MatrixXd
 Vinecop::hessian(Eigen::MatrixXd u,
                  const Eigen::MatrixXd& parameters,
                  bool step_wise,
-                 const size_t num_threads)
+                 const tools_thread::Executor& num_threads)
 {
   const bool per_obs = parameters.size() > 0;
   // validate up front so the per-chunk parameters.middleRows() slices below
@@ -2669,7 +2836,9 @@ Vinecop::hessian(Eigen::MatrixXd u,
 //!   than 1, the function will be applied concurrently to `num_threads` batches
 //!   of `u`.
 inline Eigen::MatrixXd
-Vinecop::scores_cov(Eigen::MatrixXd u, bool step_wise, const size_t num_threads)
+Vinecop::scores_cov(Eigen::MatrixXd u,
+                    bool step_wise,
+                    const tools_thread::Executor& num_threads)
 {
   auto s = this->scores(std::move(u), step_wise, num_threads);
   // materialize the centered scores; a lazy expression would be evaluated
@@ -2687,7 +2856,7 @@ inline Eigen::MatrixXd
 Vinecop::scores_cov(Eigen::MatrixXd u,
                     const Eigen::MatrixXd& parameters,
                     bool step_wise,
-                    const size_t num_threads)
+                    const tools_thread::Executor& num_threads)
 {
   auto s = this->scores(std::move(u), parameters, step_wise, num_threads);
   Eigen::MatrixXd sc = s.rowwise() - s.colwise().mean();
@@ -2698,7 +2867,10 @@ Vinecop::scores_cov(Eigen::MatrixXd u,
 //!
 //! @details Because no closed-form expression is available, the distribution is
 //! estimated numerically using Monte Carlo integration. The function uses
-//! quasi-random numbers from the vine model to do so.
+//! quasi-random numbers from the vine model to do so, and counts those below
+//! each evaluation point with a `tools_stats::DominanceIndex`. To evaluate the
+//! distribution repeatedly without simulating anew, use a
+//! `VinecopCdfEstimator`.
 //!
 //! When at least one variable is discrete, two types of
 //! "observations" are required in `u`: the first \f$ n \; x \; d \f$ block
@@ -2726,7 +2898,7 @@ Vinecop::scores_cov(Eigen::MatrixXd u,
 inline Eigen::VectorXd
 Vinecop::cdf(const Eigen::MatrixXd& u,
              const size_t N,
-             const size_t num_threads,
+             const tools_thread::Executor& num_threads,
              const std::vector<int>& seeds) const
 {
   if (d_ > 21201) {
@@ -2738,24 +2910,20 @@ Vinecop::cdf(const Eigen::MatrixXd& u,
   }
   check_data(u);
 
-  // Simulate N quasi-random numbers from the vine model
-  auto u_sim = simulate(N, true, num_threads, seeds);
+  // Simulate N quasi-random numbers from the vine model and count those below
+  // each evaluation point
+  const tools_stats::DominanceIndex index(
+    simulate(N, true, num_threads, seeds));
 
   size_t n = u.rows();
   Eigen::VectorXd vine_distribution(n);
   auto do_batch = [&](const tools_batch::Batch& b) {
-    // lazy dominance count per query point (no N-sized temporary)
-    Eigen::RowVectorXd temp(d_);
-    for (size_t i = b.begin; i < b.begin + b.size; i++) {
-      tools_interface::check_user_interrupt(i % 1000 == 0);
-      temp = u.block(i, 0, 1, d_);
-      vine_distribution(i) = static_cast<double>(
-        ((u_sim.rowwise() - temp).rowwise().maxCoeff().array() <= 0.0).count());
-    }
+    tools_interface::check_user_interrupt();
+    vine_distribution.segment(b.begin, b.size) =
+      index.count(u.block(b.begin, 0, b.size, d_));
   };
-  tools_thread::ThreadPool pool((num_threads == 1) ? 0 : num_threads);
-  pool.map(do_batch, tools_batch::create_batches(n, num_threads));
-  pool.join();
+  num_threads.map(
+    do_batch, tools_batch::create_batches(n, num_threads.get_num_threads()));
   return vine_distribution / static_cast<double>(N);
 }
 
@@ -2766,6 +2934,11 @@ Vinecop::cdf(const Eigen::MatrixXd& u,
 //! \f$ n \times d \f$ uniform random numbers and then applying the inverse
 //! Rosenblatt transformation.
 //!
+//! With several threads, each thread simulates a contiguous block of rows,
+//! both the uniforms (see `tools_stats::simulate_uniform_rows()`) and the
+//! samples. For the same seeds, the result does not depend on the number of
+//! threads.
+//!
 //! @param n Number of observations.
 //! @param qrng Set to true for quasi-random numbers.
 //! @param num_threads The number of threads to use for computations; if greater
@@ -2777,12 +2950,86 @@ Vinecop::cdf(const Eigen::MatrixXd& u,
 inline Eigen::MatrixXd
 Vinecop::simulate(const size_t n,
                   const bool qrng,
-                  const size_t num_threads,
+                  const tools_thread::Executor& num_threads,
                   const std::vector<int>& seeds) const
 {
-  auto u = tools_stats::simulate_uniform(n, d_, qrng, seeds);
-  return inverse_rosenblatt(u, num_threads);
-  ;
+  const size_t num_batches = std::min(n, num_threads.get_num_threads());
+  if (num_batches <= 1) {
+    auto u = tools_stats::simulate_uniform(n, d_, qrng, seeds);
+    return inverse_rosenblatt(u);
+  }
+
+  // all batches must draw from the same streams
+  auto batch_seeds = seeds;
+  if (batch_seeds.size() == 0) {
+    std::random_device rd{};
+    batch_seeds = std::vector<int>(20);
+    std::generate(batch_seeds.begin(), batch_seeds.end(), [&]() {
+      return static_cast<int>(rd());
+    });
+  }
+
+  // one batch per thread, since each batch skips ahead in the streams
+  std::vector<tools_batch::Batch> batches(num_batches);
+  for (size_t k = 0, begin = 0; k < num_batches; ++k) {
+    batches[k].begin = begin;
+    batches[k].size = n / num_batches + (k < n % num_batches);
+    begin += batches[k].size;
+  }
+
+  Eigen::MatrixXd U(n, d_);
+  auto do_batch = [&](const tools_batch::Batch& b) {
+    auto u = tools_stats::simulate_uniform_rows(
+      n, d_, b.begin, b.size, qrng, batch_seeds);
+    U.middleRows(b.begin, b.size) = inverse_rosenblatt(u);
+  };
+  num_threads.map(do_batch, batches);
+  return U;
+}
+
+//! @brief Simulates from a vine copula model in blocks of bounded size.
+//!
+//! @details Produces the rows of `simulate(n, qrng, num_threads, seeds)`
+//! block by block and passes each block to `sink`, so that only one block of
+//! uniforms and samples is held in memory at a time. For the same (non-empty)
+//! seeds, stacking the blocks gives exactly the matrix returned by
+//! `simulate()`, whatever the block size and number of threads; the
+//! quasi-random sequences continue across blocks.
+//!
+//! ```
+//! vc.simulate_blocks(100000000, 100000, [&](const Eigen::MatrixXd& u,
+//!                                           size_t begin) {
+//!   // rows begin, ..., begin + u.rows() - 1 of the sample
+//! }, true, 4, { 1, 2 });
+//! ```
+//!
+//! @param n Number of observations.
+//! @param block_size Number of observations per block; the last block may be
+//!   smaller.
+//! @param sink A function called with each block of samples and the index of
+//!   its first row in the sample, in order.
+//! @param qrng Set to true for quasi-random numbers.
+//! @param num_threads The number of threads to use for computations; each
+//!   block is split into `num_threads` batches.
+//! @param seeds Seeds of the random number generator; if empty (default),
+//!   the random number generator is seeded randomly.
+inline void
+Vinecop::simulate_blocks(
+  const size_t n,
+  const size_t block_size,
+  const std::function<void(const Eigen::MatrixXd&, size_t)>& sink,
+  const bool qrng,
+  const tools_thread::Executor& num_threads,
+  const std::vector<int>& seeds) const
+{
+  if (block_size == 0) {
+    throw std::runtime_error("block_size must be positive.");
+  }
+  tools_stats::UniformStream stream(n, d_, qrng, seeds);
+  while (stream.position() < stream.size()) {
+    const size_t begin = stream.position();
+    sink(inverse_rosenblatt(stream.next(block_size), num_threads), begin);
+  }
 }
 
 //! @brief Simulates from the conditional distribution of a subset of variables
@@ -2837,7 +3084,7 @@ Vinecop::simulate(const size_t n,
 inline Eigen::MatrixXd
 Vinecop::simulate_conditional(const Eigen::MatrixXd& u_cond,
                               const bool qrng,
-                              const size_t num_threads,
+                              const tools_thread::Executor& num_threads,
                               const std::vector<int>& seeds) const
 {
   size_t n_cols = static_cast<size_t>(u_cond.cols());
@@ -2892,7 +3139,7 @@ inline Eigen::MatrixXd
 Vinecop::simulate_conditional(const Eigen::MatrixXd& u_cond,
                               const std::vector<size_t>& conditioning_set,
                               const bool qrng,
-                              const size_t num_threads,
+                              const tools_thread::Executor& num_threads,
                               const std::vector<int>& seeds) const
 {
   auto reorientation = make_reorientation_map(conditioning_set);
@@ -2909,7 +3156,7 @@ Vinecop::simulate_conditional_impl(const Eigen::MatrixXd& u_cond,
                                    const std::vector<size_t>& conditioning_set,
                                    const VinecopView& view,
                                    bool qrng,
-                                   size_t num_threads,
+                                   const tools_thread::Executor& num_threads,
                                    const std::vector<int>& seeds) const
 {
   const size_t n = static_cast<size_t>(u_cond.rows());
@@ -2984,12 +3231,13 @@ Vinecop::simulate_conditional_impl(const Eigen::MatrixXd& u_cond,
 //!   of `u`.
 //! @return The log-likelihood as a double.
 inline double
-Vinecop::loglik(const Eigen::MatrixXd& u, const size_t num_threads) const
+Vinecop::loglik(const Eigen::MatrixXd& u,
+                const tools_thread::Executor& num_threads) const
 {
   if (u.rows() < 1) {
     return this->get_loglik();
   } else {
-    return pdf(u, num_threads).array().log().sum();
+    return logpdf(u, num_threads).sum();
   }
 }
 
@@ -3002,9 +3250,9 @@ Vinecop::loglik(const Eigen::MatrixXd& u, const size_t num_threads) const
 inline double
 Vinecop::loglik(const Eigen::MatrixXd& u,
                 const Eigen::MatrixXd& parameters,
-                const size_t num_threads) const
+                const tools_thread::Executor& num_threads) const
 {
-  return pdf(u, parameters, num_threads).array().log().sum();
+  return logpdf(u, parameters, num_threads).sum();
 }
 
 //! @brief Evaluates the Akaike information criterion (AIC).
@@ -3026,7 +3274,8 @@ Vinecop::loglik(const Eigen::MatrixXd& u,
 //!   of `u`.
 //! @return The AIC as a double.
 inline double
-Vinecop::aic(const Eigen::MatrixXd& u, const size_t num_threads) const
+Vinecop::aic(const Eigen::MatrixXd& u,
+             const tools_thread::Executor& num_threads) const
 {
   return -2 * this->loglik(u, num_threads) + 2 * get_npars();
 }
@@ -3050,7 +3299,8 @@ Vinecop::aic(const Eigen::MatrixXd& u, const size_t num_threads) const
 //!   of `u`.
 //! @return The BIC as a double.
 inline double
-Vinecop::bic(const Eigen::MatrixXd& u, const size_t num_threads) const
+Vinecop::bic(const Eigen::MatrixXd& u,
+             const tools_thread::Executor& num_threads) const
 {
   return -2 * this->loglik(u, num_threads) +
          get_npars() * log(static_cast<double>(u.rows()));
@@ -3084,7 +3334,7 @@ Vinecop::bic(const Eigen::MatrixXd& u, const size_t num_threads) const
 inline double
 Vinecop::mbicv(const Eigen::MatrixXd& u,
                const double psi0,
-               const size_t num_threads) const
+               const tools_thread::Executor& num_threads) const
 {
 
   size_t n = u.rows();
@@ -3160,7 +3410,7 @@ Vinecop::get_npars() const
 //! @return An \f$ n \times d \f$ matrix of independent uniform variates.
 inline Eigen::MatrixXd
 Vinecop::rosenblatt(Eigen::MatrixXd u,
-                    const size_t num_threads,
+                    const tools_thread::Executor& num_threads,
                     bool randomize_discrete,
                     std::vector<int> seeds) const
 {
@@ -3190,7 +3440,7 @@ Vinecop::rosenblatt(Eigen::MatrixXd u,
 inline Eigen::MatrixXd
 Vinecop::rosenblatt(Eigen::MatrixXd u,
                     const std::vector<size_t>& conditioning_set,
-                    const size_t num_threads,
+                    const tools_thread::Executor& num_threads,
                     bool randomize_discrete,
                     std::vector<int> seeds) const
 {
@@ -3205,7 +3455,7 @@ Vinecop::rosenblatt(Eigen::MatrixXd u,
 inline Eigen::MatrixXd
 Vinecop::rosenblatt_impl(Eigen::MatrixXd u,
                          const VinecopView& view,
-                         size_t num_threads,
+                         const tools_thread::Executor& num_threads,
                          bool randomize_discrete,
                          std::vector<int> seeds) const
 {
@@ -3292,9 +3542,11 @@ Vinecop::rosenblatt_impl(Eigen::MatrixXd u,
   };
 
   if (trunc_lvl > 0) {
-    tools_thread::ThreadPool pool((num_threads == 1) ? 0 : num_threads);
-    pool.map(do_batch, tools_batch::create_batches(n, num_threads));
-    pool.join();
+    // a batch works on its rows of the h-function matrices
+    auto cost = get_batch_cost(trunc_lvl, (is_discrete() ? 4 : 2) * d + 8);
+    num_threads.map(
+      do_batch,
+      tools_batch::create_batches(n, num_threads.get_num_threads(), cost));
   }
 
   // go back to original order
@@ -3362,7 +3614,7 @@ Vinecop::rosenblatt_impl(Eigen::MatrixXd u,
 //! @return An \f$ n \times d \f$ matrix of evaluations.
 inline Eigen::MatrixXd
 Vinecop::inverse_rosenblatt(const Eigen::MatrixXd& u,
-                            const size_t num_threads) const
+                            const tools_thread::Executor& num_threads) const
 {
   return inverse_rosenblatt_impl(u, VinecopView(*this), num_threads);
 }
@@ -3383,7 +3635,7 @@ Vinecop::inverse_rosenblatt(const Eigen::MatrixXd& u,
 inline Eigen::MatrixXd
 Vinecop::inverse_rosenblatt(const Eigen::MatrixXd& u,
                             const std::vector<size_t>& conditioning_set,
-                            const size_t num_threads) const
+                            const tools_thread::Executor& num_threads) const
 {
   auto reorientation = make_reorientation_map(conditioning_set);
   return inverse_rosenblatt_impl(
@@ -3391,9 +3643,10 @@ Vinecop::inverse_rosenblatt(const Eigen::MatrixXd& u,
 }
 
 inline Eigen::MatrixXd
-Vinecop::inverse_rosenblatt_impl(const Eigen::MatrixXd& u,
-                                 const VinecopView& view,
-                                 size_t num_threads) const
+Vinecop::inverse_rosenblatt_impl(
+  const Eigen::MatrixXd& u,
+  const VinecopView& view,
+  const tools_thread::Executor& num_threads) const
 {
   const size_t n_cols = static_cast<size_t>(u.cols());
   const size_t compact_cols = d_ + get_n_discrete();
@@ -3483,9 +3736,11 @@ Vinecop::inverse_rosenblatt_impl(const Eigen::MatrixXd& u,
   };
 
   if (trunc_lvl > 0) {
-    tools_thread::ThreadPool pool((num_threads == 1) ? 0 : num_threads);
-    pool.map(do_batch, tools_batch::create_batches(n, num_threads));
-    pool.join();
+    // scratch per row: one (inverse) h-function per edge and tree
+    auto cost = get_batch_cost(trunc_lvl, 2 * (trunc_lvl + 1) * (d + 1) + 2);
+    num_threads.map(
+      do_batch,
+      tools_batch::create_batches(n, num_threads.get_num_threads(), cost));
   }
 
   return U_vine;
@@ -3689,6 +3944,49 @@ Vinecop::collapse_data_inplace(Eigen::MatrixXd& u) const
   }
 }
 
+//! @brief Estimates what one row costs in the evaluation methods.
+//!
+//! @details Used to size the batches of `pdf_full()`, `rosenblatt()`, and
+//! `inverse_rosenblatt()`. Every pair copula in the first `trunc_lvl` trees is
+//! evaluated about three times per row (density and h-functions), weighted by
+//! how expensive its family is relative to a closed-form one-parameter family.
+//! Pair copulas with discrete margins count twice.
+//!
+//! @param trunc_lvl The number of trees evaluated.
+//! @param scratch_cols The number of `double`s of scratch memory per row.
+inline tools_batch::BatchCost
+Vinecop::get_batch_cost(size_t trunc_lvl, size_t scratch_cols) const
+{
+  double row_cost = 0.0;
+  for (size_t tree = 0; tree < std::min(trunc_lvl, pair_copulas_.size());
+       ++tree) {
+    for (const auto& pc : pair_copulas_[tree]) {
+      double cost = 1.0;
+      auto family = pc.get_family();
+      if (family == BicopFamily::indep) {
+        cost = 0.1;
+      } else if (family == BicopFamily::student) {
+        cost = 4.0;
+      } else if (family == BicopFamily::tll) {
+        cost = 3.0;
+      } else if (tools_stl::is_member(family, bicop_families::bb) ||
+                 (family == BicopFamily::tawn)) {
+        cost = 2.0;
+      }
+      auto var_types = pc.get_var_types();
+      if ((var_types[0] == "d") || (var_types[1] == "d")) {
+        cost *= 2.0;
+      }
+      row_cost += 3.0 * cost;
+    }
+  }
+
+  tools_batch::BatchCost batch_cost;
+  batch_cost.row_cost = std::max(row_cost, 1.0);
+  batch_cost.row_bytes = sizeof(double) * scratch_cols;
+  return batch_cost;
+}
+
 //! @brief Summarizes the model into a string (can be used for printing).
 //! @param trees A vector of tree indices to summarize; if empty, all trees.
 inline std::string
@@ -0,0 +1,544 @@
+// Copyright © 2016-2026 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <vinecopulib/misc/tools_batch.hpp>
+#include <vinecopulib/misc/tools_eigen.hpp>
+#include <vinecopulib/misc/tools_interface.hpp>
+#include <vinecopulib/misc/tools_stl.hpp>
+
+namespace vinecopulib {
+
+//! Sizes the buffers for `n` observations of a `d`-dimensional model; Eigen
+//! keeps the memory when the number of coefficients does not change.
+inline void
+VinecopWorkspace::resize(Eigen::Index n, size_t d)
+{
+  const auto cols = static_cast<Eigen::Index>(d);
+  hfunc1_.resize(n, cols);
+  hfunc2_.resize(n, cols);
+  hfunc1_next_.resize(n, cols);
+  hfunc2_next_.resize(n, cols);
+  result_.resize(n, cols);
+  u_e_.resize(n, 2);
+  edge_.resize(n);
+}
+
+//! @brief Compiles the evaluation plan of a vine copula model.
+//!
+//! @param vinecop A vine copula model with continuous variables only.
+inline CompiledVinecop::CompiledVinecop(const Vinecop& vinecop)
+  : d_(vinecop.d_)
+  , trunc_lvl_(vinecop.get_effective_trunc_lvl())
+{
+  if (vinecop.is_discrete()) {
+    throw std::runtime_error(
+      "compile() is only available for models with continuous variables.");
+  }
+
+  const auto& structure = vinecop.rvine_structure_;
+  order_ = structure.get_order();
+  for (auto& j : order_) {
+    --j;
+  }
+  inverse_order_ = tools_stl::invert_permutation(order_);
+  pdf_cost_ = vinecop.get_batch_cost(trunc_lvl_, 4 * d_ + 8);
+  inverse_rosenblatt_cost_ =
+    vinecop.get_batch_cost(trunc_lvl_, 2 * (trunc_lvl_ + 1) * (d_ + 1) + 2);
+
+  position_.resize(trunc_lvl_);
+  tree_begin_.push_back(0);
+  for (size_t tree = 0; tree < trunc_lvl_; ++tree) {
+    const auto& pcs = vinecop.pair_copulas_[tree];
+    // edges of a tree are independent of each other, so they can run in any
+    // order; grouping them by family keeps each family's kernel hot
+    auto edges = tools_stl::seq_int(0, pcs.size());
+    std::stable_sort(edges.begin(), edges.end(), [&](size_t a, size_t b) {
+      return pcs[a].get_family() < pcs[b].get_family();
+    });
+
+    position_[tree].resize(pcs.size());
+    for (size_t edge : edges) {
+      position_[tree][edge] = edge_.size();
+      // deep copy, so that the plan does not change with the model
+      Bicop pc = pcs[edge];
+      size_t m = structure.min_array(tree, edge);
+      int rotation = pc.get_rotation();
+      auto h1_spec = pc.get_conditional_spec(true);
+      auto h2_spec = pc.get_conditional_spec(false);
+
+      edge_.push_back(edge);
+      arg2_col_.push_back(m - 1);
+      arg2_from_hfunc2_.push_back(m ==
+                                  structure.struct_array(tree, edge, true));
+      needs_hfunc1_.push_back(structure.needed_hfunc1(tree, edge));
+      needs_hfunc2_.push_back(structure.needed_hfunc2(tree, edge));
+      is_indep_.push_back(pc.get_family() == BicopFamily::indep);
+      swap_.push_back((rotation == 90) || (rotation == 270));
+      flip1_.push_back((rotation == 180) || (rotation == 270));
+      flip2_.push_back((rotation == 90) || (rotation == 180));
+      h1_use_first_.push_back(h1_spec.use_first);
+      h1_complement_.push_back(h1_spec.complement);
+      h2_use_first_.push_back(h2_spec.use_first);
+      h2_complement_.push_back(h2_spec.complement);
+      // TLL kernels read their interpolation grid and ignore the parameters
+      parameters_.push_back(pc.get_family() == BicopFamily::tll
+                              ? Eigen::MatrixXd()
+                              : pc.bicop_->get_parameters().transpose());
+      kernels_.push_back(pc.bicop_);
+    }
+    tree_begin_.push_back(edge_.size());
+  }
+}
+
+//! @brief Evaluates the copula density, see `Vinecop::pdf()`.
+//!
+//! @param u An \f$ n \times d \f$ matrix of evaluation points.
+//! @param num_threads The number of threads to use for computations, or a
+//!   pool to run on (see `tools_thread::Executor`).
+//! @return A vector of length `n` containing the copula density values.
+inline Eigen::VectorXd
+CompiledVinecop::pdf(const Eigen::MatrixXd& u,
+                     const tools_thread::Executor& num_threads) const
+{
+  return density(u, num_threads, false);
+}
+
+//! @brief Evaluates the logarithm of the copula density, see
+//! `Vinecop::logpdf()`.
+//!
+//! @param u An \f$ n \times d \f$ matrix of evaluation points.
+//! @param num_threads The number of threads to use for computations, or a
+//!   pool to run on (see `tools_thread::Executor`).
+//! @return A vector of length `n` containing the copula log-density values.
+inline Eigen::VectorXd
+CompiledVinecop::logpdf(const Eigen::MatrixXd& u,
+                        const tools_thread::Executor& num_threads) const
+{
+  return density(u, num_threads, true);
+}
+
+//! @brief Evaluates the copula density into a caller-provided buffer, see
+//! `Vinecop::pdf()`.
+//!
+//! @param u An \f$ n \times d \f$ matrix of evaluation points.
+//! @param out A vector of length `n` the density values are written to.
+//! @param workspace Scratch memory for the evaluation; see
+//!   `VinecopWorkspace`.
+inline void
+CompiledVinecop::pdf(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                     Eigen::Ref<Eigen::VectorXd> out,
+                     VinecopWorkspace& workspace) const
+{
+  check_data(u);
+  check_output(out.rows(), out.cols(), u.rows(), 1);
+  density_block(u, out, workspace, false);
+}
+
+//! @brief Evaluates the logarithm of the copula density into a caller-provided
+//! buffer, see `Vinecop::logpdf()`.
+//!
+//! @param u An \f$ n \times d \f$ matrix of evaluation points.
+//! @param out A vector of length `n` the log-density values are written to.
+//! @param workspace Scratch memory for the evaluation; see
+//!   `VinecopWorkspace`.
+inline void
+CompiledVinecop::logpdf(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                        Eigen::Ref<Eigen::VectorXd> out,
+                        VinecopWorkspace& workspace) const
+{
+  check_data(u);
+  check_output(out.rows(), out.cols(), u.rows(), 1);
+  density_block(u, out, workspace, true);
+}
+
+inline Eigen::VectorXd
+CompiledVinecop::density(const Eigen::MatrixXd& u,
+                         const tools_thread::Executor& num_threads,
+                         bool log_scale) const
+{
+  check_data(u);
+  Eigen::VectorXd pdf(u.rows());
+  auto do_batch = [&](const tools_batch::Batch& b) {
+    VinecopWorkspace workspace;
+    density_block(u.middleRows(b.begin, b.size),
+                  pdf.segment(b.begin, b.size),
+                  workspace,
+                  log_scale);
+  };
+
+  num_threads.map(
+    do_batch,
+    tools_batch::create_batches(
+      u.rows(), num_threads.get_num_threads(), pdf_cost_));
+
+  return pdf;
+}
+
+//! Evaluates the density (or its logarithm) on a block of observations.
+inline void
+CompiledVinecop::density_block(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                               Eigen::Ref<Eigen::VectorXd> out,
+                               VinecopWorkspace& workspace,
+                               bool log_scale) const
+{
+  // product of the edge densities, or sum of their logarithms
+  out.setConstant(log_scale ? 0.0 : 1.0);
+  if (trunc_lvl_ == 0) {
+    return;
+  }
+
+  // h-functions of the previous tree (read) and the current one (written);
+  // edges run grouped by family, so a column may only be overwritten once
+  // the whole tree is done
+  workspace.resize(u.rows(), d_);
+  auto& hfunc1 = workspace.hfunc1_;
+  auto& hfunc2 = workspace.hfunc2_;
+  auto& hfunc1_next = workspace.hfunc1_next_;
+  auto& hfunc2_next = workspace.hfunc2_next_;
+  auto& u_e = workspace.u_e_;
+  auto& edge = workspace.edge_;
+  hfunc1.setZero();
+  for (size_t j = 0; j < d_; ++j) {
+    hfunc2.col(j) = u.col(order_[j]);
+  }
+  hfunc1_next = hfunc1;
+  hfunc2_next = hfunc2;
+
+  for (size_t tree = 0; tree < trunc_lvl_; ++tree) {
+    tools_interface::check_user_interrupt(
+      static_cast<double>(u.rows()) * static_cast<double>(d_) > 1e5);
+    for (size_t k = tree_begin_[tree]; k < tree_begin_[tree + 1]; ++k) {
+      load_arguments(k, hfunc1, hfunc2, u_e);
+      if (!is_indep_[k]) {
+        if (log_scale) {
+          eval_logpdf(k, u_e, edge);
+          out += edge;
+        } else {
+          eval_pdf(k, u_e, edge);
+          out.array() *= edge.array();
+        }
+      }
+      if (needs_hfunc1_[k]) {
+        eval_hfunc(k, true, u_e, hfunc1_next.col(edge_[k]));
+      }
+      if (needs_hfunc2_[k]) {
+        eval_hfunc(k, false, u_e, hfunc2_next.col(edge_[k]));
+      }
+    }
+    hfunc1.swap(hfunc1_next);
+    hfunc2.swap(hfunc2_next);
+  }
+}
+
+//! @brief Evaluates the log-likelihood, see `Vinecop::loglik()`.
+//!
+//! @param u An \f$ n \times d \f$ matrix of evaluation points.
+//! @param num_threads The number of threads to use for computations, or a
+//!   pool to run on (see `tools_thread::Executor`).
+//! @return The log-likelihood as a double.
+inline double
+CompiledVinecop::loglik(const Eigen::MatrixXd& u,
+                        const tools_thread::Executor& num_threads) const
+{
+  return logpdf(u, num_threads).sum();
+}
+
+//! @brief Evaluates the Rosenblatt transform, see `Vinecop::rosenblatt()`.
+//!
+//! @param u An \f$ n \times d \f$ matrix of evaluation points.
+//! @param num_threads The number of threads to use for computations, or a
+//!   pool to run on (see `tools_thread::Executor`).
+//! @return An \f$ n \times d \f$ matrix of independent uniform variates.
+inline Eigen::MatrixXd
+CompiledVinecop::rosenblatt(const Eigen::MatrixXd& u,
+                            const tools_thread::Executor& num_threads) const
+{
+  check_data(u);
+  const size_t n = u.rows();
+  Eigen::MatrixXd U(n, d_);
+
+  auto do_batch = [&](const tools_batch::Batch& b) {
+    VinecopWorkspace workspace;
+    rosenblatt_block(
+      u.middleRows(b.begin, b.size), U.middleRows(b.begin, b.size), workspace);
+  };
+
+  num_threads.map(
+    do_batch,
+    tools_batch::create_batches(n, num_threads.get_num_threads(), pdf_cost_));
+
+  return U;
+}
+
+//! @brief Evaluates the Rosenblatt transform into a caller-provided buffer,
+//! see `Vinecop::rosenblatt()`.
+//!
+//! @param u An \f$ n \times d \f$ matrix of evaluation points.
+//! @param out An \f$ n \times d \f$ matrix the independent uniform variates
+//!   are written to.
+//! @param workspace Scratch memory for the evaluation; see
+//!   `VinecopWorkspace`.
+inline void
+CompiledVinecop::rosenblatt(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                            Eigen::Ref<Eigen::MatrixXd> out,
+                            VinecopWorkspace& workspace) const
+{
+  check_data(u);
+  check_output(out.rows(), out.cols(), u.rows(), u.cols());
+  rosenblatt_block(u, out, workspace);
+}
+
+//! Evaluates the Rosenblatt transform on a block of observations.
+inline void
+CompiledVinecop::rosenblatt_block(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                                  Eigen::Ref<Eigen::MatrixXd> out,
+                                  VinecopWorkspace& workspace) const
+{
+  workspace.resize(u.rows(), d_);
+  auto& hfunc1 = workspace.hfunc1_;
+  auto& hfunc2 = workspace.hfunc2_;
+  auto& hfunc1_next = workspace.hfunc1_next_;
+  auto& hfunc2_next = workspace.hfunc2_next_;
+  auto& u_e = workspace.u_e_;
+  // a column's final value comes from the last tree it is updated in
+  auto& result = workspace.result_;
+  for (size_t j = 0; j < d_; ++j) {
+    hfunc2.col(j) = u.col(order_[j]);
+  }
+  hfunc1 = hfunc2;
+  result = hfunc2;
+  hfunc1_next = hfunc1;
+  hfunc2_next = hfunc2;
+
+  for (size_t tree = 0; tree < trunc_lvl_; ++tree) {
+    tools_interface::check_user_interrupt(
+      static_cast<double>(u.rows()) * static_cast<double>(d_) > 1e5);
+    for (size_t k = tree_begin_[tree]; k < tree_begin_[tree + 1]; ++k) {
+      load_arguments(k, hfunc1, hfunc2, u_e);
+      if (needs_hfunc1_[k]) {
+        eval_hfunc(k, true, u_e, hfunc1_next.col(edge_[k]));
+      }
+      eval_hfunc(k, false, u_e, hfunc2_next.col(edge_[k]));
+      result.col(edge_[k]) = hfunc2_next.col(edge_[k]);
+    }
+    hfunc1.swap(hfunc1_next);
+    hfunc2.swap(hfunc2_next);
+  }
+
+  // go back to original order
+  for (size_t j = 0; j < d_; ++j) {
+    out.col(j) =
+      result.col(inverse_order_[j]).array().min(1 - 1e-10).max(1e-10);
+  }
+}
+
+//! @brief Evaluates the inverse Rosenblatt transform, see
+//! `Vinecop::inverse_rosenblatt()`.
+//!
+//! @param u An \f$ n \times d \f$ matrix of independent uniform variates.
+//! @param num_threads The number of threads to use for computations, or a
+//!   pool to run on (see `tools_thread::Executor`).
+//! @return An \f$ n \times d \f$ matrix of transformed values.
+inline Eigen::MatrixXd
+CompiledVinecop::inverse_rosenblatt(
+  const Eigen::MatrixXd& u,
+  const tools_thread::Executor& num_threads) const
+{
+  check_data(u);
+  const size_t n = u.rows();
+  const size_t d = d_;
+  Eigen::MatrixXd U_vine = u;
+  if (trunc_lvl_ == 0) {
+    return U_vine;
+  }
+
+  auto do_batch = [&](const tools_batch::Batch& b) {
+    // (inverse) h-functions, indexed by (tree, variable)
+    std::vector<std::vector<Eigen::VectorXd>> hinv2(
+      trunc_lvl_ + 1, std::vector<Eigen::VectorXd>(d));
+    std::vector<std::vector<Eigen::VectorXd>> hfunc1(
+      trunc_lvl_ + 1, std::vector<Eigen::VectorXd>(d));
+    Eigen::MatrixXd U_e(b.size, 2), u_e(b.size, 2);
+
+    // initialize with independent uniforms (corresponding to natural order)
+    for (size_t j = 0; j < d; ++j) {
+      hinv2[std::min(trunc_lvl_, d - j - 1)][j] =
+        u.block(b.begin, order_[j], b.size, 1);
+    }
+    hfunc1[0][d - 1] = hinv2[0][d - 1];
+
+    // loop through variables (the last one is just the initial uniform)
+    for (ptrdiff_t var = d - 2; var >= 0; --var) {
+      tools_interface::check_user_interrupt(
+        static_cast<double>(n) * static_cast<double>(d) > 1e5);
+      size_t tree_start = std::min(trunc_lvl_ - 1, d - var - 2);
+      for (ptrdiff_t tree = tree_start; tree >= 0; --tree) {
+        size_t k = position_[tree][var];
+
+        // extract data for conditional pair
+        U_e.col(0) = hinv2[tree + 1][var];
+        if (arg2_from_hfunc2_[k]) {
+          U_e.col(1) = hinv2[tree][arg2_col_[k]];
+        } else {
+          U_e.col(1) = hfunc1[tree][arg2_col_[k]];
+        }
+
+        // inverse Rosenblatt transform simulates data for conditional pair
+        u_e = U_e;
+        prepare_arguments(k, u_e);
+        hinv2[tree][var] = eval_hinv2(k, u_e);
+
+        // if required at a later stage, also calculate hfunc1
+        if (needs_hfunc1_[k]) {
+          U_e.col(0) = hinv2[tree][var];
+          u_e = U_e;
+          prepare_arguments(k, u_e);
+          hfunc1[tree + 1][var].resize(b.size);
+          eval_hfunc(k, true, u_e, hfunc1[tree + 1][var]);
+        }
+      }
+    }
+
+    // go back to original order
+    for (size_t j = 0; j < d; ++j) {
+      U_vine.block(b.begin, j, b.size, 1) = hinv2[0][inverse_order_[j]];
+    }
+  };
+
+  auto batches = tools_batch::create_batches(
+    n, num_threads.get_num_threads(), inverse_rosenblatt_cost_);
+  num_threads.map(do_batch, batches);
+
+  return U_vine;
+}
+
+//! Checks the dimension and range of the data.
+inline void
+CompiledVinecop::check_data(const Eigen::Ref<const Eigen::MatrixXd>& u) const
+{
+  if (static_cast<size_t>(u.cols()) != d_) {
+    std::stringstream msg;
+    msg << "data has wrong number of columns; expected: " << d_
+        << ", actual: " << u.cols() << ".";
+    throw std::runtime_error(msg.str());
+  }
+  tools_eigen::check_if_in_unit_cube(u);
+}
+
+//! Checks the shape of a caller-provided output buffer.
+inline void
+CompiledVinecop::check_output(Eigen::Index rows,
+                              Eigen::Index cols,
+                              Eigen::Index expected_rows,
+                              Eigen::Index expected_cols) const
+{
+  if ((rows != expected_rows) || (cols != expected_cols)) {
+    std::stringstream msg;
+    msg << "output has wrong size; expected: " << expected_rows << " x "
+        << expected_cols << ", actual: " << rows << " x " << cols << ".";
+    throw std::runtime_error(msg.str());
+  }
+}
+
+//! Collects the arguments of edge `k` from the previous tree's h-functions and
+//! prepares them for the kernel.
+inline void
+CompiledVinecop::load_arguments(size_t k,
+                                const Eigen::MatrixXd& hfunc1,
+                                const Eigen::MatrixXd& hfunc2,
+                                Eigen::MatrixXd& u_e) const
+{
+  u_e.col(0) = hfunc2.col(edge_[k]);
+  u_e.col(1) = arg2_from_hfunc2_[k] ? hfunc2.col(arg2_col_[k])
+                                    : hfunc1.col(arg2_col_[k]);
+  prepare_arguments(k, u_e);
+}
+
+//! Trims the arguments of edge `k` away from the boundaries and rotates them,
+//! as `Bicop` does before calling the family's kernel.
+inline void
+CompiledVinecop::prepare_arguments(size_t k, Eigen::MatrixXd& u_e) const
+{
+  tools_eigen::trim(u_e);
+  if (swap_[k]) {
+    u_e.col(0).swap(u_e.col(1));
+  }
+  if (flip1_[k]) {
+    u_e.col(0) = 1 - u_e.col(0).array();
+  }
+  if (flip2_[k]) {
+    u_e.col(1) = 1 - u_e.col(1).array();
+  }
+}
+
+inline void
+CompiledVinecop::eval_pdf(size_t k,
+                          const Eigen::MatrixXd& u_e,
+                          Eigen::Ref<Eigen::VectorXd> out) const
+{
+  kernels_[k]->pdf_raw_into(u_e, parameters_[k], out);
+  tools_eigen::trim(out, DBL_MIN, DBL_MAX);
+}
+
+inline void
+CompiledVinecop::eval_logpdf(size_t k,
+                             const Eigen::MatrixXd& u_e,
+                             Eigen::Ref<Eigen::VectorXd> out) const
+{
+  kernels_[k]->logpdf_raw_into(u_e, parameters_[k], out);
+  tools_eigen::trim(out, std::log(DBL_MIN), std::log(DBL_MAX));
+}
+
+inline void
+CompiledVinecop::eval_hfunc(size_t k,
+                            bool first,
+                            const Eigen::MatrixXd& u_e,
+                            Eigen::Ref<Eigen::VectorXd> out) const
+{
+  bool use_first = first ? h1_use_first_[k] : h2_use_first_[k];
+  bool complement = first ? h1_complement_[k] : h2_complement_[k];
+  if (use_first) {
+    kernels_[k]->hfunc1_raw_into(u_e, parameters_[k], out);
+  } else {
+    kernels_[k]->hfunc2_raw_into(u_e, parameters_[k], out);
+  }
+  if (complement) {
+    out = 1.0 - out.array();
+  }
+  tools_eigen::trim(out, 0.0, 1.0);
+}
+
+inline Eigen::VectorXd
+CompiledVinecop::eval_hinv2(size_t k, const Eigen::MatrixXd& u_e) const
+{
+  Eigen::VectorXd hi = h2_use_first_[k]
+                         ? kernels_[k]->hinv1_raw(u_e, parameters_[k])
+                         : kernels_[k]->hinv2_raw(u_e, parameters_[k]);
+  if (h2_complement_[k]) {
+    hi = 1.0 - hi.array();
+  }
+  tools_eigen::trim(hi, 0.0, 1.0);
+  return hi;
+}
+
+//! @brief Compiles the model into an immutable evaluation plan.
+//!
+//! @details See `CompiledVinecop`. Worthwhile when the same model is evaluated
+//! many times, e.g., on streaming data or in a bootstrap; the plan costs about
+//! one pass over the pair copulas to build. Only models with continuous
+//! variables can be compiled.
+inline CompiledVinecop
+Vinecop::compile() const
+{
+  return CompiledVinecop(*this);
+}
+}
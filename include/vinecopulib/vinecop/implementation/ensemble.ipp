@@ -0,0 +1,326 @@
+// Copyright © 2016-2026 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vinecopulib/misc/tools_interface.hpp>
+#include <vinecopulib/vinecop/tools_select.hpp>
+
+namespace vinecopulib {
+
+//! @brief Plans the evaluation of the models.
+//!
+//! @param vinecops The vine copula models; they must have the same dimension.
+inline VinecopEnsemble::VinecopEnsemble(const std::vector<Vinecop>& vinecops)
+  : d_(vinecops.empty() ? 0 : vinecops[0].get_dim())
+  , vinecops_(vinecops)
+{
+  if (vinecops_.empty()) {
+    throw std::runtime_error("the ensemble must contain at least one model.");
+  }
+  for (const auto& vc : vinecops_) {
+    if (vc.get_dim() != d_) {
+      throw std::runtime_error("all models must have the same dimension.");
+    }
+  }
+
+  // one root per variable order and variable types
+  std::vector<std::vector<size_t>> groups;
+  for (size_t m = 0; m < vinecops_.size(); ++m) {
+    auto same_root = [&](const std::vector<size_t>& group) {
+      const auto& other = vinecops_[group[0]];
+      return (other.get_order() == vinecops_[m].get_order()) &&
+             (other.var_types_ == vinecops_[m].var_types_);
+    };
+    auto group = std::find_if(groups.begin(), groups.end(), same_root);
+    if (group == groups.end()) {
+      groups.push_back({ m });
+    } else {
+      group->push_back(m);
+    }
+  }
+  for (const auto& group : groups) {
+    roots_.push_back(nodes_.size());
+    nodes_.push_back(Node{ group[0], 0, {}, {}, {}, {} });
+    build_node(roots_.back(), group);
+  }
+}
+
+//! @brief Evaluates the copula densities of the models.
+//!
+//! @param u An \f$ n \times d \f$ matrix of evaluation points, in the layouts
+//!   taken by `Vinecop::pdf()`.
+//! @param num_threads The number of threads to use for computations.
+//! @return An \f$ n \times m \f$ matrix whose column `j` holds the density of
+//!   model `j`.
+inline Eigen::MatrixXd
+VinecopEnsemble::pdf(const Eigen::MatrixXd& u,
+                     const tools_thread::Executor& num_threads) const
+{
+  return density(u, num_threads, false);
+}
+
+//! @brief Evaluates the logarithms of the copula densities of the models.
+//!
+//! @param u An \f$ n \times d \f$ matrix of evaluation points, in the layouts
+//!   taken by `Vinecop::pdf()`.
+//! @param num_threads The number of threads to use for computations.
+//! @return An \f$ n \times m \f$ matrix whose column `j` holds the
+//!   log-density of model `j`.
+inline Eigen::MatrixXd
+VinecopEnsemble::logpdf(const Eigen::MatrixXd& u,
+                        const tools_thread::Executor& num_threads) const
+{
+  return density(u, num_threads, true);
+}
+
+//! @brief Evaluates the log-likelihoods of the models.
+//!
+//! @param u An \f$ n \times d \f$ matrix of evaluation points, in the layouts
+//!   taken by `Vinecop::pdf()`.
+//! @param num_threads The number of threads to use for computations.
+//! @return A vector of length `m` holding the log-likelihood of each model.
+inline Eigen::VectorXd
+VinecopEnsemble::loglik(const Eigen::MatrixXd& u,
+                        const tools_thread::Executor& num_threads) const
+{
+  return density(u, num_threads, true).colwise().sum().transpose();
+}
+
+//! adds the children of node `k`, which all `models` share the trees of.
+inline void
+VinecopEnsemble::build_node(size_t k, const std::vector<size_t>& models)
+{
+  const size_t depth = nodes_[k].depth;
+  max_depth_ = std::max(max_depth_, depth);
+  std::vector<std::vector<size_t>> groups;
+  for (size_t m : models) {
+    if (vinecops_[m].get_effective_trunc_lvl() == depth) {
+      nodes_[k].done.push_back(m);
+      continue;
+    }
+    auto group = std::find_if(
+      groups.begin(), groups.end(), [&](const std::vector<size_t>& group) {
+        return same_tree(group[0], m, depth);
+      });
+    if (group == groups.end()) {
+      groups.push_back({ m });
+    } else {
+      group->push_back(m);
+    }
+  }
+
+  for (const auto& group : groups) {
+    Node child{ group[0],
+                depth + 1,
+                std::vector<char>(d_ - depth - 1, 0),
+                std::vector<char>(d_ - depth - 1, 0),
+                {},
+                {} };
+    for (size_t m : group) {
+      const auto& structure = vinecops_[m].rvine_structure_;
+      for (size_t edge = 0; edge < d_ - depth - 1; ++edge) {
+        child.needs_hfunc1[edge] |= structure.needed_hfunc1(depth, edge);
+        child.needs_hfunc2[edge] |= structure.needed_hfunc2(depth, edge);
+      }
+    }
+    const size_t c = nodes_.size();
+    nodes_[k].children.push_back(c);
+    nodes_.push_back(std::move(child));
+    build_node(c, group);
+  }
+}
+
+//! whether models `a` and `b` have the same edges and pair copulas in `tree`.
+inline bool
+VinecopEnsemble::same_tree(size_t a, size_t b, size_t tree) const
+{
+  const auto& vc_a = vinecops_[a];
+  const auto& vc_b = vinecops_[b];
+  for (size_t edge = 0; edge < d_ - tree - 1; ++edge) {
+    if ((vc_a.rvine_structure_.min_array(tree, edge) !=
+         vc_b.rvine_structure_.min_array(tree, edge)) ||
+        (vc_a.rvine_structure_.struct_array(tree, edge, true) !=
+         vc_b.rvine_structure_.struct_array(tree, edge, true))) {
+      return false;
+    }
+    const auto& pc_a = vc_a.pair_copulas_[tree][edge];
+    const auto& pc_b = vc_b.pair_copulas_[tree][edge];
+    if ((pc_a.get_family() != pc_b.get_family()) ||
+        (pc_a.get_rotation() != pc_b.get_rotation()) ||
+        (pc_a.get_var_types() != pc_b.get_var_types())) {
+      return false;
+    }
+    const Eigen::MatrixXd par_a = pc_a.get_parameters();
+    const Eigen::MatrixXd par_b = pc_b.get_parameters();
+    if ((par_a.rows() != par_b.rows()) || (par_a.cols() != par_b.cols()) ||
+        (par_a != par_b)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//! evaluates the (log-)densities of all models, see `pdf()`.
+inline Eigen::MatrixXd
+VinecopEnsemble::density(const Eigen::MatrixXd& u,
+                         const tools_thread::Executor& num_threads,
+                         bool log_scale) const
+{
+  const Eigen::Index n = u.rows();
+  Eigen::MatrixXd out(n, static_cast<Eigen::Index>(vinecops_.size()));
+
+  // the data in each root's layout, reordered to the natural order per batch
+  std::vector<Eigen::MatrixXd> data(roots_.size());
+  bool discrete = false;
+  for (size_t r = 0; r < roots_.size(); ++r) {
+    const auto& vc = vinecops_[nodes_[roots_[r]].model];
+    vc.check_data(u);
+    data[r] = u;
+    vc.collapse_data_inplace(data[r]);
+    discrete = discrete || vc.is_discrete();
+    for (size_t m : nodes_[roots_[r]].done) {
+      out.col(m).setConstant(log_scale ? 0.0 : 1.0);
+    }
+  }
+
+  // the work per row is that of the distinct trees; the scratch memory that
+  // of one state per depth, since the depth-first traversal copies the state
+  // at each branch point
+  tools_batch::BatchCost cost;
+  cost.row_cost = 0.0;
+  for (const auto& node : nodes_) {
+    if (node.depth > 0) {
+      const auto& vc = vinecops_[node.model];
+      cost.row_cost += vc.get_batch_cost(node.depth, 0).row_cost -
+                       vc.get_batch_cost(node.depth - 1, 0).row_cost;
+    }
+  }
+  cost.row_cost = std::max(cost.row_cost, 1.0);
+  cost.row_bytes =
+    sizeof(double) * ((discrete ? 4 : 2) * d_ + 1) * (max_depth_ + 1);
+  auto batches = tools_batch::create_batches(
+    static_cast<size_t>(n), num_threads.get_num_threads(), cost);
+
+  // one task per batch of rows and distinct first tree
+  struct Task
+  {
+    size_t root;
+    size_t child;
+    size_t batch;
+  };
+  std::vector<Task> tasks;
+  for (size_t r = 0; r < roots_.size(); ++r) {
+    for (size_t c : nodes_[roots_[r]].children) {
+      for (size_t b = 0; b < batches.size(); ++b) {
+        tasks.push_back(Task{ r, c, b });
+      }
+    }
+  }
+
+  auto do_task = [&](const Task& task) {
+    tools_interface::check_user_interrupt();
+    const auto& b = batches[task.batch];
+    const auto& vc = vinecops_[nodes_[roots_[task.root]].model];
+    const auto& u_r = data[task.root];
+    auto order = vc.rvine_structure_.get_order();
+    auto disc_cols = tools_select::get_disc_cols(vc.var_types_);
+
+    // fill the first row of the hfunc2 matrix with the evaluation points in
+    // natural order, as in `Vinecop::pdf_full()`
+    State state;
+    state.hfunc1 = Eigen::MatrixXd::Zero(b.size, d_);
+    state.hfunc2 = Eigen::MatrixXd::Zero(b.size, d_);
+    if (vc.is_discrete()) {
+      state.hfunc1_sub = state.hfunc1;
+      state.hfunc2_sub = state.hfunc2;
+    }
+    for (size_t j = 0; j < d_; ++j) {
+      state.hfunc2.col(j) = u_r.block(b.begin, order[j] - 1, b.size, 1);
+      if (vc.var_types_[order[j] - 1] == "d") {
+        state.hfunc2_sub.col(j) =
+          u_r.block(b.begin, d_ + disc_cols[order[j] - 1], b.size, 1);
+      }
+    }
+    state.pdf = Eigen::VectorXd::Constant(b.size, log_scale ? 0.0 : 1.0);
+    evaluate_node(task.child, state, b, out, log_scale);
+  };
+  num_threads.map(do_task, tasks);
+
+  return out;
+}
+
+//! evaluates the tree of node `k` on `state`, in the order of
+//! `Vinecop::pdf_full()`, and then the subtree below it.
+inline void
+VinecopEnsemble::evaluate_node(size_t k,
+                               State& state,
+                               const tools_batch::Batch& b,
+                               Eigen::MatrixXd& out,
+                               bool log_scale) const
+{
+  const Node& node = nodes_[k];
+  const size_t tree = node.depth - 1;
+  const auto& vc = vinecops_[node.model];
+  const auto& structure = vc.rvine_structure_;
+
+  Eigen::MatrixXd u_e, u_e_sub;
+  for (size_t edge = 0; edge < d_ - tree - 1; ++edge) {
+    const Bicop& edge_copula = vc.pair_copulas_[tree][edge];
+    auto var_types = edge_copula.get_var_types();
+    size_t m = structure.min_array(tree, edge);
+    const bool from_hfunc2 = (m == structure.struct_array(tree, edge, true));
+
+    const bool discrete = (var_types[0] == "d") || (var_types[1] == "d");
+    u_e.resize(b.size, discrete ? 4 : 2);
+    u_e.col(0) = state.hfunc2.col(edge);
+    u_e.col(1) =
+      from_hfunc2 ? state.hfunc2.col(m - 1) : state.hfunc1.col(m - 1);
+    if (discrete) {
+      u_e.col(2) = state.hfunc2_sub.col(edge);
+      u_e.col(3) = from_hfunc2 ? state.hfunc2_sub.col(m - 1)
+                               : state.hfunc1_sub.col(m - 1);
+    }
+
+    if (log_scale) {
+      state.pdf += edge_copula.logpdf(u_e);
+    } else {
+      state.pdf = state.pdf.cwiseProduct(edge_copula.pdf(u_e));
+    }
+
+    if (node.needs_hfunc1[edge]) {
+      state.hfunc1.col(edge) = edge_copula.hfunc1(u_e);
+      if (var_types[1] == "d") {
+        u_e_sub = u_e;
+        u_e_sub.col(1) = u_e.col(3);
+        state.hfunc1_sub.col(edge) = edge_copula.hfunc1(u_e_sub);
+      }
+    }
+    if (node.needs_hfunc2[edge]) {
+      state.hfunc2.col(edge) = edge_copula.hfunc2(u_e);
+      if (var_types[0] == "d") {
+        u_e_sub = u_e;
+        u_e_sub.col(0) = u_e.col(2);
+        state.hfunc2_sub.col(edge) = edge_copula.hfunc2(u_e_sub);
+      }
+    }
+  }
+
+  for (size_t m : node.done) {
+    out.block(b.begin, m, b.size, 1) = state.pdf;
+  }
+  // the last child takes over the state, the others work on copies
+  for (size_t i = 0; i < node.children.size(); ++i) {
+    if (i + 1 == node.children.size()) {
+      evaluate_node(node.children[i], state, b, out, log_scale);
+    } else {
+      State copy = state;
+      evaluate_node(node.children[i], copy, b, out, log_scale);
+    }
+  }
+}
+}
@@ -217,6 +217,9 @@ inline FitControlsVinecop::FitControlsVinecop(const FitControlsConfig& config)
   if (config.conditioning_set.has_value()) {
     set_conditioning_set(*config.conditioning_set);
   }
+  if (config.screening_size.has_value()) {
+    set_screening_size(*config.screening_size);
+  }
 }
 
 //! @name Sanity checks
@@ -260,6 +263,17 @@ FitControlsVinecop::check_conditioning_set(
     throw std::runtime_error("conditioning_set must not contain duplicates");
   }
 }
+
+inline void
+FitControlsVinecop::check_screening_size(size_t screening_size)
+{
+  // the subsample is split into 10 groups, and the criteria are zero on 10
+  // or less observations
+  if ((screening_size > 0) && (screening_size < 200)) {
+    throw std::runtime_error(
+      "screening_size must be 0 (no screening) or at least 200");
+  }
+}
 //! @}
 
 //! @name Getters and setters.
@@ -402,6 +416,21 @@ FitControlsVinecop::set_conditioning_set(std::vector<size_t> conditioning_set)
   conditioning_set_ = std::move(conditioning_set);
 }
 
+//! @brief Gets the subsample size for screening the tree criteria.
+inline size_t
+FitControlsVinecop::get_screening_size() const
+{
+  return screening_size_;
+}
+
+//! @brief Sets the subsample size for screening the tree criteria.
+inline void
+FitControlsVinecop::set_screening_size(size_t screening_size)
+{
+  check_screening_size(screening_size);
+  screening_size_ = screening_size;
+}
+
 //! @brief Gets the random number generator.
 inline boost::random::mt19937
 FitControlsVinecop::get_rng() const
@@ -524,6 +553,11 @@ FitControlsVinecop::str() const
       controls_str << v << " ";
   }
   controls_str << std::endl;
+  controls_str << "Screening size: "
+               << (get_screening_size() == 0
+                     ? "none (default)"
+                     : std::to_string(get_screening_size()))
+               << std::endl;
   return controls_str.str();
 }
 
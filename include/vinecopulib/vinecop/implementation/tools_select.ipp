@@ -8,11 +8,16 @@
 #include <vinecopulib/misc/tools_stats.hpp>
 #include <vinecopulib/misc/tools_stl.hpp>
 
+#include <algorithm>
+#include <boost/container_hash/hash.hpp>
 #include <boost/graph/kruskal_min_spanning_tree.hpp>
 #include <boost/graph/prim_minimum_spanning_tree.hpp>
 #include <boost/graph/random_spanning_tree.hpp>
 #include <boost/random.hpp>
 #include <cmath>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <iostream>
 #include <unordered_set>
@@ -92,6 +97,89 @@ calculate_criterion(const Eigen::MatrixXd& data,
   return w * std::sqrt(freq);
 }
 
+//! @brief Calculates the criterion for all pairs of columns.
+//!
+//! @details Same as `calculate_criterion()` on each pair of columns, with a
+//! zero diagonal. For `"tau"`, `"rho"`, and `"joe"`, the columns without
+//! missing values are prepared once for all pairs they are part of (see
+//! `tools_stats::dependence_matrix()`). The other pairs and criteria, and all
+//! pairs if some weights are missing or zero, are evaluated one by one.
+inline Eigen::MatrixXd
+calculate_criterion_matrix(const Eigen::MatrixXd& data,
+                           const std::string& tree_criterion,
+                           const Eigen::VectorXd& weights,
+                           const TreeCriterionFunction& tree_criterion_function,
+                           const tools_thread::Executor& num_threads)
+{
+  const size_t d = static_cast<size_t>(data.cols());
+  Eigen::MatrixXd crit = Eigen::MatrixXd::Zero(d, d);
+
+  bool batched = is_member(tree_criterion, { "tau", "rho", "joe" }) &&
+                 (data.rows() > 10);
+  if (weights.size() > 0) {
+    batched = batched && !(weights.array().isNaN().any() ||
+                           (weights.array() == 0.0).any());
+  }
+  std::vector<char> is_batched(d, 0);
+  std::vector<size_t> batched_cols;
+  for (size_t j = 0; batched && (j < d); ++j) {
+    if (!data.col(j).array().isNaN().any()) {
+      is_batched[j] = 1;
+      batched_cols.push_back(j);
+    }
+  }
+  if (!batched_cols.empty()) {
+    Eigen::MatrixXd x(data.rows(), batched_cols.size());
+    for (size_t k = 0; k < batched_cols.size(); ++k) {
+      x.col(k) = data.col(batched_cols[k]);
+    }
+    Eigen::MatrixXd w;
+    if (tree_criterion == "joe") {
+      // mutual information for Gaussian copula
+      w = tools_stats::dependence_matrix(
+        tools_stats::qnorm(x), "pearson", weights, num_threads);
+      w = -0.5 * (1.0 - w.array().square()).log();
+    } else {
+      w = tools_stats::dependence_matrix(
+        x, tree_criterion, weights, num_threads);
+    }
+    for (size_t k = 0; k < batched_cols.size(); ++k) {
+      for (size_t l = 0; l < k; ++l) {
+        double w_kl = std::isnan(w(k, l)) ? 0.0 : std::fabs(w(k, l));
+        crit(batched_cols[k], batched_cols[l]) = w_kl;
+        crit(batched_cols[l], batched_cols[k]) = w_kl;
+      }
+    }
+  }
+
+  std::vector<std::pair<size_t, size_t>> pairs;
+  for (size_t i = 0; i < d; ++i) {
+    for (size_t j = 0; j < i; ++j) {
+      if (!(is_batched[i] && is_batched[j])) {
+        pairs.emplace_back(i, j);
+      }
+    }
+  }
+  auto do_pair = [&](const std::pair<size_t, size_t>& pair) {
+    Eigen::MatrixXd pair_data(data.rows(), 2);
+    pair_data << data.col(pair.first), data.col(pair.second);
+    crit(pair.first, pair.second) = calculate_criterion(
+      pair_data, tree_criterion, weights, tree_criterion_function);
+    crit(pair.second, pair.first) = crit(pair.first, pair.second);
+  };
+  // a custom criterion may not be thread safe (see
+  // `VinecopSelector::add_allowed_edges_proximity()`)
+  if (tree_criterion == "custom") {
+    for (const auto& pair : pairs) {
+      tools_interface::check_user_interrupt();
+      do_pair(pair);
+    }
+  } else {
+    num_threads.map(do_pair, pairs);
+  }
+  return crit;
+}
+
 //! computes
 inline std::vector<size_t>
 get_disc_cols(std::vector<std::string> var_types)
@@ -117,7 +205,7 @@ inline VinecopSelector::VinecopSelector(const Eigen::MatrixXd& data,
   , d_(var_types.size())
   , var_types_(std::move(var_types))
   , controls_(controls)
-  , pool_(controls_.get_num_threads())
+  , executor_(controls_.get_num_threads())
   , trees_(std::vector<VineTree>(1))
   , threshold_(controls.get_threshold())
   , psi0_(controls.get_psi0())
@@ -456,6 +544,10 @@ VinecopSelector::add_allowed_edges(VineTree& vine_tree)
 //! criterion is the exception: it is user code that the library cannot assume
 //! to be thread safe (and that the R and Python bindings may only run on the
 //! thread that entered the library), so those weights are computed serially.
+//!
+//! With `FitControlsVinecop::set_screening_size()`, the weights are first
+//! estimated on a subsample and computed on all observations only for the
+//! edges that may enter the spanning tree (see `find_mst_candidates()`).
 inline void
 VinecopSelector::add_allowed_edges_proximity(
   VineTree& vine_tree,
@@ -463,26 +555,57 @@ VinecopSelector::add_allowed_edges_proximity(
   const Eigen::VectorXd& weights,
   const TreeCriterionFunction& criterion_fun)
 {
+  // Two vertices may be connected iff their edges in the previous tree share
+  // a vertex. Group the vertices by the previous tree's vertices they are
+  // incident to; the candidates are the pairs within a group, so the work is
+  // proportional to the sum of squared degrees of the previous tree rather
+  // than to the squared number of vertices.
+  size_t num_prev_vertices = 0;
+  for (size_t v = 0; v < num_vertices(vine_tree); ++v) {
+    for (auto ei : vine_tree[v].prev_edge_indices) {
+      num_prev_vertices = std::max(num_prev_vertices, ei + 1);
+    }
+  }
+  std::vector<std::vector<size_t>> incident(num_prev_vertices);
+  for (size_t v = 0; v < num_vertices(vine_tree); ++v) {
+    for (auto ei : vine_tree[v].prev_edge_indices) {
+      incident[ei].push_back(v);
+    }
+  }
+
+  // Edges of a tree share at most one vertex, so every pair appears once.
+  // Sorting restores the insertion order of a loop over all (v0, v1 < v0),
+  // on which the spanning tree depends in case of ties.
   std::vector<std::pair<size_t, size_t>> edge_list;
-  for (size_t v0 = 0; v0 < num_vertices(vine_tree); ++v0) {
-    tools_interface::check_user_interrupt(v0 % 50 == 0);
-    for (size_t v1 = 0; v1 < v0; ++v1) {
-      if (find_common_neighbor(v0, v1, vine_tree) > -1) {
-        boost::add_edge(v0, v1, vine_tree);
-        edge_list.emplace_back(v0, v1); // ordering preserved
+  for (const auto& group : incident) {
+    for (size_t i = 1; i < group.size(); ++i) {
+      for (size_t j = 0; j < i; ++j) {
+        edge_list.emplace_back(group[i], group[j]);
       }
     }
   }
+  std::sort(edge_list.begin(), edge_list.end());
+  for (size_t k = 0; k < edge_list.size(); ++k) {
+    tools_interface::check_user_interrupt(k % 10000 == 0);
+    boost::add_edge(edge_list[k].first, edge_list[k].second, vine_tree);
+  }
 
-  std::mutex m;
-  double threshold = controls_.get_threshold();
-  auto process_edge = [&](const std::pair<size_t, size_t>& entry) {
-    size_t v0 = entry.first;
-    size_t v1 = entry.second;
+  // The first tree connects all pairs of variables; for the built-in
+  // criteria based on ranks or correlations, the columns are then prepared
+  // once for all pairs they are part of.
+  Eigen::MatrixXd crits;
+  if ((boost::num_vertices(vine_tree) == d_) &&
+      is_member(tree_criterion, { "tau", "rho", "joe" })) {
+    Eigen::MatrixXd data(n_, d_);
+    for (size_t v = 0; v < d_; ++v) {
+      data.col(v) = vine_tree[v].hfunc1;
+    }
+    crits = calculate_criterion_matrix(
+      data, tree_criterion, weights, criterion_fun, executor_);
+  }
 
-    auto pc_data = get_pc_data(v0, v1, vine_tree);
-    double crit =
-      calculate_criterion(pc_data, tree_criterion, weights, criterion_fun);
+  double threshold = controls_.get_threshold();
+  auto get_weight = [&](size_t v0, size_t v1, double crit) {
     double w = 1.0 - static_cast<double>(crit >= threshold) * crit;
 
     // Conditioning-aware selection: penalize edges that involve any
@@ -511,25 +634,171 @@ VinecopSelector::add_allowed_edges_proximity(
       if (!all_cond)
         w += static_cast<double>(d_);
     }
+    return w;
+  };
 
-    {
-      std::lock_guard<std::mutex> lk(m);
-      auto e = boost::edge(v0, v1, vine_tree).first;
-      put(boost::edge_weight, vine_tree, e, w);
-      vine_tree[e].weight = w;
-      vine_tree[e].crit = crit;
+  std::mutex m;
+  auto set_crit = [&](size_t v0, size_t v1, double crit) {
+    double w = get_weight(v0, v1, crit);
+    std::lock_guard<std::mutex> lk(m);
+    auto e = boost::edge(v0, v1, vine_tree).first;
+    put(boost::edge_weight, vine_tree, e, w);
+    vine_tree[e].weight = w;
+    vine_tree[e].crit = crit;
+  };
+
+  // Screening: the criteria are first estimated on a subsample, and only the
+  // edges that may enter the spanning tree are evaluated on all observations.
+  // (Not needed when the criteria were computed for all pairs at once.)
+  std::vector<char> needs_exact(edge_list.size(), 1);
+  const size_t screening_size = controls_.get_screening_size();
+  if ((screening_size > 0) && (n_ > screening_size) && (crits.size() == 0) &&
+      (tree_criterion != "custom") && (boost::num_vertices(vine_tree) > 2) &&
+      is_member(controls_.get_tree_algorithm(),
+                { "mst_prim", "mst_kruskal" })) {
+    // The subsample takes one observation from each of `screening_size`
+    // blocks of rows, and is dealt into groups. The criterion is estimated
+    // by the mean over the groups, its standard error by their spread.
+    const size_t num_groups = 10;
+    std::vector<std::vector<size_t>> groups(num_groups);
+    std::vector<Eigen::VectorXd> group_weights(num_groups);
+    for (size_t i = 0; i < screening_size; ++i) {
+      groups[i % num_groups].push_back((2 * i + 1) * n_ /
+                                       (2 * screening_size));
+    }
+    if (weights.size() > 0) {
+      for (size_t g = 0; g < num_groups; ++g) {
+        group_weights[g] = weights(groups[g]);
+      }
+    }
+
+    std::vector<double> approx(edge_list.size()), margin(edge_list.size());
+    executor_.map(
+      [&](size_t k) {
+        Eigen::VectorXd group_crits(num_groups);
+        for (size_t g = 0; g < num_groups; ++g) {
+          auto pc_data = get_pc_data(
+            edge_list[k].first, edge_list[k].second, vine_tree, groups[g]);
+          group_crits(g) = calculate_criterion(
+            pc_data, tree_criterion, group_weights[g], criterion_fun);
+        }
+        approx[k] = group_crits.mean();
+        double var = (group_crits.array() - approx[k]).square().sum() /
+                     static_cast<double>(num_groups - 1);
+        // four standard errors of the mean
+        margin[k] = 4.0 * std::sqrt(var / static_cast<double>(num_groups));
+      },
+      tools_stl::seq_int(0, edge_list.size()));
+
+    // The weights are non-increasing in the criteria, so the margins give
+    // bounds on the weights.
+    std::vector<double> lower(edge_list.size()), upper(edge_list.size());
+    for (size_t k = 0; k < edge_list.size(); ++k) {
+      size_t v0 = edge_list[k].first;
+      size_t v1 = edge_list[k].second;
+      lower[k] = get_weight(v0, v1, approx[k] + margin[k]);
+      upper[k] = get_weight(v0, v1, std::max(approx[k] - margin[k], 0.0));
+      set_crit(v0, v1, approx[k]);
+    }
+    needs_exact = find_mst_candidates(vine_tree, edge_list, lower, upper);
+    std::cerr << "TMPDBG " << std::count(needs_exact.begin(), needs_exact.end(), 1) << "/" << needs_exact.size() << "\n";
+  }
+
+  auto process_edge = [&](size_t k) {
+    if (!needs_exact[k]) {
+      return;
+    }
+    size_t v0 = edge_list[k].first;
+    size_t v1 = edge_list[k].second;
+    double crit = 0.0;
+    if (crits.size() > 0) {
+      crit = crits(v0, v1);
+    } else {
+      auto pc_data = get_pc_data(v0, v1, vine_tree);
+      crit =
+        calculate_criterion(pc_data, tree_criterion, weights, criterion_fun);
     }
+    set_crit(v0, v1, crit);
   };
 
   if (tree_criterion == "custom") {
-    for (const auto& edge : edge_list) {
+    for (size_t k = 0; k < edge_list.size(); ++k) {
       tools_interface::check_user_interrupt();
-      process_edge(edge);
+      process_edge(k);
     }
   } else {
-    pool_.map(process_edge, edge_list);
-    pool_.wait();
+    executor_.map(process_edge, tools_stl::seq_int(0, edge_list.size()));
+  }
+}
+
+//! @brief Finds the edges that may enter the minimum spanning tree when the
+//!   edge weights are only known to lie within bounds.
+//!
+//! An edge is left out of the minimum spanning tree if it is heavier than all
+//! edges on a path between its endpoints. Paths are taken from the spanning
+//! tree of the current edge weights (estimates), and an edge remains a
+//! candidate unless its lower bound exceeds the upper bounds along the path.
+//! @param vine_tree A vine tree whose edge weights are the estimates.
+//! @param edge_list The edges of `vine_tree`, sorted.
+//! @param lower,upper Bounds on the edge weights, in the order of
+//!   `edge_list`.
+//! @return An indicator for each edge in `edge_list`.
+inline std::vector<char>
+VinecopSelector::find_mst_candidates(
+  const VineTree& vine_tree,
+  const std::vector<std::pair<size_t, size_t>>& edge_list,
+  const std::vector<double>& lower,
+  const std::vector<double>& upper)
+{
+  auto index_of = [&](size_t v0, size_t v1) {
+    auto key = std::make_pair(std::max(v0, v1), std::min(v0, v1));
+    return static_cast<size_t>(
+      std::lower_bound(edge_list.begin(), edge_list.end(), key) -
+      edge_list.begin());
+  };
+
+  std::vector<EdgeIterator> spanning_tree;
+  kruskal_minimum_spanning_tree(vine_tree, std::back_inserter(spanning_tree));
+  size_t n_vertices = boost::num_vertices(vine_tree);
+  std::vector<std::vector<std::pair<size_t, double>>> adj(n_vertices);
+  for (auto e : spanning_tree) {
+    size_t v0 = boost::source(e, vine_tree);
+    size_t v1 = boost::target(e, vine_tree);
+    double w = upper[index_of(v0, v1)];
+    adj[v0].emplace_back(v1, w);
+    adj[v1].emplace_back(v0, w);
+  }
+
+  // edge_list is grouped by its first vertex; the heaviest upper bounds on
+  // the paths from that vertex are found with one traversal of the tree
+  std::vector<char> is_candidate(edge_list.size(), 0);
+  std::vector<double> max_upper(n_vertices);
+  std::vector<char> visited(n_vertices);
+  std::vector<size_t> stack;
+  for (size_t k = 0; k < edge_list.size();) {
+    tools_interface::check_user_interrupt();
+    size_t root = edge_list[k].first;
+    std::fill(visited.begin(), visited.end(), 0);
+    max_upper[root] = -std::numeric_limits<double>::infinity();
+    visited[root] = 1;
+    stack.assign(1, root);
+    while (!stack.empty()) {
+      size_t v = stack.back();
+      stack.pop_back();
+      for (const auto& next : adj[v]) {
+        if (!visited[next.first]) {
+          visited[next.first] = 1;
+          max_upper[next.first] = std::max(max_upper[v], next.second);
+          stack.push_back(next.first);
+        }
+      }
+    }
+    for (; (k < edge_list.size()) && (edge_list[k].first == root); ++k) {
+      is_candidate[k] = (lower[k] <= max_upper[edge_list[k].second]);
+    }
   }
+
+  return is_candidate;
 }
 
 //! @brief Adds the edges dictated by a fixed vine structure.
@@ -836,6 +1105,24 @@ VinecopSelector::get_pc_data(size_t v0, size_t v1, const VineTree& tree)
   return pc_data;
 }
 
+//! @brief Collects the pseudo-observations of a candidate edge for a subset
+//!   of the observations.
+inline Eigen::MatrixXd
+VinecopSelector::get_pc_data(size_t v0,
+                             size_t v1,
+                             const VineTree& tree,
+                             const std::vector<size_t>& rows)
+{
+  size_t ei_common = find_common_neighbor(v0, v1, tree);
+  auto pos0 = find_position(ei_common, tree[v0].prev_edge_indices);
+  auto pos1 = find_position(ei_common, tree[v1].prev_edge_indices);
+
+  Eigen::MatrixXd pc_data(rows.size(), 2);
+  pc_data.col(0) = get_hfunc(tree[v0], pos0 == 0)(rows);
+  pc_data.col(1) = get_hfunc(tree[v1], pos1 == 0)(rows);
+  return pc_data;
+}
+
 //! @brief Whether tree `t` is the last tree whose h-functions are needed.
 //!
 //! In sparse mode the loop selects one extra tree (index == trunc_lvl) for
@@ -879,7 +1166,9 @@ VinecopSelector::select_tree(size_t t)
     // only important if proximity_ was previously false (partial selection)
     structure_unknown_ = true;
   }
+  auto TMPt0 = std::chrono::steady_clock::now();
   add_allowed_edges(new_tree);
+  std::cerr << "TMPDBG time " << std::chrono::duration<double>(std::chrono::steady_clock::now() - TMPt0).count() << "\n";
   if (boost::num_vertices(new_tree) > 2) {
     select_edges(new_tree);
   }
@@ -1097,28 +1386,38 @@ VinecopSelector::find_common_neighbor(size_t v0,
                                       size_t v1,
                                       const VineTree& tree)
 {
-  auto ei0 = tree[v0].prev_edge_indices;
-  auto ei1 = tree[v1].prev_edge_indices;
-  auto ei_common = intersect(ei0, ei1);
-
-  if (ei_common.empty()) {
-    return -1;
-  } else {
-    return ei_common[0];
+  // each vertex stands for an edge, so both index vectors have two elements
+  for (auto ei0 : tree[v0].prev_edge_indices) {
+    for (auto ei1 : tree[v1].prev_edge_indices) {
+      if (ei0 == ei1) {
+        return static_cast<ptrdiff_t>(ei0);
+      }
+    }
   }
+  return -1;
 }
 
 //! @brief Computes a fit id; can be used to re-use already fitted pair-copulas.
+//!
+//! The id hashes the conditioned and conditioning sets, whether the edge is
+//! thresholded, and the bits of the pair-copula data. Two edges with the
+//! same id would be fitted to the same data with the same outcome.
 //! @param edge.
-inline double
+inline size_t
 VinecopSelector::compute_fit_id(const EdgeProperties& e)
 {
-  double id = 0.0;
+  size_t id = 0;
   if (controls_.needs_sparse_select()) {
-    // the formula is quite arbitrary, but sufficient for
-    // identifying situations where fits can be re-used
-    id = (e.pc_data.col(0) - 2 * e.pc_data.col(1)).sum();
-    id += 5.0 * static_cast<double>(e.crit < controls_.get_threshold());
+    boost::hash_combine(id, e.conditioned);
+    boost::hash_combine(id, e.conditioning);
+    boost::hash_combine(id, e.crit < controls_.get_threshold());
+    boost::hash_combine(id, e.pc_data.cols());
+    const double* x = e.pc_data.data();
+    for (Eigen::Index i = 0; i < e.pc_data.size(); ++i) {
+      uint64_t bits;
+      std::memcpy(&bits, x + i, sizeof(bits));
+      boost::hash_combine(id, bits);
+    }
   }
 
   return id;
@@ -1170,14 +1469,15 @@ VinecopSelector::remove_vertex_data(VineTree& tree)
 inline void
 VinecopSelector::fit_or_reuse_pair_copula(const EdgeIterator& e,
                                           VineTree& tree,
-                                          const VineTree& tree_opt)
+                                          const VineTree& tree_opt,
+                                          const FitIndex& fit_index)
 {
   bool is_thresholded = (tree[e].crit < controls_.get_threshold());
   bool used_old_fit = false;
 
   tree[e].fit_id = compute_fit_id(tree[e]);
-  if (boost::num_edges(tree_opt) > 0) {
-    auto old_fit = find_old_fit(tree[e].fit_id, tree_opt);
+  if (!fit_index.empty()) {
+    auto old_fit = find_old_fit(tree[e], tree_opt, fit_index);
     if (old_fit.second) { // indicates if match was found
       // data and thresholding status haven't changed,
       // we can use old fit
@@ -1190,7 +1490,7 @@ VinecopSelector::fit_or_reuse_pair_copula(const EdgeIterator& e,
     tree[e].pair_copula = vinecopulib::Bicop();
     tree[e].pair_copula.set_var_types(tree[e].var_types);
     if (!is_thresholded) {
-      tree[e].pair_copula.select(tree[e].pc_data, controls_);
+      tree[e].pair_copula.select(tree[e].pc_data, controls_, executor_);
     }
   }
 }
@@ -1222,37 +1522,55 @@ VinecopSelector::select_pair_copulas(VineTree& tree,
                                      const VineTree& tree_opt,
                                      bool last_tree)
 {
+  const FitIndex fit_index = make_fit_index(tree_opt);
   auto select_pc = [&](EdgeIterator e) -> void {
     tools_interface::check_user_interrupt();
-    fit_or_reuse_pair_copula(e, tree, tree_opt);
+    fit_or_reuse_pair_copula(e, tree, tree_opt, fit_index);
     // h-functions are only consumed by the selection of the next tree
     if (!last_tree) {
       compute_edge_hfuncs(e, tree);
     }
   };
 
-  // make sure that Bicop.select() doesn't spawn too many new threads
-  size_t num_threads = controls_.get_num_threads();
-  controls_.set_num_threads(std::max<size_t>(
-    1, num_threads / std::max<size_t>(1, boost::num_edges(tree))));
-  pool_.map(select_pc, boost::edges(tree));
-  pool_.wait();
-  controls_.set_num_threads(num_threads);
+  // the candidate fits inside Bicop::select() are submitted to the same
+  // executor, so workers done with their edges help out with the slow ones
+  executor_.map(select_pc, boost::edges(tree));
+}
+
+//! @brief Indexes the edges of a tree from the previous iteration by their
+//!   fit id.
+inline FitIndex
+VinecopSelector::make_fit_index(const VineTree& old_graph)
+{
+  FitIndex fit_index;
+  if (controls_.needs_sparse_select()) {
+    fit_index.reserve(boost::num_edges(old_graph));
+    for (auto e : boost::edges(old_graph)) {
+      fit_index.emplace(old_graph[e].fit_id, e);
+    }
+  }
+  return fit_index;
 }
 
 //! @brief Finds the fitted pair-copula from the previous iteration.
+//!
+//! An edge of the previous iteration matches if it has the same fit id and
+//! the same conditioned and conditioning sets, so that a hash collision can
+//! only lead to a false match for the same pair of variables.
 inline FoundEdge
-VinecopSelector::find_old_fit(double fit_id, const VineTree& old_graph)
+VinecopSelector::find_old_fit(const EdgeProperties& e,
+                              const VineTree& old_graph,
+                              const FitIndex& fit_index)
 {
-  auto edge = boost::edge(0, 1, old_graph).first;
-  bool fit_with_same_id = false;
-  for (auto e : boost::edges(old_graph)) {
-    if (fit_id == old_graph[e].fit_id) {
-      fit_with_same_id = true;
-      edge = e;
+  auto it = fit_index.find(e.fit_id);
+  if (it != fit_index.end()) {
+    const auto& old_e = old_graph[it->second];
+    if ((old_e.conditioned == e.conditioned) &&
+        (old_e.conditioning == e.conditioning)) {
+      return std::make_pair(it->second, true);
     }
   }
-  return std::make_pair(edge, fit_with_same_id);
+  return std::make_pair(EdgeIterator(), false);
 }
 
 //! @brief Gets edge index for the vine (like 1, 2; 3).
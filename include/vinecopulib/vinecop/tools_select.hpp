@@ -7,7 +7,9 @@
 #pragma once
 
 #include <boost/graph/adjacency_list.hpp>
+#include <unordered_map>
 #include <vinecopulib/bicop/class.hpp>
+#include <vinecopulib/misc/tools_executor.hpp>
 #include <vinecopulib/misc/tools_interface.hpp>
 #include <vinecopulib/vinecop/fit_controls.hpp>
 #include <vinecopulib/vinecop/rvine_structure.hpp>
@@ -38,6 +40,14 @@ calculate_criterion(const Eigen::MatrixXd& data,
                     const Eigen::VectorXd& weights,
                     const TreeCriterionFunction& tree_criterion_function = {});
 
+Eigen::MatrixXd
+calculate_criterion_matrix(
+  const Eigen::MatrixXd& data,
+  const std::string& tree_criterion,
+  const Eigen::VectorXd& weights,
+  const TreeCriterionFunction& tree_criterion_function = {},
+  const tools_thread::Executor& num_threads = 1);
+
 std::vector<size_t>
 get_disc_cols(std::vector<std::string> var_types);
 
@@ -68,7 +78,7 @@ struct EdgeProperties
   double weight;
   double crit;
   vinecopulib::Bicop pair_copula;
-  double fit_id;
+  size_t fit_id{ 0 };
 };
 using VineTree = boost::adjacency_list<
   boost::vecS,
@@ -79,6 +89,7 @@ using VineTree = boost::adjacency_list<
 
 using EdgeIterator = boost::graph_traits<VineTree>::edge_descriptor;
 using FoundEdge = std::pair<EdgeIterator, bool>;
+using FitIndex = std::unordered_map<size_t, EdgeIterator>;
 using WeightMap = boost::property_map<VineTree, boost::edge_weight_t>::type;
 
 class VinecopSelector
@@ -155,6 +166,12 @@ protected:
                                     const Eigen::VectorXd& weights,
                                     const TreeCriterionFunction& criterion_fun);
 
+  std::vector<char> find_mst_candidates(
+    const VineTree& vine_tree,
+    const std::vector<std::pair<size_t, size_t>>& edge_list,
+    const std::vector<double>& lower,
+    const std::vector<double>& upper);
+
   void select_edges(VineTree& vine_tree);
 
   void select_edges_mst_prim(VineTree& vine_tree);
@@ -165,6 +182,11 @@ protected:
 
   Eigen::MatrixXd get_pc_data(size_t v0, size_t v1, const VineTree& tree);
 
+  Eigen::MatrixXd get_pc_data(size_t v0,
+                              size_t v1,
+                              const VineTree& tree,
+                              const std::vector<size_t>& rows);
+
   static const Eigen::VectorXd& get_hfunc(const VertexProperties& vertex_data,
                                           bool is_first);
 
@@ -174,7 +196,7 @@ protected:
 
   ptrdiff_t find_common_neighbor(size_t v0, size_t v1, const VineTree& tree);
 
-  virtual double compute_fit_id(const EdgeProperties& e);
+  virtual size_t compute_fit_id(const EdgeProperties& e);
 
   size_t n_;
   size_t d_;
@@ -187,7 +209,7 @@ protected:
   size_t n_cond_{ 0 };
   std::vector<std::string> var_types_;
   FitControlsVinecop controls_;
-  tools_thread::ThreadPool pool_;
+  tools_thread::Executor executor_;
   std::vector<VineTree> trees_;
   RVineStructure vine_struct_;
   std::vector<std::vector<Bicop>> pair_copulas_;
@@ -243,9 +265,14 @@ protected:
 
   void fit_or_reuse_pair_copula(const EdgeIterator& e,
                                 VineTree& tree,
-                                const VineTree& tree_opt);
+                                const VineTree& tree_opt,
+                                const FitIndex& fit_index);
+
+  FitIndex make_fit_index(const VineTree& old_graph);
 
-  FoundEdge find_old_fit(double fit_id, const VineTree& old_graph);
+  FoundEdge find_old_fit(const EdgeProperties& e,
+                         const VineTree& old_graph,
+                         const FitIndex& fit_index);
 
   double get_tree_loglik(const VineTree& tree);
 
@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""Generates include/vinecopulib/misc/tools_stats_sobol.hpp.
+
+Reads the primitive polynomials and initial direction numbers of S. Joe and
+F. Y. Kuo (https://web.maths.unsw.edu.au/~fkuo/sobol/, file
+new-joe-kuo-6.21201: a header line, then one line `d s a m_1 ... m_s` per
+dimension d = 2, ..., 21201) and writes them as a base64 bit stream that
+`tools_sobol::DirectionNumberReader` decodes.
+
+Usage: python3 scripts/encode_sobol_table.py new-joe-kuo-6.21201 \\
+           include/vinecopulib/misc/tools_stats_sobol.hpp
+"""
+
+import sys
+
+ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"
+LINE_LENGTH = 76
+LINES_PER_CHUNK = 200  # 15200 characters, below MSVC's limit for a literal
+
+HEADER = """\
+// Copyright © 2016-2026 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+// Generated by scripts/encode_sobol_table.py; do not edit by hand.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vinecopulib {
+
+namespace tools_stats {
+
+namespace tools_sobol {
+
+// Maximal dimension allowed for Sobol numbers.
+#define sobol_max_dim 21201
+
+// Primitive polynomials and initial direction numbers of S. Joe and F. Y. Kuo
+// (2008) for the dimensions 2, ..., 21201, as a base64 bit stream. Per
+// dimension, most significant bit first: the degree s of the polynomial
+// (5 bits), its coefficients a (s - 1 bits), and the initial direction numbers
+// m_1, ..., m_s, which are odd and below 2^k, as (m_k - 1) / 2 (k - 1 bits).
+// The stream is split into string literals short enough for all compilers.
+static const char* const direction_numbers[] = {
+"""
+
+FOOTER = """\
+};
+
+//! @brief Reads the direction numbers of the dimensions 2, ..., 21201 in order.
+class DirectionNumberReader
+{
+public:
+  //! reads the next dimension's degree `s`, coefficients `a`, and initial
+  //! direction numbers `m`, which must have room for 18 values.
+  void next(size_t& s, size_t& a, size_t* m)
+  {
+    s = read(5);
+    a = read(s - 1);
+    for (size_t k = 0; k < s; ++k) {
+      m[k] = 2 * read(k) + 1;
+    }
+  }
+
+private:
+  size_t read(size_t num_bits)
+  {
+    while (num_buffered_ < num_bits) {
+      if (*pos_ == '\\0') {
+        pos_ = direction_numbers[++chunk_];
+      }
+      buffer_ = (buffer_ << 6) | decode(*pos_++);
+      num_buffered_ += 6;
+    }
+    num_buffered_ -= num_bits;
+    const uint64_t mask = (uint64_t{ 1 } << num_bits) - 1;
+    return static_cast<size_t>((buffer_ >> num_buffered_) & mask);
+  }
+
+  static uint64_t decode(char c)
+  {
+    if (c >= 'A' && c <= 'Z') {
+      return static_cast<uint64_t>(c - 'A');
+    } else if (c >= 'a' && c <= 'z') {
+      return static_cast<uint64_t>(c - 'a' + 26);
+    } else if (c >= '0' && c <= '9') {
+      return static_cast<uint64_t>(c - '0' + 52);
+    }
+    return (c == '+') ? 62 : 63;
+  }
+
+  size_t chunk_{ 0 };
+  const char* pos_{ direction_numbers[0] };
+  uint64_t buffer_{ 0 };
+  size_t num_buffered_{ 0 };
+};
+}
+}
+}
+"""
+
+
+def encode(rows):
+    bits = []
+
+    def write(value, num_bits):
+        if not 0 <= value < (1 << num_bits):
+            raise ValueError("value out of range")
+        bits.extend((value >> (num_bits - 1 - i)) & 1 for i in range(num_bits))
+
+    for s, a, m in rows:
+        if not 1 <= s <= 18 or len(m) != s:
+            raise ValueError("invalid degree")
+        write(s, 5)
+        write(a, s - 1)
+        for k, mk in enumerate(m):
+            if mk % 2 == 0:
+                raise ValueError("direction numbers must be odd")
+            write((mk - 1) // 2, k)
+    bits.extend([0] * (-len(bits) % 6))
+    return "".join(
+        ALPHABET[int("".join(map(str, bits[i : i + 6])), 2)]
+        for i in range(0, len(bits), 6)
+    )
+
+
+def main(source, target):
+    rows = []
+    with open(source) as f:
+        for line in f:
+            fields = line.split()
+            if not fields or not fields[0].isdigit():
+                continue
+            s, a = int(fields[1]), int(fields[2])
+            rows.append((s, a, [int(x) for x in fields[3 : 3 + s]]))
+    text = encode(rows)
+    lines = [
+        text[i : i + LINE_LENGTH] for i in range(0, len(text), LINE_LENGTH)
+    ]
+    chunks = [
+        lines[i : i + LINES_PER_CHUNK]
+        for i in range(0, len(lines), LINES_PER_CHUNK)
+    ]
+    with open(target, "w") as f:
+        f.write(HEADER)
+        for chunk in chunks:
+            f.write("".join('  "%s"\n' % line for line in chunk[:-1]))
+            f.write('  "%s",\n' % chunk[-1])
+        f.write(FOOTER)
+
+
+if __name__ == "__main__":
+    main(*sys.argv[1:3])
@@ -372,6 +372,58 @@ TEST_P(ParBicopTest, per_row_parameters_match_loop)
   }
 }
 
+// The log-density (closed form for some families, log(pdf) for the others)
+// agrees with the logarithm of the density, on the fixed and per-row paths.
+TEST_P(ParBicopTest, logpdf_matches_log_of_pdf)
+{
+  if (!needs_check_)
+    return;
+
+  Eigen::MatrixXd u = bicop_.simulate(200, false, { 1, 2, 3 });
+  Eigen::VectorXd ref = bicop_.pdf(u).array().log();
+  ASSERT_TRUE(all_close(bicop_.logpdf(u), ref, 1e-8, 1e-8)) << bicop_.str();
+  ASSERT_NEAR(bicop_.loglik(u), ref.sum(), 1e-8 * (1.0 + std::abs(ref.sum())))
+    << bicop_.str();
+
+  if (bicop_.get_parameters().size() > 0) {
+    Eigen::MatrixXd P = bicop_.get_parameters().transpose().replicate(200, 1);
+    ASSERT_TRUE(all_close(bicop_.logpdf(u, P, 2), ref, 1e-8, 1e-8))
+      << bicop_.str();
+  }
+
+  // missing values propagate
+  u(0, 0) = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_TRUE((std::isnan)(bicop_.logpdf(u)(0))) << bicop_.str();
+}
+
+// The tabulated inverse h-functions approximate the exact ones, and
+// polishing by Newton steps recovers their accuracy. Families with other
+// inverses ignore the setting.
+TEST_P(ParBicopTest, tabulated_hinv_matches_exact)
+{
+  if (!needs_check_)
+    return;
+
+  Eigen::MatrixXd u = tools_stats::simulate_uniform(500, 2, false, { 1, 2 });
+  u(0, 0) = std::numeric_limits<double>::quiet_NaN();
+  u(1, 1) = 1e-9; // outside of the table
+  const Eigen::VectorXd hinv1 = bicop_.hinv1(u);
+  const Eigen::VectorXd hinv2 = bicop_.hinv2(u);
+
+  Bicop bc = bicop_;
+  bc.set_hinv_method(HinvMethod::table);
+  EXPECT_TRUE(all_close(bc.hinv1(u), hinv1, 0.0, 2e-2)) << bc.str();
+  EXPECT_TRUE(all_close(bc.hinv2(u), hinv2, 0.0, 2e-2)) << bc.str();
+
+  bc.set_hinv_method(HinvMethod::table_newton);
+  EXPECT_TRUE(all_close(bc.hinv1(u), hinv1, 0.0, 1e-9)) << bc.str();
+  EXPECT_TRUE(all_close(bc.hinv2(u), hinv2, 0.0, 1e-9)) << bc.str();
+
+  Bicop copy = bc;
+  EXPECT_EQ(copy.get_hinv_method(), HinvMethod::table_newton);
+  EXPECT_TRUE(all_close(copy.hinv1(u), hinv1, 0.0, 1e-9)) << bc.str();
+}
+
 // Simulation with one parameter set per observation: the sample is the
 // inverse Rosenblatt transform of the same uniforms the fixed-parameter
 // overload would draw, evaluated at each observation's own parameters.
@@ -1161,6 +1213,32 @@ TEST(BicopPerRowParameters, independence_zero_parameters)
 }
 
 // Degenerate families and overload resolution for the per-row simulate().
+// The table follows the parameters, per-row parameters bypass it, and
+// selection keeps the method.
+TEST(BicopHinvMethod, follows_parameters_and_selection)
+{
+  Eigen::MatrixXd u = tools_stats::simulate_uniform(200, 2, false, { 1 });
+  Bicop bc(BicopFamily::bb1, 0, Eigen::Vector2d(0.5, 1.5));
+  bc.set_hinv_method(HinvMethod::table_newton);
+  bc.hinv1(u);
+
+  Eigen::Vector2d par(2.0, 3.0);
+  bc.set_parameters(par);
+  Bicop exact(BicopFamily::bb1, 0, par);
+  EXPECT_TRUE(all_close(bc.hinv1(u), exact.hinv1(u), 0.0, 1e-9));
+
+  Eigen::MatrixXd P = par.transpose().replicate(200, 1);
+  P(0, 0) = 0.5;
+  EXPECT_TRUE(all_close(bc.hinv1(u, P), exact.hinv1(u, P), 0.0, 0.0));
+
+  bc.set_hinv_method(HinvMethod::exact);
+  EXPECT_TRUE(all_close(bc.hinv1(u), exact.hinv1(u), 0.0, 0.0));
+
+  bc.set_hinv_method(HinvMethod::table);
+  bc.select(exact.simulate(500, false, { 1 }));
+  EXPECT_EQ(bc.get_hinv_method(), HinvMethod::table);
+}
+
 TEST(BicopSimulate, per_row_parameters_edge_cases)
 {
   // nonparametric families have no per-observation parameter vector
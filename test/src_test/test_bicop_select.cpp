@@ -24,6 +24,19 @@ TEST(bicop_select, works_in_parallel)
   EXPECT_EQ(fit1.get_parameters(), fit2.get_parameters());
 }
 
+TEST(bicop_select, works_on_a_shared_executor)
+{
+  Bicop cop(BicopFamily::clayton, 90, Eigen::VectorXd::Constant(1, 2.0));
+  auto u = cop.simulate(100, false, { 1 });
+  Bicop fit1, fit2;
+  fit1.select(u);
+  tools_thread::ThreadPool pool(2);
+  fit2.select(u, FitControlsBicop(), tools_thread::Executor(pool));
+  EXPECT_EQ(fit1.get_family(), fit2.get_family());
+  EXPECT_EQ(fit1.get_rotation(), fit2.get_rotation());
+  EXPECT_EQ(fit1.get_parameters(), fit2.get_parameters());
+}
+
 TEST(bicop_select, allows_all_selcrits)
 {
   Bicop cop(BicopFamily::gaussian, 0, Eigen::VectorXd::Constant(1, -0.5));
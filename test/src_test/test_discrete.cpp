@@ -380,6 +380,42 @@ TEST(discrete, d_d_degenerate_branch_uses_the_atom_midpoint)
               1e-12);
 }
 
+// The discrete leaves evaluate each branch (difference quotient, collapsed
+// atom, midpoint density) once on all rows taking it. Rows in different
+// branches of one call, with per-row parameters, must give the same values as
+// evaluating them one at a time.
+TEST(discrete, mixed_branches_match_row_by_row)
+{
+  auto bicop = Bicop(BicopFamily::student, 0, Eigen::Vector2d(0.4, 5));
+  auto u = bicop.simulate(40, false, { 1 });
+  const double narrow = 4e-5;
+  Eigen::MatrixXd u_disc(u.rows(), 4);
+  Eigen::MatrixXd par(u.rows(), 2);
+  for (Eigen::Index i = 0; i < u.rows(); ++i) {
+    // cycle through: both atoms wide, first narrow, second narrow, both narrow
+    const double w1 = (i % 4 == 1 || i % 4 == 3) ? narrow : 0.2;
+    const double w2 = (i % 4 == 2 || i % 4 == 3) ? narrow : 0.2;
+    u_disc.row(i) << u(i, 0), u(i, 1), std::max(u(i, 0) - w1, 0.0),
+      std::max(u(i, 1) - w2, 0.0);
+    par.row(i) << -0.5 + 0.025 * i, 3 + 0.5 * i;
+  }
+
+  for (const auto& var_types : std::vector<std::vector<std::string>>{
+         { "d", "d" }, { "c", "d" }, { "d", "c" } }) {
+    bicop.set_var_types(var_types);
+    Eigen::VectorXd pdf = bicop.pdf(u_disc, par);
+    Eigen::VectorXd h1 = bicop.hfunc1(u_disc, par);
+    Eigen::VectorXd h2 = bicop.hfunc2(u_disc, par);
+    for (Eigen::Index i = 0; i < u.rows(); ++i) {
+      const Eigen::MatrixXd ui = u_disc.row(i);
+      const Eigen::MatrixXd pi = par.row(i);
+      EXPECT_NEAR(pdf(i), bicop.pdf(ui, pi)(0), 1e-10) << bicop.str();
+      EXPECT_NEAR(h1(i), bicop.hfunc1(ui, pi)(0), 1e-10) << bicop.str();
+      EXPECT_NEAR(h2(i), bicop.hfunc2(ui, pi)(0), 1e-10) << bicop.str();
+    }
+  }
+}
+
 // Regression test for PR #700: the per-row parameter evaluation in the
 // discrete leaves (pdf_c_d, pdf_d_d and the discrete branches of hfunc1 /
 // hfunc2) must not index the parameter matrix row-by-row for families whose
@@ -8,6 +8,7 @@
 #include "gtest/gtest.h"
 #include <algorithm>
 #include <vinecopulib.hpp>
+#include <vinecopulib/misc/tools_stats_sobol.hpp>
 
 namespace test_tools_stats {
 
@@ -243,6 +244,19 @@ TEST(test_tools_stats, dpt_are_nan_safe)
   EXPECT_NO_THROW(tools_stats::qt(tools_stats::pt(X, nu), nu));
 }
 
+TEST(test_tools_stats, dt_matches_boost)
+{
+  Eigen::VectorXd X = Eigen::VectorXd::LinSpaced(1000, -50, 50);
+  for (double nu : { 2.0, 2.5, 4.0, 10.3, 50.0 }) {
+    boost::math::students_t dist(nu);
+    auto f = [&dist](double y) { return boost::math::pdf(dist, y); };
+    EXPECT_TRUE(all_close(
+      tools_stats::dt(X, nu), tools_eigen::unaryExpr_or_nan(X, f), 1e-12));
+  }
+  X(0) = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_TRUE(std::isnan(tools_stats::dt(X, 4.0)(0)));
+}
+
 TEST(test_tools_stats, pbvt_and_pbvnorm_are_nan_safe)
 {
   Eigen::MatrixXd X = Eigen::MatrixXd::Random(10, 2);
@@ -472,4 +486,208 @@ TEST(test_tools_stats, golden_pseudo_obs)
     }
   }
 }
+
+TEST(test_tools_stats, dominance_index_matches_scan)
+{
+  for (Eigen::Index d : { 1, 2, 3, 5 }) {
+    Eigen::MatrixXd x = tools_stats::simulate_uniform(2000, d, false, { 3 });
+    // ties within and across points
+    x.topRows(500) = (x.topRows(500) * 10).array().round() / 10;
+    Eigen::MatrixXd q(300, d);
+    q.topRows(100) = x.topRows(100);
+    q.bottomRows(200) =
+      1.2 * tools_stats::simulate_uniform(200, d, false, { 4 }).array() - 0.1;
+
+    tools_stats::DominanceIndex index(x);
+    EXPECT_EQ(index.size(), 2000u);
+    Eigen::VectorXd counts = index.count(q);
+    for (Eigen::Index i = 0; i < q.rows(); ++i) {
+      Eigen::RowVectorXd qi = q.row(i);
+      double expected = static_cast<double>(
+        ((x.rowwise() - qi).rowwise().maxCoeff().array() <= 0.0).count());
+      ASSERT_EQ(counts(i), expected) << "d = " << d << ", query " << i;
+    }
+  }
+
+  tools_stats::DominanceIndex index(Eigen::MatrixXd::Ones(10, 3));
+  Eigen::MatrixXd q(2, 3);
+  q << 1, 1, NAN, 1, 1, 1;
+  Eigen::VectorXd counts = index.count(q);
+  EXPECT_TRUE((std::isnan)(counts(0)));
+  EXPECT_EQ(counts(1), 10.0);
+  EXPECT_ANY_THROW(index.count(Eigen::MatrixXd::Ones(1, 2)));
+}
+
+TEST(test_tools_stats, invert_f_illinois_matches_bisection)
+{
+  // row i inverts v^(i % 5 + 1), plus a point outside either end and a NaN
+  const Eigen::Index n = 500;
+  Eigen::VectorXd x = tools_stats::simulate_uniform(n, 1, false, { 5 });
+  x(0) = -1.0;
+  x(1) = 2.0;
+  x(2) = NAN;
+  Eigen::VectorXd power(n);
+  for (Eigen::Index i = 0; i < n; ++i) {
+    power(i) = static_cast<double>(i % 5 + 1);
+  }
+
+  size_t num_evals = 0;
+  auto eval = [&](const std::vector<Eigen::Index>& rows,
+                  const Eigen::Ref<const Eigen::VectorXd>& v,
+                  Eigen::Ref<Eigen::VectorXd> f_out) {
+    for (size_t k = 0; k < rows.size(); ++k) {
+      const auto kk = static_cast<Eigen::Index>(k);
+      // never evaluated at the bounds themselves
+      EXPECT_TRUE(v(kk) > 1e-20 && v(kk) < 1 - 1e-20);
+      f_out(kk) = std::pow(v(kk), power(rows[k]));
+    }
+    num_evals += rows.size();
+  };
+  Eigen::VectorXd v = tools_eigen::invert_f_illinois(x, eval);
+
+  auto f = [&](const Eigen::VectorXd& v) {
+    return v.array().pow(power.array()).matrix().eval();
+  };
+  Eigen::VectorXd v_bisection = tools_eigen::invert_f(x, f);
+
+  EXPECT_NEAR(v(0), 0.0, 1e-11);
+  EXPECT_NEAR(v(1), 1.0, 1e-11);
+  EXPECT_TRUE((std::isnan)(v(2)));
+  EXPECT_TRUE(all_close(v.tail(n - 3), v_bisection.tail(n - 3), 0.0, 1e-9));
+  EXPECT_LT(num_evals, static_cast<size_t>(35 * n / 2));
+}
+
+TEST(test_tools_stats, uniform_stream_matches_simulate_uniform)
+{
+  // d = 301 uses the Sobol sequence, d = 3 the generalized Halton sequence
+  for (size_t d : { size_t(3), size_t(301) }) {
+    for (bool qrng : { false, true }) {
+      Eigen::MatrixXd expected =
+        tools_stats::simulate_uniform(100, d, qrng, { 5 });
+      tools_stats::UniformStream stream(100, d, qrng, { 5 });
+      Eigen::MatrixXd u(100, d);
+      for (size_t size : { 1, 30, 7, 64, 64 }) {
+        const auto begin = static_cast<Eigen::Index>(stream.position());
+        Eigen::MatrixXd block = stream.next(size);
+        u.middleRows(begin, block.rows()) = block;
+      }
+      EXPECT_EQ(stream.position(), 100u);
+      EXPECT_EQ(stream.next(10).rows(), 0);
+      EXPECT_TRUE(all_close(u, expected, 0.0, 0.0));
+    }
+  }
+  EXPECT_ANY_THROW(tools_stats::UniformStream(0, 2));
+}
+
+TEST(test_tools_stats, qrng_sequences_extend_samples)
+{
+  for (size_t d : { size_t(1), size_t(5), size_t(360) }) {
+    Eigen::MatrixXd expected = tools_stats::ghalton(300, d, { 5 });
+    tools_stats::GhaltonSequence sequence(d, { 5 });
+    Eigen::MatrixXd u(300, d);
+    u.topRows(100) = sequence.next(100);
+    u.bottomRows(200) = sequence.next(200);
+    EXPECT_EQ(sequence.position(), 300u);
+    EXPECT_TRUE(all_close(u, expected, 0.0, 0.0));
+    sequence.skip(700);
+    EXPECT_TRUE(all_close(
+      sequence.next(50), tools_stats::ghalton(50, d, { 5 }, 1000), 0.0, 0.0));
+  }
+  for (size_t d : { size_t(1), size_t(5), size_t(400) }) {
+    Eigen::MatrixXd expected = tools_stats::sobol(300, d, { 5 });
+    tools_stats::SobolSequence sequence(d, { 5 });
+    Eigen::MatrixXd u(300, d);
+    u.topRows(100) = sequence.next(100);
+    u.bottomRows(200) = sequence.next(200);
+    EXPECT_EQ(sequence.position(), 300u);
+    EXPECT_TRUE(all_close(u, expected, 0.0, 0.0));
+    sequence.skip(700);
+    EXPECT_TRUE(all_close(
+      sequence.next(50), tools_stats::sobol(50, d, { 5 }, 1000), 0.0, 0.0));
+  }
+  EXPECT_ANY_THROW(tools_stats::GhaltonSequence(361));
+  EXPECT_ANY_THROW(tools_stats::SobolSequence(0));
+  tools_stats::SobolSequence sequence(2, { 5 });
+  sequence.skip((size_t(1) << 32) - 1);
+  EXPECT_EQ(sequence.next(1).rows(), 1);
+  EXPECT_ANY_THROW(sequence.next(1));
+}
+
+TEST(test_tools_stats, sobol_direction_numbers_decode)
+{
+  tools_stats::tools_sobol::DirectionNumberReader reader;
+  size_t s, a, m[18];
+  reader.next(s, a, m);
+  EXPECT_EQ(s, 1u);
+  EXPECT_EQ(a, 0u);
+  EXPECT_EQ(m[0], 1u);
+  for (size_t j = 1; j < sobol_max_dim - 1; ++j) {
+    reader.next(s, a, m);
+  }
+  // the last dimension of the table of Joe and Kuo
+  std::vector<size_t> m_last = { 1,    1,     7,     11,    15,     7,
+                                 37,   239,   337,   245,   1557,   3681,
+                                 7357, 9639,  27367, 26869, 114603, 86317 };
+  EXPECT_EQ(s, 18u);
+  EXPECT_EQ(a, 131059u);
+  EXPECT_EQ(std::vector<size_t>(m, m + 18), m_last);
+}
+
+TEST(test_tools_stats, simulate_uniform_rows_matches_simulate_uniform)
+{
+  for (size_t d : { size_t(3), size_t(301) }) {
+    for (bool qrng : { false, true }) {
+      Eigen::MatrixXd expected =
+        tools_stats::simulate_uniform(100, d, qrng, { 5 });
+      // blocks in reverse order, each simulated on its own
+      Eigen::MatrixXd u(100, d);
+      std::vector<std::pair<size_t, size_t>> blocks = {
+        { 93, 7 }, { 40, 53 }, { 1, 39 }, { 0, 1 }
+      };
+      for (const auto& b : blocks) {
+        u.middleRows(b.first, b.second) = tools_stats::simulate_uniform_rows(
+          100, d, b.first, b.second, qrng, { 5 });
+      }
+      EXPECT_TRUE(all_close(u, expected, 0.0, 0.0));
+    }
+  }
+  EXPECT_ANY_THROW(tools_stats::simulate_uniform_rows(10, 2, 5, 6));
+  EXPECT_ANY_THROW(tools_stats::simulate_uniform_rows(10, 2, 0, 0));
+}
+
+// The all-pairs measures agree with the pairwise ones, with ties (discrete
+// columns) and weights.
+TEST(test_tools_stats, dependence_matrix_matches_wdm)
+{
+  Eigen::MatrixXd x = tools_stats::simulate_uniform(500, 6, false, { 7 });
+  x.col(1) += x.col(0);
+  x.col(2) = (x.col(2) * 5).array().floor();
+  x.col(3) = (x.col(3) + x.col(2) / 5).array().round();
+  const Eigen::VectorXd weights =
+    tools_stats::simulate_uniform(500, 1, false, { 8 }).col(0);
+
+  for (const std::string method : { "tau", "rho", "pearson" }) {
+    for (size_t num_threads : { 1, 3 }) {
+      auto m = tools_stats::dependence_matrix(x, method, {}, num_threads);
+      auto mw = tools_stats::dependence_matrix(x, method, weights, num_threads);
+      for (Eigen::Index i = 0; i < x.cols(); ++i) {
+        EXPECT_DOUBLE_EQ(m(i, i), 1.0);
+        for (Eigen::Index j = 0; j < i; ++j) {
+          Eigen::MatrixXd pair(x.rows(), 2);
+          pair << x.col(i), x.col(j);
+          EXPECT_NEAR(m(i, j), wdm::wdm(pair, method)(0, 1), 1e-12);
+          EXPECT_DOUBLE_EQ(m(i, j), m(j, i));
+          // weighted rank measures are only compared without ties
+          if ((method == "pearson") || ((i < 2) && (j < 2))) {
+            EXPECT_NEAR(
+              mw(i, j), wdm::wdm(pair, method, weights)(0, 1), 1e-12);
+          }
+        }
+      }
+    }
+  }
+  x(0, 0) = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_ANY_THROW(tools_stats::dependence_matrix(x, "tau"));
+  EXPECT_ANY_THROW(tools_stats::dependence_matrix(x.rightCols(2), "hoeffd"));
+}
 }
@@ -0,0 +1,260 @@
+// Copyright © 2016-2026 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <vinecopulib.hpp>
+#include <vinecopulib/misc/tools_executor.hpp>
+#include <vinecopulib/misc/tools_thread_stealing.hpp>
+
+namespace test_tools_thread {
+
+using namespace vinecopulib;
+
+TEST(test_tools_thread, executor_serial_runs_in_calling_thread)
+{
+  std::vector<size_t> order;
+  auto id = std::this_thread::get_id();
+  bool same_thread = true;
+  tools_thread::Executor(1).map(
+    [&](size_t i) {
+      same_thread &= (std::this_thread::get_id() == id);
+      order.push_back(i);
+    },
+    tools_stl::seq_int(0, 10));
+  EXPECT_TRUE(same_thread);
+  EXPECT_EQ(order, tools_stl::seq_int(0, 10));
+}
+
+TEST(test_tools_thread, executor_uses_global_pool)
+{
+  tools_thread::Executor ex(4);
+  EXPECT_EQ(ex.get_num_threads(), 4u);
+  EXPECT_EQ(tools_thread::Executor(0).get_num_threads(), 1u);
+  EXPECT_EQ(&tools_thread::Executor::get_global_pool(),
+            &tools_thread::Executor::get_global_pool());
+
+  std::vector<int> hits(100, 0);
+  ex.map([&](size_t i) { hits[i]++; }, tools_stl::seq_int(0, 100));
+  ex.map([&](size_t i) { hits[i]++; }, tools_stl::seq_int(0, 100));
+  for (auto h : hits)
+    EXPECT_EQ(h, 2);
+}
+
+TEST(test_tools_thread, executor_nested_map_on_shared_pool)
+{
+  // more nested tasks than workers: the callers must help out, otherwise the
+  // outer tasks would block all workers while waiting for the inner ones
+  tools_thread::ThreadPool pool(2);
+  tools_thread::Executor ex(pool);
+  std::atomic<size_t> count{ 0 };
+  ex.map(
+    [&](size_t) {
+      ex.map([&](size_t) { count++; }, tools_stl::seq_int(0, 8));
+    },
+    tools_stl::seq_int(0, 8));
+  EXPECT_EQ(count.load(), 64u);
+}
+
+TEST(test_tools_thread, executor_nested_maps_share_thread_budget)
+{
+  tools_thread::ThreadPool pool(6);
+  tools_thread::Executor ex(pool, 3);
+  std::atomic<size_t> active{ 0 }, max_active{ 0 }, count{ 0 };
+  auto work = [&](size_t) {
+    size_t now = ++active;
+    size_t prev = max_active.load();
+    while ((now > prev) && !max_active.compare_exchange_weak(prev, now)) {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    count++;
+    active--;
+  };
+  ex.map([&](size_t) { ex.map(work, tools_stl::seq_int(0, 6)); },
+         tools_stl::seq_int(0, 6));
+  EXPECT_EQ(count.load(), 36u);
+  EXPECT_LE(max_active.load(), 3u);
+}
+
+TEST(test_tools_thread, executor_rethrows_and_stays_usable)
+{
+  tools_thread::ThreadPool pool(2);
+  tools_thread::Executor ex(pool);
+  auto f = [](size_t i) {
+    if (i == 3)
+      throw std::runtime_error("task failed");
+  };
+  EXPECT_THROW(ex.map(f, tools_stl::seq_int(0, 10)), std::runtime_error);
+
+  std::atomic<size_t> count{ 0 };
+  ex.map([&](size_t) { count++; }, tools_stl::seq_int(0, 10));
+  EXPECT_EQ(count.load(), 10u);
+}
+
+TEST(test_tools_thread, cost_aware_batches_cover_all_rows)
+{
+  auto check_cover = [](const std::vector<tools_batch::Batch>& batches,
+                        size_t n) {
+    size_t next = 0;
+    for (const auto& b : batches) {
+      EXPECT_EQ(b.begin, next);
+      next += b.size;
+    }
+    EXPECT_EQ(next, n);
+  };
+
+  // cheap rows are not split below the minimal batch cost
+  tools_batch::BatchCost cheap;
+  auto batches = tools_batch::create_batches(1000, 8, cheap);
+  EXPECT_EQ(batches.size(), 1u);
+  check_cover(batches, 1000);
+
+  // expensive rows are spread over several batches per thread
+  tools_batch::BatchCost expensive;
+  expensive.row_cost = 1e4;
+  batches = tools_batch::create_batches(1000, 8, expensive);
+  EXPECT_EQ(batches.size(), 32u);
+  check_cover(batches, 1000);
+
+  // scratch memory per batch stays within the cache target
+  expensive.row_bytes = 64 * 1024;
+  expensive.min_rows = 1;
+  batches = tools_batch::create_batches(1000, 1, expensive);
+  EXPECT_EQ(batches.size(), 250u);
+  for (const auto& b : batches)
+    EXPECT_LE(b.size * expensive.row_bytes, expensive.cache_bytes);
+  check_cover(batches, 1000);
+
+  EXPECT_EQ(tools_batch::create_batches(0, 4, cheap).size(), 1u);
+  EXPECT_EQ(tools_batch::create_batches(3, 4, expensive).size(), 3u);
+}
+
+TEST(test_tools_thread, work_stealing_deque_pop_and_steal)
+{
+  using Task = tools_thread::WorkStealingDeque::Task;
+  tools_thread::WorkStealingDeque deque(2); // forces the buffer to grow
+  std::vector<size_t> order;
+  for (size_t i = 0; i < 10; ++i)
+    deque.push(new Task([&order, i] { order.push_back(i); }));
+
+  // the owner takes the newest job, thieves take the oldest
+  for (Task* task : { deque.pop(), deque.steal(), deque.pop() }) {
+    (*task)();
+    delete task;
+  }
+  EXPECT_EQ(order, (std::vector<size_t>{ 9, 0, 8 }));
+  while (Task* task = deque.steal()) {
+    (*task)();
+    delete task;
+  }
+  EXPECT_TRUE(deque.empty());
+  EXPECT_EQ(order.size(), 10u);
+  EXPECT_EQ(deque.pop(), nullptr);
+}
+
+TEST(test_tools_thread, work_stealing_deque_concurrent_steals)
+{
+  // every job must be taken exactly once, by the owner or by a thief
+  using Task = tools_thread::WorkStealingDeque::Task;
+  const size_t n = 20000;
+  tools_thread::WorkStealingDeque deque;
+  std::vector<std::atomic<int>> taken(n);
+  std::atomic<bool> done{ false };
+  auto steal_all = [&] {
+    while (!done || !deque.empty()) {
+      if (Task* task = deque.steal()) {
+        (*task)();
+        delete task;
+      }
+    }
+  };
+  std::vector<std::thread> thieves;
+  for (size_t k = 0; k < 3; ++k)
+    thieves.emplace_back(steal_all);
+  for (size_t i = 0; i < n; ++i) {
+    deque.push(new Task([&taken, i] { taken[i]++; }));
+    if (i % 3 == 0) {
+      if (Task* task = deque.pop()) {
+        (*task)();
+        delete task;
+      }
+    }
+  }
+  done = true;
+  for (auto& thief : thieves)
+    thief.join();
+  EXPECT_TRUE(std::all_of(
+    taken.begin(), taken.end(), [](const auto& t) { return t == 1; }));
+}
+
+TEST(test_tools_thread, work_stealing_pool_runs_all_jobs)
+{
+  tools_thread::WorkStealingPool pool(3);
+  EXPECT_EQ(pool.get_num_workers(), 3u);
+  std::atomic<size_t> count{ 0 };
+  for (size_t rep = 0; rep < 5; ++rep) {
+    pool.map([&](size_t) { count++; }, tools_stl::seq_int(0, 1000));
+    pool.wait();
+    EXPECT_EQ(count.load(), 1000 * (rep + 1));
+  }
+
+  // jobs pushed from jobs go to the worker's own deque
+  count = 0;
+  for (size_t i = 0; i < 10; ++i) {
+    pool.push([&] {
+      for (size_t j = 0; j < 10; ++j)
+        pool.push([&] { count++; });
+    });
+  }
+  pool.wait();
+  EXPECT_EQ(count.load(), 100u);
+
+  // without workers, jobs run in the calling thread
+  tools_thread::WorkStealingPool serial(0);
+  auto id = std::this_thread::get_id();
+  serial.push([&] { EXPECT_EQ(std::this_thread::get_id(), id); });
+  serial.wait();
+}
+
+TEST(test_tools_thread, work_stealing_pool_rethrows_and_stays_usable)
+{
+  tools_thread::WorkStealingPool pool(2);
+  pool.map(
+    [](size_t i) {
+      if (i == 3)
+        throw std::runtime_error("job failed");
+    },
+    tools_stl::seq_int(0, 10));
+  EXPECT_THROW(pool.wait(), std::runtime_error);
+
+  std::atomic<size_t> count{ 0 };
+  pool.map([&](size_t) { count++; }, tools_stl::seq_int(0, 10));
+  EXPECT_NO_THROW(pool.wait());
+  EXPECT_EQ(count.load(), 10u);
+
+  pool.join();
+  EXPECT_THROW(pool.push([] {}), std::runtime_error);
+}
+
+TEST(test_tools_thread, executor_nested_map_on_work_stealing_pool)
+{
+  tools_thread::WorkStealingPool pool(2);
+  tools_thread::Executor ex(pool);
+  std::atomic<size_t> count{ 0 };
+  ex.map(
+    [&](size_t) {
+      ex.map([&](size_t) { count++; }, tools_stl::seq_int(0, 8));
+    },
+    tools_stl::seq_int(0, 8));
+  EXPECT_EQ(count.load(), 64u);
+}
+
+}
@@ -6,6 +6,9 @@
 
 #include "include/test_utils.hpp"
 #include "include/vinecop_test.hpp"
+#include <atomic>
+#include <cfloat>
+#include <cstdlib>
 #include <future>
 #include <mutex>
 #include <set>
@@ -14,6 +17,37 @@
 #include <vinecopulib.hpp>
 #include <vinecopulib/misc/tools_stl.hpp>
 
+// Counts heap allocations by interposing glibc's malloc (Eigen allocates
+// through it, and so does operator new). Sanitizers bring their own allocator,
+// so the count is not available under them.
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define VINECOPULIB_NO_MALLOC_COUNT
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer)
+#define VINECOPULIB_NO_MALLOC_COUNT
+#endif
+#endif
+
+#if defined(__GLIBC__) && !defined(VINECOPULIB_NO_MALLOC_COUNT)
+#define VINECOPULIB_MALLOC_COUNT
+extern "C" void*
+__libc_malloc(size_t size);
+
+namespace {
+std::atomic<bool> count_mallocs{ false };
+std::atomic<size_t> num_mallocs{ 0 };
+}
+
+extern "C" void*
+malloc(size_t size) noexcept
+{
+  if (count_mallocs.load(std::memory_order_relaxed)) {
+    num_mallocs.fetch_add(1, std::memory_order_relaxed);
+  }
+  return __libc_malloc(size);
+}
+#endif
+
 namespace test_vinecop_class {
 using namespace vinecopulib;
 using test_utils::all_close;
@@ -2278,6 +2312,315 @@ TEST_F(VinecopTest, works_multi_threaded)
   fit2.cdf(u, 100, 2, { 1 });
 }
 
+TEST(VinecopThreading, reuses_a_caller_owned_pool)
+{
+  auto pcs = Vinecop::make_pair_copula_store(5);
+  for (auto& tree : pcs) {
+    for (auto& pc : tree) {
+      pc = Bicop(BicopFamily::clayton, 0, Eigen::MatrixXd::Constant(1, 1, 2.0));
+    }
+  }
+  Vinecop vc(DVineStructure({ 1, 2, 3, 4, 5 }), pcs);
+  auto u = vc.simulate(200, false, 1, { 42 });
+
+  tools_thread::ThreadPool pool(2);
+  for (size_t rep = 0; rep < 3; ++rep) {
+    EXPECT_TRUE(all_close(vc.pdf(u, pool), vc.pdf(u), 1e-12));
+    EXPECT_TRUE(all_close(vc.rosenblatt(u, pool), vc.rosenblatt(u), 1e-12));
+    EXPECT_TRUE(all_close(
+      vc.inverse_rosenblatt(u, pool), vc.inverse_rosenblatt(u), 1e-12));
+    EXPECT_TRUE(all_close(vc.scores(u, true, pool), vc.scores(u), 1e-12));
+  }
+  // a pool-bound executor may cap the number of tasks in flight
+  tools_thread::Executor capped(pool, 2);
+  EXPECT_EQ(capped.get_num_threads(), 2u);
+  EXPECT_NEAR(vc.loglik(u, capped), vc.loglik(u), 1e-8);
+
+  Vinecop vc_fit(vc.get_rvine_structure(), pcs);
+  vc_fit.fit(u, FitControlsBicop(), pool);
+  Vinecop vc_fit_serial(vc.get_rvine_structure(), pcs);
+  vc_fit_serial.fit(u, FitControlsBicop());
+  EXPECT_NEAR(vc_fit.get_loglik(), vc_fit_serial.get_loglik(), 1e-8);
+}
+
+TEST(VinecopThreading, cost_aware_batches_match_serial)
+{
+  // large enough for several batches both serially and in parallel
+  auto pcs = Vinecop::make_pair_copula_store(10);
+  for (auto& tree : pcs) {
+    for (auto& pc : tree) {
+      pc = Bicop(BicopFamily::gumbel, 0, Eigen::MatrixXd::Constant(1, 1, 1.5));
+    }
+  }
+  Vinecop vc(DVineStructure(tools_stl::seq_int(1, 10)), pcs);
+  auto u = vc.simulate(2000, false, 1, { 3 });
+
+  tools_thread::ThreadPool pool(2);
+  tools_thread::Executor ex(pool, 3);
+  EXPECT_TRUE(all_close(vc.pdf(u, ex), vc.pdf(u), 1e-12));
+  EXPECT_TRUE(all_close(vc.rosenblatt(u, ex), vc.rosenblatt(u), 1e-12));
+  EXPECT_TRUE(
+    all_close(vc.inverse_rosenblatt(u, ex), vc.inverse_rosenblatt(u), 1e-12));
+}
+
+TEST(VinecopThreading, edge_parallel_pdf_matches_serial)
+{
+  // few rows and many variables: a single row batch, so the edges within each
+  // tree are evaluated concurrently
+  auto pcs = Vinecop::make_pair_copula_store(12);
+  for (auto& tree : pcs) {
+    for (auto& pc : tree) {
+      pc = Bicop(BicopFamily::clayton, 0, Eigen::MatrixXd::Constant(1, 1, 1.5));
+    }
+  }
+  Vinecop vc(RVineStructure::simulate(12, false, { 3 }), pcs);
+  auto u = vc.simulate(40, false, 1, { 4 });
+
+  tools_thread::ThreadPool pool(3);
+  tools_thread::Executor ex(pool, 4);
+  for (size_t rep = 0; rep < 3; ++rep) {
+    auto parallel = vc.pdf_full(u, ex);
+    auto serial = vc.pdf_full(u);
+    EXPECT_TRUE(all_close(parallel.pdf, serial.pdf, 1e-12));
+    for (size_t t = 0; t < 11; ++t) {
+      for (size_t e = 0; e < 11 - t; ++e) {
+        EXPECT_TRUE(
+          all_close(parallel.pdf_edges(t, e), serial.pdf_edges(t, e), 1e-12));
+      }
+    }
+  }
+
+  Eigen::MatrixXd pars = Eigen::MatrixXd::Constant(40, 66, 1.5);
+  pars.col(7).setLinSpaced(0.5, 3.0);
+  EXPECT_TRUE(all_close(vc.pdf(u, pars, ex), vc.pdf(u, pars), 1e-12));
+
+  // discrete variables also need the h-functions of the left limits
+  std::vector<std::string> var_types(12, "c");
+  var_types[0] = var_types[5] = "d";
+  vc.set_var_types(var_types);
+  Eigen::MatrixXd u_disc(40, 24);
+  u_disc << u, (u.array() - 0.05).max(1e-3).matrix();
+  EXPECT_TRUE(all_close(vc.pdf(u_disc, ex), vc.pdf(u_disc), 1e-12));
+}
+
+TEST(VinecopThreading, parallel_select_matches_serial)
+{
+  auto pcs = Vinecop::make_pair_copula_store(5, 2);
+  std::vector<BicopFamily> families = { BicopFamily::clayton,
+                                        BicopFamily::gumbel,
+                                        BicopFamily::frank,
+                                        BicopFamily::gaussian };
+  size_t k = 0;
+  for (auto& tree : pcs) {
+    for (auto& pc : tree) {
+      pc = Bicop(families[k++ % families.size()]);
+      pc.set_parameters(pc.tau_to_parameters(0.4));
+    }
+  }
+  Vinecop vc(DVineStructure({ 1, 2, 3, 4, 5 }), pcs);
+  auto u = vc.simulate(300, false, 1, { 7 });
+
+  FitControlsVinecop controls({ BicopFamily::indep,
+                                BicopFamily::clayton,
+                                BicopFamily::gumbel,
+                                BicopFamily::frank,
+                                BicopFamily::gaussian },
+                              "itau");
+  Vinecop serial(5), parallel(5);
+  serial.select(u, controls);
+  controls.set_num_threads(4);
+  parallel.select(u, controls);
+  EXPECT_EQ(serial.get_rvine_structure().str(),
+            parallel.get_rvine_structure().str());
+  EXPECT_EQ(serial.str(), parallel.str());
+  EXPECT_NEAR(serial.get_loglik(), parallel.get_loglik(), 1e-10);
+}
+
+TEST(VinecopCompiled, matches_uncompiled_evaluation)
+{
+  // all rotations, one- and two-parameter families, and independence edges,
+  // on a truncated R-vine
+  std::vector<Bicop> bicops = {
+    Bicop(BicopFamily::clayton, 90, Eigen::MatrixXd::Constant(1, 1, 2.0)),
+    Bicop(BicopFamily::gumbel, 180, Eigen::MatrixXd::Constant(1, 1, 1.5)),
+    Bicop(BicopFamily::frank, 0, Eigen::MatrixXd::Constant(1, 1, -3.0)),
+    Bicop(BicopFamily::student, 0, Eigen::Vector2d(0.3, 5.0)),
+    Bicop(BicopFamily::indep),
+    Bicop(BicopFamily::bb1, 270, Eigen::Vector2d(0.5, 1.5)),
+    Bicop(BicopFamily::joe, 0, Eigen::MatrixXd::Constant(1, 1, 1.8)),
+  };
+  auto structure = RVineStructure::simulate(7, false, { 2 });
+  structure.truncate(4);
+  auto pcs = Vinecop::make_pair_copula_store(7, 4);
+  size_t k = 0;
+  for (auto& tree : pcs) {
+    for (auto& pc : tree) {
+      pc = bicops[k++ % bicops.size()];
+    }
+  }
+  Vinecop vc(structure, pcs);
+  auto u = vc.simulate(300, false, 1, { 8 });
+  auto plan = vc.compile();
+  EXPECT_EQ(plan.get_dim(), 7u);
+
+  tools_thread::ThreadPool pool(2);
+  for (const auto& ex :
+       { tools_thread::Executor(1), tools_thread::Executor(pool) }) {
+    EXPECT_TRUE(all_close(plan.pdf(u, ex), vc.pdf(u), 1e-10));
+    EXPECT_NEAR(plan.loglik(u, ex), vc.loglik(u), 1e-8);
+    EXPECT_TRUE(all_close(plan.rosenblatt(u, ex), vc.rosenblatt(u), 1e-10));
+    EXPECT_TRUE(all_close(
+      plan.inverse_rosenblatt(u, ex), vc.inverse_rosenblatt(u), 1e-10));
+  }
+
+  // the plan is a snapshot of the model
+  auto pdf = plan.pdf(u);
+  vc.get_pair_copula(0, 0).set_parameters(Eigen::MatrixXd::Constant(1, 1, 5));
+  EXPECT_TRUE(all_close(plan.pdf(u), pdf, 1e-14));
+
+  EXPECT_THROW(plan.pdf(u.leftCols(6)), std::runtime_error);
+  vc.set_var_types({ "d", "c", "c", "c", "c", "c", "c" });
+  EXPECT_THROW(vc.compile(), std::runtime_error);
+}
+
+TEST(VinecopCompiled, handles_nonparametric_and_independence_models)
+{
+  auto u = Vinecop(DVineStructure({ 1, 2, 3, 4 }),
+                   Vinecop::make_pair_copula_store(4, 1))
+             .simulate(200, false, 1, { 3 });
+  u.col(1) = (u.col(0) + 0.3 * u.col(1)) / 1.3;
+  Vinecop vc(u, RVineStructure(), {}, FitControlsVinecop({ BicopFamily::tll }));
+  auto plan = vc.compile();
+  EXPECT_TRUE(all_close(plan.pdf(u), vc.pdf(u), 1e-10));
+  EXPECT_TRUE(
+    all_close(plan.inverse_rosenblatt(u), vc.inverse_rosenblatt(u), 1e-10));
+
+  Vinecop indep(4);
+  EXPECT_TRUE(all_close(indep.compile().pdf(u), indep.pdf(u), 1e-14));
+}
+
+TEST(VinecopCompiled, workspace_evaluation_does_not_allocate)
+{
+#ifndef VINECOPULIB_MALLOC_COUNT
+  GTEST_SKIP() << "allocations can only be counted with glibc malloc";
+#else
+  std::vector<Bicop> bicops = {
+    Bicop(BicopFamily::gaussian, 0, Eigen::MatrixXd::Constant(1, 1, 0.5)),
+    Bicop(BicopFamily::clayton, 90, Eigen::MatrixXd::Constant(1, 1, 2.0)),
+    Bicop(BicopFamily::gumbel, 180, Eigen::MatrixXd::Constant(1, 1, 1.5)),
+    Bicop(BicopFamily::frank, 0, Eigen::MatrixXd::Constant(1, 1, -3.0)),
+    Bicop(BicopFamily::joe, 270, Eigen::MatrixXd::Constant(1, 1, 1.8)),
+    Bicop(BicopFamily::indep),
+  };
+  auto pcs = Vinecop::make_pair_copula_store(6);
+  size_t k = 0;
+  for (auto& tree : pcs) {
+    for (auto& pc : tree) {
+      pc = bicops[k++ % bicops.size()];
+    }
+  }
+  Vinecop vc(RVineStructure::simulate(6, false, { 5 }), pcs);
+  auto u = vc.simulate(500, false, 1, { 9 });
+  auto plan = vc.compile();
+
+  VinecopWorkspace ws;
+  Eigen::VectorXd pdf(500), logpdf(500);
+  Eigen::MatrixXd U(500, 6);
+  // the first call sizes the workspace
+  plan.pdf(u, pdf, ws);
+  num_mallocs = 0;
+  count_mallocs = true;
+  for (size_t i = 0; i < 3; ++i) {
+    plan.pdf(u, pdf, ws);
+    plan.logpdf(u, logpdf, ws);
+    plan.rosenblatt(u, U, ws);
+  }
+  count_mallocs = false;
+  EXPECT_EQ(num_mallocs.load(), 0u);
+
+  EXPECT_TRUE(all_close(pdf, vc.pdf(u), 1e-10));
+  EXPECT_TRUE(all_close(logpdf, vc.logpdf(u), 1e-10));
+  EXPECT_TRUE(all_close(U, vc.rosenblatt(u), 1e-10));
+
+  // blocks of larger buffers are written in place
+  plan.pdf(u.topRows(100), pdf.tail(100), ws);
+  EXPECT_TRUE(all_close(pdf.tail(100), vc.pdf(u.topRows(100)), 1e-10));
+  EXPECT_THROW(plan.pdf(u, pdf.head(10), ws), std::runtime_error);
+  EXPECT_THROW(plan.rosenblatt(u, U.leftCols(5), ws), std::runtime_error);
+#endif
+}
+
+TEST(VinecopLogpdf, matches_log_of_pdf)
+{
+  std::vector<Bicop> bicops = {
+    Bicop(BicopFamily::gaussian, 0, Eigen::MatrixXd::Constant(1, 1, 0.6)),
+    Bicop(BicopFamily::clayton, 270, Eigen::MatrixXd::Constant(1, 1, 2.0)),
+    Bicop(BicopFamily::student, 0, Eigen::Vector2d(-0.4, 6.0)),
+    Bicop(BicopFamily::gumbel, 180, Eigen::MatrixXd::Constant(1, 1, 1.7)),
+    Bicop(BicopFamily::frank, 0, Eigen::MatrixXd::Constant(1, 1, 4.0)),
+    Bicop(BicopFamily::joe, 90, Eigen::MatrixXd::Constant(1, 1, 1.5)),
+    Bicop(BicopFamily::bb1, 0, Eigen::Vector2d(0.5, 1.5)),
+  };
+  auto pcs = Vinecop::make_pair_copula_store(6);
+  size_t k = 0;
+  for (auto& tree : pcs) {
+    for (auto& pc : tree) {
+      pc = bicops[k++ % bicops.size()];
+    }
+  }
+  Vinecop vc(RVineStructure::simulate(6, false, { 4 }), pcs);
+  auto u = vc.simulate(200, false, 1, { 6 });
+
+  Eigen::VectorXd ref = vc.pdf(u).array().log();
+  EXPECT_TRUE(all_close(vc.logpdf(u), ref, 1e-8, 1e-8));
+  EXPECT_TRUE(all_close(vc.logpdf(u, 3), ref, 1e-8, 1e-8));
+  EXPECT_NEAR(vc.loglik(u), ref.sum(), 1e-8 * std::abs(ref.sum()));
+  EXPECT_TRUE(all_close(vc.compile().logpdf(u), ref, 1e-8, 1e-8));
+
+  // per-observation parameters
+  std::vector<double> pars;
+  for (const auto& tree : pcs) {
+    for (const auto& pc : tree) {
+      auto p = pc.get_parameters();
+      pars.insert(pars.end(), p.data(), p.data() + p.size());
+    }
+  }
+  Eigen::RowVectorXd pars_row = Eigen::Map<Eigen::RowVectorXd>(
+    pars.data(), static_cast<Eigen::Index>(pars.size()));
+  Eigen::MatrixXd pars_obs = pars_row.replicate(200, 1);
+  EXPECT_TRUE(all_close(vc.logpdf(u, pars_obs), ref, 1e-8, 1e-8));
+
+  // discrete variables go through the difference quotients
+  vc.set_var_types({ "c", "d", "c", "c", "c", "c" });
+  Eigen::MatrixXd u_disc(200, 7);
+  u_disc.leftCols(6) = u;
+  u_disc.col(6) = (u.col(1).array() - 0.05).max(1e-3);
+  EXPECT_TRUE(
+    all_close(vc.logpdf(u_disc), vc.pdf(u_disc).array().log(), 1e-8, 1e-8));
+}
+
+TEST(VinecopLogpdf, does_not_overflow_in_high_dimensions)
+{
+  // strongly dependent first tree: the density is far beyond DBL_MAX
+  size_t d = 1000;
+  auto pcs = Vinecop::make_pair_copula_store(d, 1);
+  for (auto& pc : pcs[0]) {
+    pc = Bicop(BicopFamily::gaussian, 0, Eigen::MatrixXd::Constant(1, 1, 0.95));
+  }
+  Vinecop vc(DVineStructure(tools_stl::seq_int(1, d), 1), pcs);
+  auto u = vc.simulate(20, false, 1, { 7 });
+
+  auto full = vc.pdf_full(u);
+  Eigen::VectorXd ref = Eigen::VectorXd::Zero(20);
+  for (size_t e = 0; e < d - 1; ++e) {
+    ref += full.pdf_edges(0, e).array().log().matrix();
+  }
+  EXPECT_GT(ref.minCoeff(), std::log(DBL_MAX));
+  EXPECT_TRUE(all_close(vc.logpdf(u), ref, 1e-10));
+  EXPECT_NEAR(vc.loglik(u), ref.sum(), 1e-10 * ref.sum());
+  EXPECT_TRUE(all_close(vc.compile().logpdf(u), ref, 1e-10));
+}
+
 // Records where a custom tree criterion is evaluated from. The bookkeeping is
 // mutex-guarded so that a regression fails the assertions instead of racing on
 // the recorder itself.
@@ -2709,4 +3052,329 @@ TEST_F(VinecopTest, tll_selection_is_reproducible)
   }
 }
 
+// `cdf()` counts the simulated points below each evaluation point with an
+// index; the counts must be those of a scan over the same sample.
+TEST(VinecopCdf, matches_scan_of_the_simulated_sample)
+{
+  auto pcs = Vinecop::make_pair_copula_store(4);
+  for (auto& tree : pcs) {
+    for (auto& pc : tree) {
+      pc = Bicop(BicopFamily::clayton, 0, Eigen::MatrixXd::Constant(1, 1, 2.0));
+    }
+  }
+  const std::vector<Vinecop> vines = {
+    Vinecop(DVineStructure({ 1, 2 }),
+            { { Bicop(
+              BicopFamily::gumbel, 0, Eigen::MatrixXd::Constant(1, 1, 1.5)) } }),
+    Vinecop(RVineStructure::simulate(4, false, { 1 }), pcs)
+  };
+  for (const auto& vc : vines) {
+    auto u = vc.simulate(100, false, 1, { 2 });
+    auto u_sim = vc.simulate(2000, true, 1, { 3 });
+
+    Eigen::VectorXd expected(u.rows());
+    for (Eigen::Index i = 0; i < u.rows(); ++i) {
+      Eigen::RowVectorXd ui = u.row(i);
+      expected(i) = static_cast<double>(
+        ((u_sim.rowwise() - ui).rowwise().maxCoeff().array() <= 0.0).count());
+    }
+    expected /= 2000.0;
+    EXPECT_TRUE(all_close(vc.cdf(u, 2000, 1, { 3 }), expected, 0.0, 1e-15));
+    EXPECT_TRUE(all_close(vc.cdf(u, 2000, 3, { 3 }), expected, 0.0, 1e-15));
+  }
+}
+
+// The estimator answers queries from stored replicates: one replicate
+// reproduces `cdf()`, refining gives the replicates asked for up front, and
+// the standard errors are of the size of the actual errors.
+TEST(VinecopCdfEstimator, matches_cdf_and_refines)
+{
+  Vinecop vc(DVineStructure({ 1, 2 }),
+             { { Bicop(BicopFamily::gaussian,
+                       0,
+                       Eigen::MatrixXd::Constant(1, 1, 0.5)) } });
+  auto u = vc.simulate(100, false, 1, { 2 });
+
+  VinecopCdfEstimator single(vc, 2000, 1, 1, { 3 });
+  EXPECT_TRUE(all_close(single.cdf(u), vc.cdf(u, 2000, 1, { 3 }), 0.0, 1e-15));
+  EXPECT_TRUE(single.estimate(u).std_error.array().isNaN().all());
+
+  VinecopCdfEstimator refined(vc, 2000, 2, 1, { 3 });
+  refined.refine(6, 2);
+  VinecopCdfEstimator up_front(vc, 2000, 8, 1, { 3 });
+  EXPECT_EQ(refined.get_num_replicates(), 8u);
+  EXPECT_EQ(refined.get_num_points(), 2000u);
+  EXPECT_TRUE(all_close(refined.cdf(u), up_front.cdf(u), 0.0, 1e-15));
+  EXPECT_TRUE(all_close(refined.cdf(u, 3), up_front.cdf(u), 0.0, 1e-15));
+
+  auto est = refined.estimate(u);
+  EXPECT_TRUE(all_close(est.value, refined.cdf(u), 0.0, 1e-15));
+  EXPECT_TRUE((est.std_error.array() >= 0).all());
+  Eigen::VectorXd exact = vc.get_pair_copula(0, 0).cdf(u);
+  double mean_error = (est.value - exact).cwiseAbs().mean();
+  EXPECT_LT(mean_error, 3 * est.std_error.mean());
+
+  EXPECT_ANY_THROW(VinecopCdfEstimator(vc, 0));
+  EXPECT_ANY_THROW(refined.cdf(Eigen::MatrixXd::Constant(2, 3, 0.5)));
+}
+
+// Tabulated inverses in all pair copulas: the inverse Rosenblatt transform
+// of the vine and of its compiled form agrees with the exact inverses.
+TEST(VinecopHinvMethod, inverse_rosenblatt_matches_exact)
+{
+  auto pcs = Vinecop::make_pair_copula_store(4);
+  const std::vector<Bicop> bicops = {
+    Bicop(BicopFamily::bb1, 0, Eigen::Vector2d(0.5, 1.5)),
+    Bicop(BicopFamily::tawn, 90, Eigen::Vector3d(0.5, 0.8, 3.0)),
+    Bicop(BicopFamily::frank, 0, Eigen::MatrixXd::Constant(1, 1, 5.0))
+  };
+  size_t k = 0;
+  for (auto& tree : pcs) {
+    for (auto& pc : tree) {
+      pc = bicops[k++ % bicops.size()];
+    }
+  }
+  Vinecop vc(RVineStructure::simulate(4, false, { 1 }), pcs);
+  const Eigen::MatrixXd w = tools_stats::simulate_uniform(500, 4, false, { 1 });
+  const Eigen::MatrixXd u = vc.inverse_rosenblatt(w);
+
+  vc.set_hinv_method(HinvMethod::table_newton);
+  EXPECT_TRUE(all_close(vc.inverse_rosenblatt(w, 2), u, 0.0, 1e-8));
+  EXPECT_TRUE(all_close(vc.compile().inverse_rosenblatt(w), u, 0.0, 1e-8));
+
+  vc.set_hinv_method(HinvMethod::table);
+  EXPECT_TRUE(all_close(vc.inverse_rosenblatt(w), u, 0.0, 0.1));
+}
+
+// Stacking the blocks gives the one-shot sample, for pseudo- and quasi-random
+// numbers and block sizes that do not divide the sample size.
+TEST(VinecopSimulateBlocks, matches_simulate)
+{
+  auto pcs = Vinecop::make_pair_copula_store(4);
+  for (auto& tree : pcs) {
+    for (auto& pc : tree) {
+      pc = Bicop(BicopFamily::clayton, 0, Eigen::MatrixXd::Constant(1, 1, 2.0));
+    }
+  }
+  Vinecop vc(RVineStructure::simulate(4, false, { 1 }), pcs);
+  for (bool qrng : { false, true }) {
+    const Eigen::MatrixXd expected = vc.simulate(1000, qrng, 1, { 3 });
+    for (size_t block_size : { size_t(1000), size_t(64), size_t(333) }) {
+      Eigen::MatrixXd u = Eigen::MatrixXd::Zero(1000, 4);
+      size_t next = 0;
+      vc.simulate_blocks(
+        1000,
+        block_size,
+        [&](const Eigen::MatrixXd& block, size_t begin) {
+          EXPECT_EQ(begin, next);
+          EXPECT_LE(static_cast<size_t>(block.rows()), block_size);
+          u.middleRows(begin, block.rows()) = block;
+          next += block.rows();
+        },
+        qrng,
+        2,
+        { 3 });
+      EXPECT_EQ(next, 1000u);
+      EXPECT_TRUE(all_close(u, expected, 0.0, 1e-15));
+    }
+  }
+  EXPECT_ANY_THROW(vc.simulate_blocks(
+    10, 0, [](const Eigen::MatrixXd&, size_t) {}, false, 1, { 3 }));
+}
+
+TEST(VinecopSimulate, independent_of_num_threads)
+{
+  auto pcs = Vinecop::make_pair_copula_store(4);
+  for (auto& tree : pcs) {
+    for (auto& pc : tree) {
+      pc = Bicop(BicopFamily::clayton, 0, Eigen::MatrixXd::Constant(1, 1, 2.0));
+    }
+  }
+  Vinecop vc(RVineStructure::simulate(4, false, { 1 }), pcs);
+  for (bool qrng : { false, true }) {
+    const Eigen::MatrixXd expected = vc.inverse_rosenblatt(
+      tools_stats::simulate_uniform(1001, 4, qrng, { 3 }));
+    for (size_t num_threads : { 1, 2, 3, 8 }) {
+      Eigen::MatrixXd u = vc.simulate(1001, qrng, num_threads, { 3 });
+      EXPECT_TRUE(all_close(u, expected, 0.0, 0.0));
+    }
+  }
+  EXPECT_EQ(vc.simulate(2, false, 8, { 3 }).rows(), 2);
+}
+
+
+// Models sharing their first trees are evaluated once per shared tree, and
+// each model's column is its own density, for any number of threads.
+TEST(VinecopEnsemble, matches_pdf_and_shares_trees)
+{
+  auto pcs = Vinecop::make_pair_copula_store(4);
+  for (auto& tree : pcs) {
+    for (auto& pc : tree) {
+      pc = Bicop(BicopFamily::clayton, 0, Eigen::MatrixXd::Constant(1, 1, 2.0));
+    }
+  }
+  auto structure = RVineStructure::simulate(4, false, { 1 });
+  Vinecop vc(structure, pcs);
+  auto pcs_last = pcs;
+  pcs_last[2][0] =
+    Bicop(BicopFamily::gumbel, 0, Eigen::MatrixXd::Constant(1, 1, 1.5));
+  Vinecop truncated = vc;
+  truncated.truncate(1);
+  std::vector<Vinecop> models = { vc,
+                                  Vinecop(structure, pcs_last),
+                                  truncated,
+                                  make_clayton_dvine(4, 3.0),
+                                  vc };
+  VinecopEnsemble ensemble(models);
+  EXPECT_EQ(ensemble.size(), 5u);
+  EXPECT_EQ(ensemble.get_dim(), 4u);
+  // trees 1-3 of `vc` (with a branch in tree 3) and trees 1-3 of the D-vine
+  EXPECT_EQ(ensemble.get_num_tree_evaluations(), 7u);
+
+  auto u = vc.simulate(1001, false, 1, { 2 });
+  for (size_t num_threads : { 1, 3 }) {
+    auto pdf = ensemble.pdf(u, num_threads);
+    auto logpdf = ensemble.logpdf(u, num_threads);
+    auto loglik = ensemble.loglik(u, num_threads);
+    for (size_t m = 0; m < models.size(); ++m) {
+      EXPECT_TRUE(all_close(pdf.col(m), models[m].pdf(u), 1e-12, 0.0));
+      EXPECT_TRUE(all_close(logpdf.col(m), models[m].logpdf(u), 0.0, 1e-12));
+      EXPECT_NEAR(loglik(m), models[m].loglik(u), 1e-9);
+    }
+  }
+
+  // discrete variables
+  std::vector<Vinecop> discrete = { vc, truncated };
+  for (auto& model : discrete) {
+    model.set_var_types({ "c", "d", "c", "c" });
+  }
+  Eigen::MatrixXd u_disc(u.rows(), 5);
+  u_disc << u, 0.9 * u.col(1);
+  auto pdf_disc = VinecopEnsemble(discrete).pdf(u_disc, 2);
+  for (size_t m = 0; m < discrete.size(); ++m) {
+    EXPECT_TRUE(all_close(pdf_disc.col(m), discrete[m].pdf(u_disc), 1e-12, 0));
+  }
+
+  EXPECT_ANY_THROW(VinecopEnsemble(std::vector<Vinecop>{}));
+  EXPECT_ANY_THROW(VinecopEnsemble({ vc, make_clayton_dvine(3) }));
+  EXPECT_ANY_THROW(ensemble.pdf(Eigen::MatrixXd::Constant(2, 3, 0.5)));
+}
+
+
+// Stacking the blocks gives the per-edge quantities of `pdf_full()`.
+TEST(VinecopPdfFullBlocks, matches_pdf_full)
+{
+  auto vc = make_clayton_dvine(4, 2.0);
+  vc.set_var_types({ "c", "d", "c", "c" });
+  auto u = tools_stats::simulate_uniform(1000, 5, false, { 4 });
+  u.col(4) = 0.9 * u.col(1);
+  const auto expected = vc.pdf_full(u);
+  const auto structure = vc.get_rvine_structure();
+  for (size_t block_size : { size_t(1000), size_t(64), size_t(333) }) {
+    size_t next = 0;
+    vc.pdf_full_blocks(
+      u,
+      block_size,
+      [&](const Vinecop::PdfWithHfuncsResult& block, size_t begin) {
+        EXPECT_EQ(begin, next);
+        const auto size = static_cast<size_t>(block.pdf.size());
+        EXPECT_LE(size, block_size);
+        EXPECT_TRUE(all_close(
+          block.pdf, expected.pdf.segment(begin, size), 1e-15, 0.0));
+        for (size_t tree = 0; tree < 3; ++tree) {
+          for (size_t edge = 0; edge < 3 - tree; ++edge) {
+            EXPECT_TRUE(
+              all_close(block.pdf_edges(tree, edge),
+                        expected.pdf_edges(tree, edge).segment(begin, size),
+                        1e-15,
+                        0.0));
+            if (structure.needed_hfunc1(tree, edge)) {
+              EXPECT_TRUE(
+                all_close(block.hfunc1_sub(tree, edge),
+                          expected.hfunc1_sub(tree, edge).segment(begin, size),
+                          1e-15,
+                          0.0));
+            }
+          }
+        }
+        next += size;
+      },
+      2);
+    EXPECT_EQ(next, 1000u);
+  }
+  EXPECT_ANY_THROW(vc.pdf_full_blocks(
+    u, 0, [](const Vinecop::PdfWithHfuncsResult&, size_t) {}));
+  EXPECT_ANY_THROW(
+    vc.pdf_full_blocks(Eigen::MatrixXd::Constant(2, 3, 0.5),
+                       10,
+                       [](const Vinecop::PdfWithHfuncsResult&, size_t) {}));
+}
+
+
+// The criteria of the first tree, computed for all pairs at once, are those
+// of the pairs, also with missing values and weights.
+TEST(VinecopSelect, criterion_matrix_matches_pairs)
+{
+  auto vc = make_clayton_dvine(5, 2.0);
+  Eigen::MatrixXd u = vc.simulate(300, false, 1, { 4 });
+  u(3, 2) = std::numeric_limits<double>::quiet_NaN();
+  Eigen::VectorXd weights =
+    tools_stats::simulate_uniform(300, 1, false, { 5 }).col(0);
+  Eigen::VectorXd zero_weights = weights;
+  zero_weights(7) = 0.0;
+
+  for (const std::string criterion : { "tau", "rho", "joe", "hoeffd" }) {
+    for (const auto& w : { Eigen::VectorXd(), weights, zero_weights }) {
+      auto crit =
+        tools_select::calculate_criterion_matrix(u, criterion, w, {}, 2);
+      for (Eigen::Index i = 0; i < u.cols(); ++i) {
+        EXPECT_EQ(crit(i, i), 0.0);
+        for (Eigen::Index j = 0; j < i; ++j) {
+          Eigen::MatrixXd pair(u.rows(), 2);
+          pair << u.col(i), u.col(j);
+          double expected =
+            tools_select::calculate_criterion(pair, criterion, w);
+          EXPECT_NEAR(crit(i, j), expected, 1e-12);
+          EXPECT_EQ(crit(j, i), crit(i, j));
+        }
+      }
+    }
+  }
+
+  // selection through the batched first tree; a custom criterion is
+  // evaluated pair by pair
+  FitControlsVinecop controls(bicop_families::itau, "itau");
+  controls.set_tree_criterion("rho");
+  Eigen::MatrixXd data = vc.simulate(300, false, 1, { 6 });
+  Vinecop fit(data, RVineStructure(), {}, controls);
+  controls.set_tree_criterion("custom");
+  controls.set_tree_criterion_function(
+    [](const Eigen::MatrixXd& x, const Eigen::VectorXd& w) {
+      return wdm::wdm(x, "rho", w)(0, 1);
+    });
+  Vinecop fit_pairs(data, RVineStructure(), {}, controls);
+  EXPECT_EQ(fit.get_rvine_structure(), fit_pairs.get_rvine_structure());
+}
+
+TEST(VinecopSelect, screening_matches_exact_selection)
+{
+  FitControlsVinecop controls(bicop_families::itau, "itau");
+  EXPECT_ANY_THROW(controls.set_screening_size(50));
+
+  // Hoeffding's D is not batched, so all trees are screened
+  auto vc = make_clayton_dvine(7, 2.0);
+  Eigen::MatrixXd data = vc.simulate(4000, false, 1, { 8 });
+  controls.set_tree_criterion("hoeffd");
+  Vinecop fit(data, RVineStructure(), {}, controls);
+  controls.set_screening_size(500);
+  Vinecop fit_screened(data, RVineStructure(), {}, controls);
+  EXPECT_EQ(fit.get_rvine_structure(), fit_screened.get_rvine_structure());
+  EXPECT_NEAR(fit.get_loglik(), fit_screened.get_loglik(), 1e-10);
+
+  // more observations in the subsample than in the data: no screening
+  controls.set_screening_size(5000);
+  Vinecop fit_unscreened(data, RVineStructure(), {}, controls);
+  EXPECT_EQ(fit.get_rvine_structure(), fit_unscreened.get_rvine_structure());
+}
+
 }